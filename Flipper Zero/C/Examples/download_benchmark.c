@@ -0,0 +1,105 @@
+#include <flipper_http/flipper_http.h>
+#define TAG "Example"
+
+// Download a file of known size to the SD card and log how fast it came in, whether any
+// bytes were lost and how the time splits between SD card writes and the UART. Serve the
+// file from a computer on the same network, for example with "python3 -m http.server"
+// next to a file made with "head -c 1048576 /dev/urandom > 1MB.bin".
+// To test a rate above 115200, set BAUDRATE in flipper_http.h and BAUD_RATE in the
+// firmware's FlipperHTTP.h to the same value and rebuild both.
+#define BENCH_URL "http://192.168.1.2:8000/1MB.bin" // change to your computer's address
+#define BENCH_SIZE (1024 * 1024)                     // size of the file at BENCH_URL
+#define BENCH_FILE APP_DATA_PATH("benchmark.bin")
+
+static volatile bool bench_done = false;
+static volatile bool bench_success = false;
+static volatile uint32_t bench_peak_bps = 0; // highest rate between two progress reports
+
+static void bench_progress(uint32_t request_id, const FlipperHTTPProgress *progress, void *context)
+{
+    UNUSED(request_id);
+    UNUSED(context);
+    if (progress->rate_bps > bench_peak_bps)
+    {
+        bench_peak_bps = progress->rate_bps;
+    }
+}
+
+static void bench_complete(uint32_t request_id, bool success, int status_code, void *context)
+{
+    UNUSED(request_id);
+    UNUSED(status_code);
+    UNUSED(context);
+    bench_success = success;
+    bench_done = true;
+}
+
+int32_t main(void *p)
+{
+    // Suppress unused parameter warning
+    UNUSED(p);
+
+    // Initialize the FlipperHTTP application
+    FlipperHTTP *fhttp = flipper_http_alloc();
+    if (!fhttp)
+    {
+        FURI_LOG_E(TAG, "Failed to allocate memory for FlipperHTTP");
+        return -1;
+    }
+
+    // Try to wait for pong response.
+    if (!flipper_http_send_command(fhttp, HTTP_CMD_PING))
+    {
+        FURI_LOG_E(TAG, "Failed to ping the device");
+        flipper_http_free(fhttp);
+        return -1;
+    }
+    uint8_t counter = 10;
+    while (fhttp->state == INACTIVE && --counter > 0)
+    {
+        FURI_LOG_D(TAG, "Waiting for PONG");
+        furi_delay_ms(100);
+    }
+    if (counter == 0)
+    {
+        FURI_LOG_E(TAG, "Failed to receive PONG response");
+        flipper_http_free(fhttp);
+        return -1;
+    }
+
+    // Download the file
+    FlipperHTTPRequest request = {0};
+    request.method = BYTES;
+    request.url = BENCH_URL;
+    request.file_path = BENCH_FILE;
+    request.on_progress = bench_progress;
+    request.on_complete = bench_complete;
+    if (!flipper_http_submit(fhttp, &request))
+    {
+        FURI_LOG_E(TAG, "Failed to submit the download");
+        flipper_http_free(fhttp);
+        return -1;
+    }
+    while (!bench_done)
+    {
+        furi_delay_ms(100);
+    }
+
+    // Lossless means every byte arrived and the RX stream buffer never overflowed
+    const FlipperHTTPTransferStats *stats = &fhttp->transfer_stats;
+    bool lossless = bench_success && stats->bytes == BENCH_SIZE && stats->rx_dropped == 0;
+    FURI_LOG_I(TAG, "Baudrate %d: %u of %u bytes in %lu ms, %lu bytes/s (line limit %d), %lu dropped: %s",
+               BAUDRATE, (unsigned)stats->bytes, (unsigned)BENCH_SIZE, stats->duration_ms, stats->average_bps,
+               BAUDRATE / 10, stats->rx_dropped, lossless ? "lossless" : "LOST DATA");
+
+    // Where the time went: SD card writes against waiting for and handling UART data
+    uint64_t total_us = (uint64_t)stats->sd_write_us + stats->uart_us;
+    FURI_LOG_I(TAG, "SD writes %lu us (%lu%%) in %lu writes, UART %lu us (%lu%%), peak rate %lu bytes/s",
+               stats->sd_write_us, total_us ? (uint32_t)(stats->sd_write_us * 100ULL / total_us) : 0, stats->sd_writes,
+               stats->uart_us, total_us ? (uint32_t)(stats->uart_us * 100ULL / total_us) : 0, bench_peak_bps);
+
+    // Deinitialize UART
+    flipper_http_free(fhttp);
+
+    return 0;
+}
@@ -38,16 +38,15 @@ int32_t main(void *p)
         return -1;
     }
 
-    furi_timer_start(fhttp->get_timeout_timer, TIMEOUT_DURATION_TICKS);
-
+    // flipper_http_request started the request's timeouts before sending it
     fhttp->state = RECEIVING;
 
-    while (fhttp->state == RECEIVING && furi_timer_is_running(fhttp->get_timeout_timer) > 0)
+    while (fhttp->state == RECEIVING && flipper_http_timeout_running(fhttp))
     {
         // Wait for the request to be received
         furi_delay_ms(100);
     }
-    furi_timer_stop(fhttp->get_timeout_timer);
+    flipper_http_timeout_stop(fhttp);
 
     // Print the response (you can parse the JSON here)
     FURI_LOG_I(TAG, "Received response: %s", fhttp->last_response);
@@ -0,0 +1,58 @@
+#include <flipper_http/flipper_http.h>
+#define TAG "Example"
+
+// Write the same data to the SD card the way downloads used to be saved (open, write
+// 512 bytes, close for every chunk) and through a file sink (open once, 4 KB writes),
+// then log the throughput of both. Needs only the Flipper and its SD card.
+#define BENCH_SIZE (256 * 1024) // bytes written by each method
+#define BENCH_CHUNK 512         // bytes handed over at a time, as the UART worker does
+#define BENCH_FILE APP_DATA_PATH("sd_benchmark.bin")
+
+static uint32_t bench_rate(size_t bytes, uint32_t ticks)
+{
+    return ticks > 0 ? (uint32_t)((uint64_t)bytes * furi_kernel_get_tick_frequency() / ticks) : 0;
+}
+
+int32_t main(void *p)
+{
+    // Suppress unused parameter warning
+    UNUSED(p);
+
+    char file_path[] = BENCH_FILE;
+    uint8_t chunk[BENCH_CHUNK];
+    for (size_t i = 0; i < sizeof(chunk); i++)
+    {
+        chunk[i] = (uint8_t)i;
+    }
+
+    // Reopen the file for every chunk
+    uint32_t start = furi_get_tick();
+    bool reopen_ok = true;
+    for (size_t written = 0; written < BENCH_SIZE && reopen_ok; written += sizeof(chunk))
+    {
+        reopen_ok = flipper_http_append_to_file(chunk, sizeof(chunk), written == 0, file_path);
+    }
+    uint32_t reopen_ticks = furi_get_tick() - start;
+
+    // Keep the file open
+    FlipperHTTPFileSink sink = {0};
+    start = furi_get_tick();
+    bool sink_ok = flipper_http_file_sink_open(&sink, file_path, true);
+    for (size_t written = 0; written < BENCH_SIZE && sink_ok; written += sizeof(chunk))
+    {
+        sink_ok = flipper_http_file_sink_write(&sink, chunk, sizeof(chunk));
+    }
+    sink_ok = flipper_http_file_sink_close(&sink) && sink_ok;
+    uint32_t sink_ticks = furi_get_tick() - start;
+
+    if (!reopen_ok || !sink_ok)
+    {
+        FURI_LOG_E(TAG, "SD write failed (reopen: %s, sink: %s)", reopen_ok ? "ok" : "failed", sink_ok ? "ok" : "failed");
+        return -1;
+    }
+    FURI_LOG_I(TAG, "%u bytes in %u-byte chunks: reopen per chunk %lu ms (%lu bytes/s), file sink %lu ms (%lu bytes/s, %lu SD writes)",
+               (unsigned)BENCH_SIZE, (unsigned)BENCH_CHUNK, reopen_ticks, bench_rate(BENCH_SIZE, reopen_ticks),
+               sink_ticks, bench_rate(BENCH_SIZE, sink_ticks), sink.writes);
+
+    return 0;
+}
@@ -4,6 +4,121 @@
 // File: flipper_http.c
 #include <flipper_http/flipper_http.h>
 
+static void flipper_http_finish_file(FlipperHTTP *fhttp);                                 // forward declaration
+static void flipper_http_end_response(FlipperHTTP *fhttp);                                // forward declaration
+static void flipper_http_save_body(const uint8_t *data, size_t len, void *context);       // forward declaration
+static void flipper_http_queue_complete(FlipperHTTP *fhttp, bool success);                // forward declaration
+static void flipper_http_queue_body(FlipperHTTP *fhttp, const uint8_t *data, size_t len); // forward declaration
+static void flipper_http_queue_release(FlipperHTTPQueuedRequest *queued);                 // forward declaration
+static void flipper_http_report_progress(FlipperHTTP *fhttp, bool final);                 // forward declaration
+static uint32_t flipper_http_timeout_remaining(FlipperHTTP *fhttp, const char **reason);  // forward declaration
+
+// Markers that frame the response to each method, indexed by HTTPMethod
+typedef struct
+{
+    const char *name;      // Method name for logs
+    const char *success;   // Line that starts the response
+    const char *end_line;  // Line that ends a text response
+    const char *end_bytes; // Marker that ends a bytes response, with the line break the board prints before it
+} FlipperHTTPResponseMarkers;
+
+static const FlipperHTTPResponseMarkers response_markers[] = {
+    [GET] = {"GET", "[GET/SUCCESS]", "[GET/END]", "\r\n[GET/END]"},
+    [POST] = {"POST", "[POST/SUCCESS]", "[POST/END]", "\r\n[POST/END]"},
+    [PUT] = {"PUT", "[PUT/SUCCESS]", "[PUT/END]", "\r\n[PUT/END]"},
+    [DELETE] = {"DELETE", "[DELETE/SUCCESS]", "[DELETE/END]", "\r\n[DELETE/END]"},
+};
+
+// Receives the bytes handed out by a marker matcher
+typedef void (*MarkerOutput)(const uint8_t *data, size_t len, void *context);
+
+// Function to prepare a marker matcher
+static void marker_matcher_init(FlipperHTTPMarkerMatcher *matcher, const char *marker)
+{
+    matcher->marker = marker;
+    matcher->len = MIN(strlen(marker), (size_t)MARKER_MAX_LEN);
+    matcher->matched = 0;
+    matcher->held = 0;
+
+    // KMP failure table: where a partial match continues after a mismatch
+    matcher->fail[0] = 0;
+    size_t k = 0;
+    for (size_t i = 1; i < matcher->len; i++)
+    {
+        while (k > 0 && marker[i] != marker[k])
+        {
+            k = matcher->fail[k - 1];
+        }
+        if (marker[i] == marker[k])
+        {
+            k++;
+        }
+        matcher->fail[i] = k;
+    }
+}
+
+// Function to find the marker in the next block of bytes. The bytes before it are handed to output
+// without copying: as slices of data, or of the marker itself for bytes held back from earlier blocks
+// that turned out not to be the marker. Returns the number of bytes of data used, which is less than
+// len only when the marker was found (found is set and the rest of data comes after the marker).
+static size_t marker_matcher_feed(FlipperHTTPMarkerMatcher *matcher, const uint8_t *data, size_t len, bool *found, MarkerOutput output, void *context)
+{
+    const uint8_t *marker = (const uint8_t *)matcher->marker;
+    *found = false;
+    for (size_t i = 0; i < len; i++)
+    {
+        while (matcher->matched > 0 && marker[matcher->matched] != data[i])
+        {
+            size_t shorter = matcher->fail[matcher->matched - 1];
+            if (matcher->held > 0)
+            {
+                // Held bytes are the oldest of the partial match, so they are the start of the marker
+                size_t released = MIN(matcher->matched - shorter, matcher->held);
+                output(marker, released, context);
+                matcher->held -= released;
+            }
+            matcher->matched = shorter;
+        }
+        if (marker[matcher->matched] == data[i])
+        {
+            matcher->matched++;
+        }
+        if (matcher->matched == matcher->len)
+        {
+            // Everything in this block before the marker is body
+            size_t body_len = i + 1 - (matcher->len - matcher->held);
+            if (body_len > 0)
+            {
+                output(data, body_len, context);
+            }
+            matcher->matched = 0;
+            matcher->held = 0;
+            *found = true;
+            return i + 1;
+        }
+    }
+
+    // Hand out all but a partial match at the end, which is held until the next block decides it
+    size_t body_len = len - (matcher->matched - matcher->held);
+    if (body_len > 0)
+    {
+        output(data, body_len, context);
+    }
+    matcher->held = matcher->matched;
+    return len;
+}
+
+// Function to hand out the bytes a matcher is holding back, once no more bytes will come
+static void marker_matcher_flush(FlipperHTTPMarkerMatcher *matcher, MarkerOutput output, void *context)
+{
+    if (matcher->held > 0)
+    {
+        output((const uint8_t *)matcher->marker, matcher->held, context);
+    }
+    matcher->matched = 0;
+    matcher->held = 0;
+}
+
 /**
  * @brief      Worker thread to handle UART data asynchronously.
  * @return     0
@@ -28,73 +143,86 @@ static int32_t flipper_http_worker(void *context)
     while (1)
     {
         uint32_t events = furi_thread_flags_wait(
-            WorkerEvtStop | WorkerEvtRxDone, FuriFlagWaitAny, FuriWaitForever);
+            WorkerEvtStop | WorkerEvtRxDone | WorkerEvtTimeout, FuriFlagWaitAny, FuriWaitForever);
         if (events & WorkerEvtStop)
         {
             break;
         }
         if (events & WorkerEvtRxDone)
         {
-            // Continuously read from the stream buffer until it's empty
-            while (!furi_stream_buffer_is_empty(fhttp->flipper_http_stream))
+            // Any byte counts as activity, so streams without newlines keep the idle timeout from running out
+            fhttp->last_rx_tick = furi_get_tick();
+            fhttp->first_byte_received = true;
+
+            // Drain the stream buffer a block at a time
+            uint8_t chunk[RX_CHUNK_SIZE];
+            size_t received;
+            while ((received = furi_stream_buffer_receive(fhttp->flipper_http_stream, chunk, sizeof(chunk), 0)) > 0)
             {
-                // Read one byte at a time
-                char c = 0;
-                size_t received = furi_stream_buffer_receive(fhttp->flipper_http_stream, &c, 1, 0);
-
-                if (received == 0)
-                {
-                    // No more data to read
-                    break;
-                }
-
-                fhttp->bytes_received += received;
-
-                // print amount of bytes received
-                // FURI_LOG_I(HTTP_TAG, "Bytes received: %d", fhttp->bytes_received);
-
-                // Append the received byte to the file if saving is enabled
-                if (fhttp->save_bytes)
+                size_t i = 0;
+                while (i < received)
                 {
-                    // Add byte to the buffer
-                    fhttp->file_buffer[fhttp->file_buffer_len++] = c;
-                    // Write to file if buffer is full
-                    if (fhttp->file_buffer_len >= FILE_BUFFER_SIZE)
+                    if (fhttp->save_bytes)
                     {
-                        if (!flipper_http_append_to_file(
-                                fhttp->file_buffer,
-                                fhttp->file_buffer_len,
-                                fhttp->just_started_bytes,
-                                fhttp->file_path))
+                        // Body bytes go to the file straight from the block, up to the END marker
+                        bool found;
+                        i += marker_matcher_feed(&fhttp->end_marker, &chunk[i], received - i, &found, flipper_http_save_body, fhttp);
+                        if (found)
                         {
-                            FURI_LOG_E(HTTP_TAG, "Failed to append data to file");
+                            flipper_http_end_response(fhttp);
                         }
-                        fhttp->file_buffer_len = 0;
-                        fhttp->just_started_bytes = false;
+                        continue;
                     }
-                }
 
-                // Handle line buffering only if callback is set (text data)
-                if (fhttp->handle_rx_line_cb)
-                {
-                    // Handle line buffering
-                    if (c == '\n' || rx_line_pos >= RX_LINE_BUFFER_SIZE - 1)
+                    // Text is handled byte by byte, since a SUCCESS line can switch to saving bytes mid-block
+                    char c = (char)chunk[i++];
+                    fhttp->bytes_received++;
+
+                    // Handle line buffering only if callback is set (text data)
+                    if (fhttp->handle_rx_line_cb)
                     {
-                        fhttp->rx_line_buffer[rx_line_pos] = '\0'; // Null-terminate the line
+                        // Handle line buffering
+                        if (c == '\n' || rx_line_pos >= RX_LINE_BUFFER_SIZE - 1)
+                        {
+                            fhttp->rx_line_buffer[rx_line_pos] = '\0'; // Null-terminate the line
 
-                        // Invoke the callback with the complete line
-                        fhttp->handle_rx_line_cb(fhttp->rx_line_buffer, fhttp->callback_context);
+                            // Invoke the callback with the complete line
+                            fhttp->handle_rx_line_cb(fhttp->rx_line_buffer, fhttp->callback_context);
 
-                        // Reset the line buffer position
-                        rx_line_pos = 0;
-                    }
-                    else
-                    {
-                        fhttp->rx_line_buffer[rx_line_pos++] = c; // Add character to the line buffer
+                            // Reset the line buffer position
+                            rx_line_pos = 0;
+                        }
+                        else
+                        {
+                            fhttp->rx_line_buffer[rx_line_pos++] = c; // Add character to the line buffer
+                        }
                     }
                 }
             }
         }
+        if (events & WorkerEvtTimeout)
+        {
+            // The timer is not restarted for every byte, so check what really ran out
+            const char *reason = "Timeout reached";
+            uint32_t remaining = fhttp->timeout_armed ? flipper_http_timeout_remaining(fhttp, &reason) : 0;
+            if (remaining > 0)
+            {
+                furi_timer_start(fhttp->get_timeout_timer, remaining);
+            }
+            else if (fhttp->timeout_armed || fhttp->state == RECEIVING) // not if the response ended in the same wake-up
+            {
+                FURI_LOG_E(HTTP_TAG, "%s without receiving the end.", reason);
+                fhttp->timeout_armed = false;
+                fhttp->started_receiving = false;
+                fhttp->state = ISSUE;
+
+                // The END marker never came, keep what was received
+                fhttp->save_bytes = false;
+                fhttp->is_bytes_request = false;
+                flipper_http_finish_file(fhttp);
+                flipper_http_queue_complete(fhttp, false);
+            }
+        }
     }
 
     return 0;
@@ -106,12 +234,15 @@ static int32_t flipper_http_worker(void *context)
  * @return     void
  * @param      handle    The UART handle.
  * @param      event     The event type.
+ * @param      data_len  The number of bytes waiting in the DMA buffer.
  * @param      context   The FlipperHTTP context.
- * @note       This function will handle received data asynchronously via the callback.
+ * @note       DMA calls this when its buffer is half or completely full and when the line goes idle,
+ *             so the worker is woken once per block instead of once per byte.
  */
 static void _flipper_http_rx_callback(
     FuriHalSerialHandle *handle,
     FuriHalSerialRxEvent event,
+    size_t data_len,
     void *context)
 {
     FlipperHTTP *fhttp = (FlipperHTTP *)context;
@@ -120,20 +251,31 @@ static void _flipper_http_rx_callback(
         FURI_LOG_E(HTTP_TAG, "Failed to get context.");
         return;
     }
-    if (event == FuriHalSerialRxEventData)
+    if (event & (FuriHalSerialRxEventData | FuriHalSerialRxEventIdle))
     {
-        uint8_t data = furi_hal_serial_async_rx(handle);
-        furi_stream_buffer_send(fhttp->flipper_http_stream, &data, 1, 0);
+        uint8_t data[RX_CHUNK_SIZE];
+        while (data_len > 0)
+        {
+            size_t len = furi_hal_serial_dma_rx(handle, data, MIN(data_len, sizeof(data)));
+            if (len == 0)
+            {
+                break;
+            }
+            size_t sent = furi_stream_buffer_send(fhttp->flipper_http_stream, data, len, 0);
+            fhttp->rx_dropped += len - sent; // the worker fell behind, these bytes are lost
+            data_len -= len;
+        }
         furi_thread_flags_set(fhttp->rx_thread_id, WorkerEvtRxDone);
     }
 }
 
 // Timer callback function
 /**
- * @brief      Callback function for the GET timeout timer.
+ * @brief      Callback function for the request timeout timer.
  * @return     0
  * @param      context   The FlipperHTTP context.
- * @note       This function will be called when the GET request times out.
+ * @note       The worker checks which timeout ran out, if any, and starts the timer again for the rest of the window
+ *             when bytes came in since it was started.
  */
 static void get_timeout_timer_callback(void *context)
 {
@@ -143,13 +285,9 @@ static void get_timeout_timer_callback(void *context)
         FURI_LOG_E(HTTP_TAG, "Failed to get context.");
         return;
     }
-    FURI_LOG_E(HTTP_TAG, "Timeout reached without receiving the end.");
 
-    // Reset the state
-    fhttp->started_receiving = false;
-
-    // Update UART state
-    fhttp->state = ISSUE;
+    // The worker owns the file and the receive state, let it handle the timeout
+    furi_thread_flags_set(fhttp->rx_thread_id, WorkerEvtTimeout);
 }
 
 static void flipper_http_rx_callback(const char *line, void *context); // forward declaration
@@ -188,7 +326,7 @@ FlipperHTTP *flipper_http_alloc()
     }
 
     furi_thread_set_name(fhttp->rx_thread, "FlipperHTTP_RxThread");
-    furi_thread_set_stack_size(fhttp->rx_thread, 1024);
+    furi_thread_set_stack_size(fhttp->rx_thread, WORKER_STACK_SIZE);
     furi_thread_set_context(fhttp->rx_thread, fhttp); // Corrected context
     furi_thread_set_callback(fhttp->rx_thread, flipper_http_worker);
 
@@ -230,8 +368,8 @@ FlipperHTTP *flipper_http_alloc()
     // Enable RX direction
     furi_hal_serial_enable_direction(fhttp->serial_handle, FuriHalSerialDirectionRx);
 
-    // Start asynchronous RX with the corrected callback and context
-    furi_hal_serial_async_rx_start(fhttp->serial_handle, _flipper_http_rx_callback, fhttp, false); // Corrected context
+    // Start DMA RX, the callback gets whole blocks of received bytes
+    furi_hal_serial_dma_rx_start(fhttp->serial_handle, _flipper_http_rx_callback, fhttp, false);
 
     // Wait for the TX to complete to ensure UART is ready
     furi_hal_serial_tx_wait_complete(fhttp->serial_handle);
@@ -247,7 +385,7 @@ FlipperHTTP *flipper_http_alloc()
     {
         FURI_LOG_E(HTTP_TAG, "Failed to allocate HTTP request timeout timer.");
         // Cleanup resources
-        furi_hal_serial_async_rx_stop(fhttp->serial_handle);
+        furi_hal_serial_dma_rx_stop(fhttp->serial_handle);
         furi_hal_serial_disable_direction(fhttp->serial_handle, FuriHalSerialDirectionRx);
         furi_hal_serial_control_release(fhttp->serial_handle);
         furi_hal_serial_deinit(fhttp->serial_handle);
@@ -261,14 +399,18 @@ FlipperHTTP *flipper_http_alloc()
 
     // Set the timer thread priority if needed
     furi_timer_set_thread_priority(FuriTimerThreadPriorityElevated);
+    fhttp->timeouts.first_byte_ms = TIMEOUT_DURATION_TICKS;
+    fhttp->timeouts.idle_ms = TIMEOUT_DURATION_TICKS;
+    fhttp->active_timeouts = fhttp->timeouts;
 
     fhttp->last_response = (char *)malloc(RX_BUF_SIZE);
     if (!fhttp->last_response)
     {
         FURI_LOG_E(HTTP_TAG, "Failed to allocate memory for last_response.");
-        // Cleanup resources
+        // Cleanup resources, the timer first so it cannot wake the worker again
+        furi_timer_stop(fhttp->get_timeout_timer);
         furi_timer_free(fhttp->get_timeout_timer);
-        furi_hal_serial_async_rx_stop(fhttp->serial_handle);
+        furi_hal_serial_dma_rx_stop(fhttp->serial_handle);
         furi_hal_serial_disable_direction(fhttp->serial_handle, FuriHalSerialDirectionRx);
         furi_hal_serial_control_release(fhttp->serial_handle);
         furi_hal_serial_deinit(fhttp->serial_handle);
@@ -281,6 +423,9 @@ FlipperHTTP *flipper_http_alloc()
     }
     memset(fhttp->last_response, 0, RX_BUF_SIZE); // Initialize last_response
 
+    // Guards the request queue; request callbacks are called without it, so they may submit or cancel requests
+    fhttp->queue_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+
     fhttp->state = IDLE;
 
     // FURI_LOG_I(HTTP_TAG, "UART initialized successfully.");
@@ -306,30 +451,40 @@ void flipper_http_free(FlipperHTTP *fhttp)
         FURI_LOG_E(HTTP_TAG, "UART handle is NULL. Already deinitialized?");
         return;
     }
-    // Stop asynchronous RX
-    furi_hal_serial_async_rx_stop(fhttp->serial_handle);
+    // Stop DMA RX
+    furi_hal_serial_dma_rx_stop(fhttp->serial_handle);
 
     // Release and deinitialize the serial handle
     furi_hal_serial_disable_direction(fhttp->serial_handle, FuriHalSerialDirectionRx);
     furi_hal_serial_control_release(fhttp->serial_handle);
     furi_hal_serial_deinit(fhttp->serial_handle);
 
+    // Stop the timeouts before the worker goes, a timer firing later would flag a freed thread
+    fhttp->timeout_armed = false;
+    furi_timer_stop(fhttp->get_timeout_timer);
+
     // Signal the worker thread to stop
     furi_thread_flags_set(fhttp->rx_thread_id, WorkerEvtStop);
     // Wait for the thread to finish
     furi_thread_join(fhttp->rx_thread);
+    // Free the timer, the worker can no longer re-arm it
+    furi_timer_free(fhttp->get_timeout_timer);
+    fhttp->get_timeout_timer = NULL;
     // Free the thread resources
     furi_thread_free(fhttp->rx_thread);
 
-    // Free the stream buffer
-    furi_stream_buffer_free(fhttp->flipper_http_stream);
+    // Close a file left open by an interrupted transfer
+    flipper_http_file_sink_close(&fhttp->file_sink);
 
-    // Free the timer
-    if (fhttp->get_timeout_timer)
+    // Drop the submitted requests that did not end
+    for (size_t i = 0; i < REQUEST_QUEUE_SIZE; i++)
     {
-        furi_timer_free(fhttp->get_timeout_timer);
-        fhttp->get_timeout_timer = NULL;
+        flipper_http_queue_release(&fhttp->queue[i]);
     }
+    furi_mutex_free(fhttp->queue_mutex);
+
+    // Free the stream buffer
+    furi_stream_buffer_free(fhttp->flipper_http_stream);
 
     // Free the last response
     if (fhttp->last_response)
@@ -413,6 +568,131 @@ bool flipper_http_append_to_file(
     return true;
 }
 
+/**
+ * @brief      Open a file sink for a transfer.
+ * @return     true if the file was opened, false otherwise.
+ * @param      sink           The sink to open (closed first if it is open).
+ * @param      file_path      The path to the file.
+ * @param      start_new_file Flag to indicate if a new file should be created instead of appending.
+ * @note       The file stays open until flipper_http_file_sink_close, so each write is a memory copy
+ *             and the SD card is only written in FILE_SINK_BUFFER_SIZE blocks.
+ */
+bool flipper_http_file_sink_open(FlipperHTTPFileSink *sink, const char *file_path, bool start_new_file)
+{
+    if (!sink || !file_path)
+    {
+        FURI_LOG_E(HTTP_TAG, "Invalid arguments provided to flipper_http_file_sink_open.");
+        return false;
+    }
+    flipper_http_file_sink_close(sink);
+
+    sink->storage = furi_record_open(RECORD_STORAGE);
+    sink->file = storage_file_alloc(sink->storage);
+    if (!storage_file_open(sink->file, file_path, FSAM_WRITE, start_new_file ? FSOM_CREATE_ALWAYS : FSOM_OPEN_APPEND))
+    {
+        FURI_LOG_E(HTTP_TAG, "Failed to open file for writing: %s", file_path);
+        storage_file_free(sink->file);
+        furi_record_close(RECORD_STORAGE);
+        sink->file = NULL;
+        sink->storage = NULL;
+        return false;
+    }
+
+    // Without a buffer every write goes straight to the file, which is slower but still works
+    sink->buffer = (uint8_t *)malloc(FILE_SINK_BUFFER_SIZE);
+    sink->buffer_len = 0;
+    sink->write_us = 0;
+    sink->writes = 0;
+    return true;
+}
+
+// Function to write to the file of a sink, timing the write with the cycle counter
+static bool flipper_http_file_sink_write_file(FlipperHTTPFileSink *sink, const void *data, size_t data_size)
+{
+    uint32_t start = DWT->CYCCNT;
+    bool ok = storage_file_write(sink->file, data, data_size) == data_size;
+    sink->write_us += (DWT->CYCCNT - start) / furi_hal_cortex_instructions_per_microsecond();
+    sink->writes++;
+    return ok;
+}
+
+// Function to write the buffered bytes of a file sink
+static bool flipper_http_file_sink_flush(FlipperHTTPFileSink *sink)
+{
+    if (sink->buffer_len == 0)
+    {
+        return true;
+    }
+    bool ok = flipper_http_file_sink_write_file(sink, sink->buffer, sink->buffer_len);
+    sink->buffer_len = 0;
+    return ok;
+}
+
+/**
+ * @brief      Write data to an open file sink.
+ * @return     true if the data was written (or buffered), false otherwise.
+ * @param      sink      The sink to write to.
+ * @param      data      The data to write.
+ * @param      data_size The size of the data.
+ */
+bool flipper_http_file_sink_write(FlipperHTTPFileSink *sink, const void *data, size_t data_size)
+{
+    if (!sink || !sink->file)
+    {
+        FURI_LOG_E(HTTP_TAG, "File sink is not open.");
+        return false;
+    }
+    if (!sink->buffer)
+    {
+        return flipper_http_file_sink_write_file(sink, data, data_size);
+    }
+
+    const uint8_t *bytes = (const uint8_t *)data;
+    while (data_size > 0)
+    {
+        size_t len = MIN(data_size, FILE_SINK_BUFFER_SIZE - sink->buffer_len);
+        memcpy(&sink->buffer[sink->buffer_len], bytes, len);
+        sink->buffer_len += len;
+        bytes += len;
+        data_size -= len;
+        if (sink->buffer_len == FILE_SINK_BUFFER_SIZE && !flipper_http_file_sink_flush(sink))
+        {
+            FURI_LOG_E(HTTP_TAG, "Failed to write to file");
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief      Write what is buffered and close a file sink.
+ * @return     true if everything was written, false otherwise.
+ * @param      sink The sink to close. Closing a closed sink does nothing.
+ */
+bool flipper_http_file_sink_close(FlipperHTTPFileSink *sink)
+{
+    if (!sink || !sink->file)
+    {
+        return true;
+    }
+    bool ok = true;
+    if (sink->buffer)
+    {
+        ok = flipper_http_file_sink_flush(sink);
+        free(sink->buffer);
+        sink->buffer = NULL;
+    }
+    // Closing writes what the file system still caches, so it counts as write time
+    uint32_t start = DWT->CYCCNT;
+    storage_file_close(sink->file);
+    sink->write_us += (DWT->CYCCNT - start) / furi_hal_cortex_instructions_per_microsecond();
+    storage_file_free(sink->file);
+    furi_record_close(RECORD_STORAGE);
+    sink->file = NULL;
+    sink->storage = NULL;
+    return ok;
+}
+
 /**
  * @brief      Send a command to deauthenticate a WiFi network.
  * @return     true if the request was successful, false otherwise.
@@ -432,17 +712,15 @@ bool flipper_http_deauth_start(FlipperHTTP *fhttp, const char *ssid)
         return false;
     }
 
-    char buffer[256];
-
-    int ret = snprintf(buffer, sizeof(buffer), "[DEAUTH]{\"ssid\":\"%s\"}", ssid);
-
-    if (ret < 0 || ret >= (int)sizeof(buffer))
+    FlipperHTTPCommandWriter writer;
+    if (!flipper_http_command_begin(fhttp, &writer, "[DEAUTH]{\"ssid\":"))
     {
-        FURI_LOG_E("FlipperHTTP", "Failed to format WiFi deauth command.");
         return false;
     }
-
-    return flipper_http_send_data(fhttp, buffer);
+    flipper_http_command_write_string(&writer, ssid);
+    flipper_http_command_write(&writer, "}");
+    flipper_http_command_end(&writer);
+    return true;
 }
 
 /**
@@ -462,218 +740,868 @@ bool flipper_http_deauth_stop(FlipperHTTP *fhttp)
 }
 
 /**
- * @brief      Load data from a file.
- * @return     The loaded data as a FuriString.
- * @param      file_path The path to the file to load.
+ * @brief      Open a file for reading through a fixed-size window.
+ * @return     true if the file was opened, false otherwise.
+ * @param      reader    The reader to open (closed first if it is open).
+ * @param      file_path The path to the file.
  */
-FuriString *flipper_http_load_from_file(char *file_path)
+bool flipper_http_file_reader_open(FlipperHTTPFileReader *reader, const char *file_path)
 {
-    // Open the storage record
-    Storage *storage = furi_record_open(RECORD_STORAGE);
-    if (!storage)
+    if (!reader || !file_path)
     {
-        FURI_LOG_E(HTTP_TAG, "Failed to open storage record");
-        return NULL;
+        FURI_LOG_E(HTTP_TAG, "Invalid arguments provided to flipper_http_file_reader_open.");
+        return false;
     }
+    flipper_http_file_reader_close(reader);
 
-    // Allocate a file handle
-    File *file = storage_file_alloc(storage);
-    if (!file)
+    reader->storage = furi_record_open(RECORD_STORAGE);
+    reader->file = storage_file_alloc(reader->storage);
+    if (!storage_file_open(reader->file, file_path, FSAM_READ, FSOM_OPEN_EXISTING))
     {
-        FURI_LOG_E(HTTP_TAG, "Failed to allocate storage file");
+        FURI_LOG_E(HTTP_TAG, "Failed to open file for reading: %s", file_path);
+        storage_file_free(reader->file);
         furi_record_close(RECORD_STORAGE);
-        return NULL;
+        reader->file = NULL;
+        reader->storage = NULL;
+        return false;
     }
+    reader->file_size = storage_file_size(reader->file);
+    reader->window_offset = 0;
+    reader->window_len = 0;
+    reader->window_pos = 0;
+    return true;
+}
 
-    // Open the file for reading
-    if (!storage_file_open(file, file_path, FSAM_READ, FSOM_OPEN_EXISTING))
+/**
+ * @brief      Close a file reader. Closing a closed reader does nothing.
+ * @return     void
+ * @param      reader The reader to close.
+ */
+void flipper_http_file_reader_close(FlipperHTTPFileReader *reader)
+{
+    if (!reader || !reader->file)
     {
-        storage_file_free(file);
-        furi_record_close(RECORD_STORAGE);
-        FURI_LOG_E(HTTP_TAG, "Failed to open file for reading: %s", file_path);
-        return NULL;
+        return;
     }
+    storage_file_close(reader->file);
+    storage_file_free(reader->file);
+    furi_record_close(RECORD_STORAGE);
+    reader->file = NULL;
+    reader->storage = NULL;
+}
 
-    size_t file_size = storage_file_size(file);
-
-    // final memory check
-    if (memmgr_heap_get_max_free_block() < file_size)
+// Function to read the next window of the file, returns false at the end of the file
+static bool flipper_http_file_reader_fill(FlipperHTTPFileReader *reader)
+{
+    if (!reader->file)
     {
-        FURI_LOG_E(HTTP_TAG, "Not enough heap to read file.");
-        storage_file_close(file);
-        storage_file_free(file);
-        furi_record_close(RECORD_STORAGE);
-        return NULL;
+        return false;
     }
-
-    // Allocate a buffer to hold the read data
-    uint8_t *buffer = (uint8_t *)malloc(file_size);
-    if (!buffer)
+    reader->window_offset += reader->window_len;
+    reader->window_pos = 0;
+    reader->window_len = storage_file_read(reader->file, reader->window, FILE_READER_WINDOW);
+    if (storage_file_get_error(reader->file) != FSE_OK)
     {
-        FURI_LOG_E(HTTP_TAG, "Failed to allocate buffer");
-        storage_file_close(file);
-        storage_file_free(file);
-        furi_record_close(RECORD_STORAGE);
-        return NULL;
+        FURI_LOG_E(HTTP_TAG, "Error reading from file.");
+        reader->window_len = 0;
     }
+    return reader->window_len > 0;
+}
 
-    // Allocate a FuriString to hold the received data
-    FuriString *str_result = furi_string_alloc();
-    if (!str_result)
+/**
+ * @brief      Get the next piece of the file without copying it.
+ * @return     true if data was returned, false at the end of the file.
+ * @param      reader The reader.
+ * @param      data   Set to the next unread bytes, valid until the next call on the reader.
+ * @param      len    Set to the number of bytes (at most FILE_READER_WINDOW).
+ */
+bool flipper_http_file_reader_next_chunk(FlipperHTTPFileReader *reader, const uint8_t **data, size_t *len)
+{
+    if (!reader || !data || !len)
     {
-        FURI_LOG_E(HTTP_TAG, "Failed to allocate FuriString");
-        storage_file_close(file);
-        storage_file_free(file);
-        furi_record_close(RECORD_STORAGE);
-        return NULL;
+        return false;
     }
-
-    // Reset the FuriString to ensure it's empty before reading
-    furi_string_reset(str_result);
-
-    // Read data into the buffer
-    size_t read_count = storage_file_read(file, buffer, MAX_FILE_SHOW);
-    if (storage_file_get_error(file) != FSE_OK)
+    if (reader->window_pos == reader->window_len && !flipper_http_file_reader_fill(reader))
     {
-        FURI_LOG_E(HTTP_TAG, "Error reading from file.");
-        furi_string_free(str_result);
-        storage_file_close(file);
-        storage_file_free(file);
-        furi_record_close(RECORD_STORAGE);
-        return NULL;
+        return false;
     }
+    *data = &reader->window[reader->window_pos];
+    *len = reader->window_len - reader->window_pos;
+    reader->window_pos = reader->window_len;
+    return true;
+}
 
-    // Append each byte to the FuriString
-    for (size_t i = 0; i < read_count; i++)
+/**
+ * @brief      Copy the next bytes of the file.
+ * @return     The number of bytes copied, 0 at the end of the file.
+ * @param      reader The reader.
+ * @param      buffer The buffer to copy to.
+ * @param      size   The size of the buffer.
+ */
+size_t flipper_http_file_reader_read(FlipperHTTPFileReader *reader, void *buffer, size_t size)
+{
+    if (!reader || !buffer)
     {
-        furi_string_push_back(str_result, buffer[i]);
+        return 0;
     }
-
-    // Clean up
-    storage_file_close(file);
-    storage_file_free(file);
-    furi_record_close(RECORD_STORAGE);
-    free(buffer);
-    return str_result;
+    uint8_t *out = (uint8_t *)buffer;
+    size_t copied = 0;
+    while (copied < size)
+    {
+        if (reader->window_pos == reader->window_len && !flipper_http_file_reader_fill(reader))
+        {
+            break;
+        }
+        size_t len = MIN(size - copied, reader->window_len - reader->window_pos);
+        memcpy(&out[copied], &reader->window[reader->window_pos], len);
+        reader->window_pos += len;
+        copied += len;
+    }
+    return copied;
 }
 
 /**
- * @brief      Load data from a file with a size limit.
- * @return     The loaded data as a FuriString.
- * @param      file_path The path to the file to load.
- * @param      limit     The size limit for loading data.
+ * @brief      Read the next line of the file.
+ * @return     true if a line was read, false at the end of the file.
+ * @param      reader The reader.
+ * @param      line   The buffer for the line, without the trailing "\r\n" and null-terminated.
+ * @param      size   The size of the line buffer. Longer lines are cut, and the rest is skipped.
  */
-FuriString *flipper_http_load_from_file_with_limit(char *file_path, size_t limit)
+bool flipper_http_file_reader_read_line(FlipperHTTPFileReader *reader, char *line, size_t size)
 {
-    if (memmgr_heap_get_max_free_block() < limit)
+    if (!reader || !line || size == 0)
     {
-        FURI_LOG_E(HTTP_TAG, "Not enough heap to read file.");
-        return NULL;
+        return false;
     }
+    size_t line_len = 0;
+    bool found = false;
+    while (true)
+    {
+        if (reader->window_pos == reader->window_len && !flipper_http_file_reader_fill(reader))
+        {
+            break;
+        }
+        found = true;
+        const uint8_t *start = &reader->window[reader->window_pos];
+        size_t available = reader->window_len - reader->window_pos;
+        const uint8_t *newline = (const uint8_t *)memchr(start, '\n', available);
+        size_t len = newline ? (size_t)(newline - start) : available;
+
+        size_t copy_len = MIN(len, size - 1 - line_len);
+        memcpy(&line[line_len], start, copy_len);
+        line_len += copy_len;
+        reader->window_pos += len;
+        if (newline)
+        {
+            reader->window_pos++; // skip the newline
+            break;
+        }
+    }
+    if (line_len > 0 && line[line_len - 1] == '\r')
+    {
+        line_len--;
+    }
+    line[line_len] = '\0';
+    return found;
+}
 
-    // Open the storage record
-    Storage *storage = furi_record_open(RECORD_STORAGE);
-    if (!storage)
+/**
+ * @brief      Move to a position in the file.
+ * @return     true if the position is inside the file, false otherwise.
+ * @param      reader The reader.
+ * @param      offset The offset from the start of the file.
+ */
+bool flipper_http_file_reader_seek(FlipperHTTPFileReader *reader, size_t offset)
+{
+    if (!reader || !reader->file || offset > reader->file_size)
     {
-        FURI_LOG_E(HTTP_TAG, "Failed to open storage record");
-        return NULL;
+        return false;
+    }
+    // Inside the current window: nothing to read again
+    if (offset >= reader->window_offset && offset <= reader->window_offset + reader->window_len)
+    {
+        reader->window_pos = offset - reader->window_offset;
+        return true;
+    }
+    if (!storage_file_seek(reader->file, offset, true))
+    {
+        FURI_LOG_E(HTTP_TAG, "Failed to seek in file.");
+        return false;
     }
+    reader->window_offset = offset;
+    reader->window_len = 0;
+    reader->window_pos = 0;
+    return true;
+}
 
-    // Allocate a file handle
-    File *file = storage_file_alloc(storage);
-    if (!file)
+/**
+ * @brief      Get the current position in the file.
+ * @return     The offset of the next byte to be read.
+ * @param      reader The reader.
+ */
+size_t flipper_http_file_reader_tell(FlipperHTTPFileReader *reader)
+{
+    return reader ? reader->window_offset + reader->window_pos : 0;
+}
+
+// Function to load up to limit bytes of a file into a FuriString through a file reader
+static FuriString *flipper_http_load(const char *file_path, size_t limit, bool fail_over_limit)
+{
+    FlipperHTTPFileReader *reader = (FlipperHTTPFileReader *)malloc(sizeof(FlipperHTTPFileReader));
+    if (!reader)
     {
-        FURI_LOG_E(HTTP_TAG, "Failed to allocate storage file");
-        furi_record_close(RECORD_STORAGE);
+        FURI_LOG_E(HTTP_TAG, "Failed to allocate file reader");
         return NULL;
     }
-
-    // Open the file for reading
-    if (!storage_file_open(file, file_path, FSAM_READ, FSOM_OPEN_EXISTING))
+    memset(reader, 0, sizeof(FlipperHTTPFileReader));
+    if (!flipper_http_file_reader_open(reader, file_path))
     {
-        storage_file_free(file);
-        furi_record_close(RECORD_STORAGE);
-        FURI_LOG_E(HTTP_TAG, "Failed to open file for reading: %s", file_path);
+        free(reader);
         return NULL;
     }
 
-    size_t file_size = storage_file_size(file);
-
-    if (file_size > limit)
+    size_t size = reader->file_size;
+    if (size > limit)
     {
-        FURI_LOG_E(HTTP_TAG, "File size exceeds limit: %d > %d", file_size, limit);
-        storage_file_close(file);
-        storage_file_free(file);
-        furi_record_close(RECORD_STORAGE);
-        return NULL;
+        if (fail_over_limit)
+        {
+            FURI_LOG_E(HTTP_TAG, "File size exceeds limit: %zu > %zu", size, limit);
+            flipper_http_file_reader_close(reader);
+            free(reader);
+            return NULL;
+        }
+        size = limit;
     }
 
     // final memory check
-    if (memmgr_heap_get_max_free_block() < file_size)
+    if (memmgr_heap_get_max_free_block() < size + 1)
     {
         FURI_LOG_E(HTTP_TAG, "Not enough heap to read file.");
-        storage_file_close(file);
-        storage_file_free(file);
-        furi_record_close(RECORD_STORAGE);
+        flipper_http_file_reader_close(reader);
+        free(reader);
         return NULL;
     }
 
-    // Allocate a buffer to hold the read data
-    uint8_t *buffer = (uint8_t *)malloc(file_size);
-    if (!buffer)
+    // The string is the only copy of the data, filled one window at a time
+    FuriString *str_result = furi_string_alloc();
+    furi_string_reserve(str_result, size + 1);
+    const uint8_t *data;
+    size_t len;
+    size_t loaded = 0;
+    while (loaded < size && flipper_http_file_reader_next_chunk(reader, &data, &len))
     {
-        FURI_LOG_E(HTTP_TAG, "Failed to allocate buffer");
-        storage_file_close(file);
-        storage_file_free(file);
-        furi_record_close(RECORD_STORAGE);
-        return NULL;
+        len = MIN(len, size - loaded);
+        for (size_t i = 0; i < len; i++)
+        {
+            furi_string_push_back(str_result, data[i]);
+        }
+        loaded += len;
     }
 
-    // Allocate a FuriString with preallocated capacity
-    FuriString *str_result = furi_string_alloc();
-    if (!str_result)
-    {
-        FURI_LOG_E(HTTP_TAG, "Failed to allocate FuriString");
-        free(buffer);
-        storage_file_close(file);
-        storage_file_free(file);
-        furi_record_close(RECORD_STORAGE);
-        return NULL;
-    }
-    furi_string_reserve(str_result, file_size);
+    flipper_http_file_reader_close(reader);
+    free(reader);
+    return str_result;
+}
+
+/**
+ * @brief      Load data from a file.
+ * @return     The loaded data as a FuriString.
+ * @param      file_path The path to the file to load.
+ * @note       At most MAX_FILE_SHOW bytes are loaded. Use a FlipperHTTPFileReader for larger files.
+ */
+FuriString *flipper_http_load_from_file(char *file_path)
+{
+    return flipper_http_load(file_path, MAX_FILE_SHOW, false);
+}
 
-    // Read data into the buffer
-    size_t read_count = storage_file_read(file, buffer, file_size);
-    if (storage_file_get_error(file) != FSE_OK)
+/**
+ * @brief      Load data from a file with a size limit.
+ * @return     The loaded data as a FuriString.
+ * @param      file_path The path to the file to load.
+ * @param      limit     The size limit for loading data.
+ */
+FuriString *flipper_http_load_from_file_with_limit(char *file_path, size_t limit)
+{
+    if (memmgr_heap_get_max_free_block() < limit)
     {
-        FURI_LOG_E(HTTP_TAG, "Error reading from file.");
-        furi_string_free(str_result);
-        free(buffer);
-        storage_file_close(file);
-        storage_file_free(file);
-        furi_record_close(RECORD_STORAGE);
+        FURI_LOG_E(HTTP_TAG, "Not enough heap to read file.");
         return NULL;
     }
-    if (read_count == 0)
+    FuriString *str_result = flipper_http_load(file_path, limit, true);
+    if (str_result && furi_string_size(str_result) == 0)
     {
         FURI_LOG_E(HTTP_TAG, "No data read from file.");
         furi_string_free(str_result);
-        free(buffer);
-        storage_file_close(file);
-        storage_file_free(file);
-        furi_record_close(RECORD_STORAGE);
         return NULL;
     }
+    return str_result;
+}
+
+// What the JSON tokenizer expects next (FlipperHTTPJson.expect)
+enum
+{
+    JSON_EXPECT_VALUE,
+    JSON_EXPECT_VALUE_OR_END, // after '['
+    JSON_EXPECT_KEY,          // after ',' in an object
+    JSON_EXPECT_KEY_OR_END,   // after '{'
+    JSON_EXPECT_COLON,
+    JSON_EXPECT_COMMA_OR_END,
+    JSON_EXPECT_NOTHING, // after the top-level value
+};
+
+// Token the JSON tokenizer is in the middle of (FlipperHTTPJson.token)
+enum
+{
+    JSON_TOKEN_NONE,
+    JSON_TOKEN_STRING,
+    JSON_TOKEN_KEY,
+    JSON_TOKEN_ESCAPE,     // after '\' in a string
+    JSON_TOKEN_KEY_ESCAPE, // after '\' in a key
+    JSON_TOKEN_UNICODE,    // reading the hex digits of \uXXXX in a string
+    JSON_TOKEN_KEY_UNICODE,
+    JSON_TOKEN_NUMBER,
+    JSON_TOKEN_LITERAL,
+};
+
+/**
+ * @brief      Initialize a JSON tokenizer.
+ * @return     void
+ * @param      json     The tokenizer to initialize.
+ * @param      callback The callback for each value.
+ * @param      context  The context for the callback.
+ */
+void flipper_http_json_init(FlipperHTTPJson *json, FlipperHTTPJson_Callback callback, void *context)
+{
+    if (!json)
+    {
+        return;
+    }
+    memset(json, 0, sizeof(FlipperHTTPJson));
+    json->callback = callback;
+    json->context = context;
+    json->expect = JSON_EXPECT_VALUE;
+    json->token = JSON_TOKEN_NONE;
+}
+
+// Function to report an event, returns false if the callback stopped the tokenizer
+static bool json_emit(FlipperHTTPJson *json, FlipperHTTPJsonEvent event, const char *value, size_t value_len)
+{
+    json->path[json->path_len] = '\0';
+    if (json->callback && !json->callback(event, json->path, value, value_len, json->context))
+    {
+        json->stopped = true;
+        return false;
+    }
+    return true;
+}
+
+// Function to add text to the current path, cutting it when it does not fit
+static void json_path_append(FlipperHTTPJson *json, const char *text, size_t len)
+{
+    size_t space = JSON_PATH_SIZE - 1 - json->path_len;
+    len = MIN(len, space);
+    memcpy(&json->path[json->path_len], text, len);
+    json->path_len += len;
+}
+
+// Function to add a byte to the current string, key or number, cutting it when it does not fit
+static void json_value_append(FlipperHTTPJson *json, char c)
+{
+    if (json->value_len < JSON_TOKEN_SIZE - 1)
+    {
+        json->value[json->value_len++] = c;
+    }
+}
+
+// Function to add a code point to the current string as UTF-8
+static void json_value_append_utf8(FlipperHTTPJson *json, uint32_t code)
+{
+    if (code < 0x80)
+    {
+        json_value_append(json, (char)code);
+    }
+    else if (code < 0x800)
+    {
+        json_value_append(json, (char)(0xC0 | (code >> 6)));
+        json_value_append(json, (char)(0x80 | (code & 0x3F)));
+    }
+    else if (code < 0x10000)
+    {
+        json_value_append(json, (char)(0xE0 | (code >> 12)));
+        json_value_append(json, (char)(0x80 | ((code >> 6) & 0x3F)));
+        json_value_append(json, (char)(0x80 | (code & 0x3F)));
+    }
+    else
+    {
+        json_value_append(json, (char)(0xF0 | (code >> 18)));
+        json_value_append(json, (char)(0x80 | ((code >> 12) & 0x3F)));
+        json_value_append(json, (char)(0x80 | ((code >> 6) & 0x3F)));
+        json_value_append(json, (char)(0x80 | (code & 0x3F)));
+    }
+}
+
+// Function to set the path of an array element before its value starts
+static void json_begin_value(FlipperHTTPJson *json)
+{
+    if (json->depth > 0 && json->in_array[json->depth - 1])
+    {
+        char index[8];
+        int len = snprintf(index, sizeof(index), "[%u]", json->index[json->depth - 1]);
+        json->path_len = json->base[json->depth - 1];
+        json_path_append(json, index, len);
+    }
+}
+
+// Function to move on once a value is complete
+static void json_end_value(FlipperHTTPJson *json)
+{
+    json->expect = json->depth > 0 ? JSON_EXPECT_COMMA_OR_END : JSON_EXPECT_NOTHING;
+}
+
+// Function to open an object or array
+static bool json_open(FlipperHTTPJson *json, bool is_array)
+{
+    if (json->depth >= JSON_MAX_DEPTH)
+    {
+        FURI_LOG_E(HTTP_TAG, "JSON nested deeper than %d levels.", JSON_MAX_DEPTH);
+        json->error = true;
+        return false;
+    }
+    if (!json_emit(json, is_array ? JSON_EVENT_ARRAY_START : JSON_EVENT_OBJECT_START, "", 0))
+    {
+        return false;
+    }
+    json->in_array[json->depth] = is_array;
+    json->index[json->depth] = 0;
+    json->base[json->depth] = json->path_len;
+    json->depth++;
+    json->expect = is_array ? JSON_EXPECT_VALUE_OR_END : JSON_EXPECT_KEY_OR_END;
+    return true;
+}
+
+// Function to close the innermost object or array
+static bool json_close(FlipperHTTPJson *json, bool is_array)
+{
+    if (json->depth == 0 || json->in_array[json->depth - 1] != is_array)
+    {
+        json->error = true;
+        return false;
+    }
+    json->depth--;
+    json->path_len = json->base[json->depth];
+    json_end_value(json);
+    return json_emit(json, is_array ? JSON_EVENT_ARRAY_END : JSON_EVENT_OBJECT_END, "", 0);
+}
+
+// Function to finish a number, which only ends at the first byte that is not part of it
+static bool json_end_number(FlipperHTTPJson *json)
+{
+    json->token = JSON_TOKEN_NONE;
+    json->value[json->value_len] = '\0';
+    json_end_value(json);
+    return json_emit(json, JSON_EVENT_NUMBER, json->value, json->value_len);
+}
+
+// Function to handle a byte outside of strings, numbers and literals
+static bool json_structural(FlipperHTTPJson *json, char c)
+{
+    if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+    {
+        return true;
+    }
+    switch (json->expect)
+    {
+    case JSON_EXPECT_VALUE_OR_END:
+        if (c == ']')
+        {
+            return json_close(json, true);
+        }
+        // fall through
+    case JSON_EXPECT_VALUE:
+        json_begin_value(json);
+        if (c == '{' || c == '[')
+        {
+            return json_open(json, c == '[');
+        }
+        json->value_len = 0;
+        json->high_surrogate = 0;
+        if (c == '"')
+        {
+            json->token = JSON_TOKEN_STRING;
+            return true;
+        }
+        if (c == '-' || (c >= '0' && c <= '9'))
+        {
+            json->token = JSON_TOKEN_NUMBER;
+            json_value_append(json, c);
+            return true;
+        }
+        json->literal = NULL;
+        if (c == 't')
+            json->literal = "true";
+        else if (c == 'f')
+            json->literal = "false";
+        else if (c == 'n')
+            json->literal = "null";
+        if (json->literal)
+        {
+            json->token = JSON_TOKEN_LITERAL;
+            json->literal_pos = 1;
+            return true;
+        }
+        break;
+    case JSON_EXPECT_KEY_OR_END:
+        if (c == '}')
+        {
+            return json_close(json, false);
+        }
+        // fall through
+    case JSON_EXPECT_KEY:
+        if (c == '"')
+        {
+            json->token = JSON_TOKEN_KEY;
+            json->value_len = 0;
+            json->high_surrogate = 0;
+            return true;
+        }
+        break;
+    case JSON_EXPECT_COLON:
+        if (c == ':')
+        {
+            json->expect = JSON_EXPECT_VALUE;
+            return true;
+        }
+        break;
+    case JSON_EXPECT_COMMA_OR_END:
+        if (c == ',')
+        {
+            if (json->in_array[json->depth - 1])
+            {
+                json->index[json->depth - 1]++;
+                json->expect = JSON_EXPECT_VALUE;
+            }
+            else
+            {
+                json->expect = JSON_EXPECT_KEY;
+            }
+            return true;
+        }
+        if (c == ']' || c == '}')
+        {
+            return json_close(json, c == ']');
+        }
+        break;
+    default:
+        break;
+    }
+    json->error = true;
+    return false;
+}
+
+// Function to finish a string or key at its closing quote
+static bool json_end_string(FlipperHTTPJson *json, bool is_key)
+{
+    json->token = JSON_TOKEN_NONE;
+    json->value[json->value_len] = '\0';
+    if (is_key)
+    {
+        // The path of the value that follows is the path of the object plus the key
+        json->path_len = json->base[json->depth - 1];
+        if (json->path_len > 0)
+        {
+            json_path_append(json, ".", 1);
+        }
+        json_path_append(json, json->value, json->value_len);
+        json->expect = JSON_EXPECT_COLON;
+        return true;
+    }
+    json_end_value(json);
+    return json_emit(json, JSON_EVENT_STRING, json->value, json->value_len);
+}
+
+// Function to handle one byte of a JSON document
+static bool json_byte(FlipperHTTPJson *json, char c)
+{
+    switch (json->token)
+    {
+    case JSON_TOKEN_NONE:
+        return json_structural(json, c);
+    case JSON_TOKEN_STRING:
+    case JSON_TOKEN_KEY:
+    {
+        bool is_key = json->token == JSON_TOKEN_KEY;
+        if (c == '"')
+        {
+            return json_end_string(json, is_key);
+        }
+        if (c == '\\')
+        {
+            json->token = is_key ? JSON_TOKEN_KEY_ESCAPE : JSON_TOKEN_ESCAPE;
+            return true;
+        }
+        if ((uint8_t)c < 0x20)
+        {
+            break; // control characters must be escaped
+        }
+        json_value_append(json, c);
+        return true;
+    }
+    case JSON_TOKEN_ESCAPE:
+    case JSON_TOKEN_KEY_ESCAPE:
+    {
+        bool is_key = json->token == JSON_TOKEN_KEY_ESCAPE;
+        static const char escapes[] = "\"\"\\\\//b\bf\fn\nr\rt\t";
+        json->token = is_key ? JSON_TOKEN_KEY : JSON_TOKEN_STRING;
+        if (c == 'u')
+        {
+            json->token = is_key ? JSON_TOKEN_KEY_UNICODE : JSON_TOKEN_UNICODE;
+            json->unicode = 0;
+            json->unicode_digits = 0;
+            return true;
+        }
+        for (size_t i = 0; i < sizeof(escapes) - 1; i += 2)
+        {
+            if (escapes[i] == c)
+            {
+                json_value_append(json, escapes[i + 1]);
+                return true;
+            }
+        }
+        break;
+    }
+    case JSON_TOKEN_UNICODE:
+    case JSON_TOKEN_KEY_UNICODE:
+    {
+        uint8_t digit;
+        if (c >= '0' && c <= '9')
+            digit = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            digit = c - 'A' + 10;
+        else
+            break;
+        json->unicode = (json->unicode << 4) | digit;
+        if (++json->unicode_digits < 4)
+        {
+            return true;
+        }
+        json->token = json->token == JSON_TOKEN_KEY_UNICODE ? JSON_TOKEN_KEY : JSON_TOKEN_STRING;
+        if (json->unicode >= 0xD800 && json->unicode < 0xDC00)
+        {
+            json->high_surrogate = json->unicode; // wait for the second half
+        }
+        else if (json->unicode >= 0xDC00 && json->unicode < 0xE000 && json->high_surrogate)
+        {
+            json_value_append_utf8(json, 0x10000 + ((uint32_t)(json->high_surrogate - 0xD800) << 10) + (json->unicode - 0xDC00));
+            json->high_surrogate = 0;
+        }
+        else
+        {
+            json_value_append_utf8(json, json->unicode);
+            json->high_surrogate = 0;
+        }
+        return true;
+    }
+    case JSON_TOKEN_NUMBER:
+        if ((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')
+        {
+            json_value_append(json, c);
+            return true;
+        }
+        // The byte after a number belongs to the next token
+        return json_end_number(json) && json_structural(json, c);
+    case JSON_TOKEN_LITERAL:
+        if (c != json->literal[json->literal_pos])
+        {
+            break;
+        }
+        if (json->literal[++json->literal_pos] == '\0')
+        {
+            json->token = JSON_TOKEN_NONE;
+            json_end_value(json);
+            FlipperHTTPJsonEvent event = JSON_EVENT_NULL;
+            if (json->literal[0] == 't')
+                event = JSON_EVENT_TRUE;
+            else if (json->literal[0] == 'f')
+                event = JSON_EVENT_FALSE;
+            return json_emit(json, event, json->literal, json->literal_pos);
+        }
+        return true;
+    default:
+        break;
+    }
+    json->error = true;
+    return false;
+}
+
+/**
+ * @brief      Feed the next piece of a JSON document to a tokenizer.
+ * @return     true if the tokenizer can take more, false after a syntax error or once the callback stopped it.
+ * @param      json The tokenizer.
+ * @param      data The next bytes of the document (tokens may be split anywhere).
+ * @param      len  The number of bytes.
+ */
+bool flipper_http_json_feed(FlipperHTTPJson *json, const char *data, size_t len)
+{
+    if (!json || (!data && len > 0))
+    {
+        return false;
+    }
+    if (json->error || json->stopped)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++)
+    {
+        if (!json_byte(json, data[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief      Tell a tokenizer that the document has ended.
+ * @return     true if a complete JSON document was read, false otherwise.
+ * @param      json The tokenizer.
+ */
+bool flipper_http_json_finish(FlipperHTTPJson *json)
+{
+    if (!json || json->error || json->stopped)
+    {
+        return false;
+    }
+    // A top-level number has nothing after it to end it
+    if (json->token == JSON_TOKEN_NUMBER && !json_end_number(json))
+    {
+        return false;
+    }
+    return json->token == JSON_TOKEN_NONE && json->expect == JSON_EXPECT_NOTHING;
+}
 
-    // Append the entire buffer to FuriString in one operation
-    furi_string_cat_str(str_result, (char *)buffer);
+/**
+ * @brief      Run a JSON tokenizer over a file, one window at a time.
+ * @return     true if the file was read without a syntax error (or the callback stopped early), false otherwise.
+ * @param      json      The initialized tokenizer.
+ * @param      file_path The path to the file.
+ */
+bool flipper_http_json_parse_file(FlipperHTTPJson *json, const char *file_path)
+{
+    if (!json || !file_path)
+    {
+        FURI_LOG_E(HTTP_TAG, "Invalid arguments provided to flipper_http_json_parse_file.");
+        return false;
+    }
+    FlipperHTTPFileReader *reader = (FlipperHTTPFileReader *)malloc(sizeof(FlipperHTTPFileReader));
+    if (!reader)
+    {
+        FURI_LOG_E(HTTP_TAG, "Failed to allocate file reader");
+        return false;
+    }
+    memset(reader, 0, sizeof(FlipperHTTPFileReader));
+    if (!flipper_http_file_reader_open(reader, file_path))
+    {
+        free(reader);
+        return false;
+    }
+
+    const uint8_t *data;
+    size_t len;
+    while (flipper_http_file_reader_next_chunk(reader, &data, &len) &&
+           flipper_http_json_feed(json, (const char *)data, len))
+    {
+    }
+    flipper_http_file_reader_close(reader);
+    free(reader);
+
+    if (json->stopped)
+    {
+        return true;
+    }
+    if (!flipper_http_json_finish(json))
+    {
+        FURI_LOG_E(HTTP_TAG, "Invalid JSON in file: %s", file_path);
+        return false;
+    }
+    return true;
+}
+
+// Value searched for by flipper_http_json_extract
+typedef struct
+{
+    const char *path;
+    char *value;
+    size_t size;
+    bool found;
+} JsonExtract;
+
+// Function to stop at the value with the wanted path
+static bool json_extract_callback(FlipperHTTPJsonEvent event, const char *path, const char *value, size_t value_len, void *context)
+{
+    JsonExtract *extract = (JsonExtract *)context;
+    if (strcmp(path, extract->path) != 0)
+    {
+        return true;
+    }
+    if (event == JSON_EVENT_OBJECT_START || event == JSON_EVENT_ARRAY_START)
+    {
+        return false; // not a single value
+    }
+    size_t copy_len = MIN(value_len, extract->size - 1);
+    memcpy(extract->value, value, copy_len);
+    extract->value[copy_len] = '\0';
+    extract->found = true;
+    return false;
+}
+
+/**
+ * @brief      Extract a value from JSON data by its path.
+ * @return     true if the path names a string, number, true, false or null, false otherwise.
+ * @param      json_data The JSON data.
+ * @param      path      The path of the value, for example "data.items[2].name".
+ * @param      value     The buffer for the value (strings without quotes, cut to fit).
+ * @param      size      The size of the buffer.
+ */
+bool flipper_http_json_extract(const char *json_data, const char *path, char *value, size_t size)
+{
+    if (!json_data || !path || !value || size == 0)
+    {
+        FURI_LOG_E(HTTP_TAG, "Invalid arguments provided to flipper_http_json_extract.");
+        return false;
+    }
+    JsonExtract extract = {path, value, size, false};
+    FlipperHTTPJson json;
+    flipper_http_json_init(&json, json_extract_callback, &extract);
+    if (flipper_http_json_feed(&json, json_data, strlen(json_data)))
+    {
+        flipper_http_json_finish(&json); // ends a top-level number
+    }
+    return extract.found;
+}
 
-    // Clean up
-    storage_file_close(file);
-    storage_file_free(file);
-    furi_record_close(RECORD_STORAGE);
-    free(buffer);
-    return str_result;
+/**
+ * @brief      Extract a value from a JSON file by its path, without loading the file.
+ * @return     true if the path names a string, number, true, false or null, false otherwise.
+ * @param      file_path The path to the JSON file, for example a saved response.
+ * @param      path      The path of the value, for example "data.items[2].name".
+ * @param      value     The buffer for the value (strings without quotes, cut to fit).
+ * @param      size      The size of the buffer.
+ * @note       Parsing stops at the value, so values near the start of large files are found quickly.
+ */
+bool flipper_http_json_extract_from_file(const char *file_path, const char *path, char *value, size_t size)
+{
+    if (!file_path || !path || !value || size == 0)
+    {
+        FURI_LOG_E(HTTP_TAG, "Invalid arguments provided to flipper_http_json_extract_from_file.");
+        return false;
+    }
+    JsonExtract extract = {path, value, size, false};
+    FlipperHTTPJson json;
+    flipper_http_json_init(&json, json_extract_callback, &extract);
+    flipper_http_json_parse_file(&json, file_path);
+    return extract.found;
 }
 
 /**
@@ -745,213 +1673,650 @@ void flipper_http_loading_task(FlipperHTTP *fhttp,
  * @param      json_data The JSON data to parse.
  * @note       The received data will be handled asynchronously via the callback.
  */
-bool flipper_http_parse_json(FlipperHTTP *fhttp, const char *key, const char *json_data)
+bool flipper_http_parse_json(FlipperHTTP *fhttp, const char *key, const char *json_data)
+{
+    if (!fhttp)
+    {
+        FURI_LOG_E(HTTP_TAG, "Failed to get context.");
+        return false;
+    }
+    if (!key || !json_data)
+    {
+        FURI_LOG_E("FlipperHTTP", "Invalid arguments provided to flipper_http_parse_json.");
+        return false;
+    }
+
+    FlipperHTTPCommandWriter writer;
+    if (!flipper_http_command_begin(fhttp, &writer, "[PARSE]{\"key\":"))
+    {
+        return false;
+    }
+    flipper_http_command_write_string(&writer, key);
+    flipper_http_command_write(&writer, ",\"json\":");
+    flipper_http_command_write_json(&writer, json_data);
+    flipper_http_command_write(&writer, "}");
+    flipper_http_command_end(&writer);
+    return true;
+}
+
+/**
+ * @brief      Parse JSON array data.
+ * @return     true if the JSON array data was parsed successfully, false otherwise.
+ * @param      fhttp The FlipperHTTP context
+ * @param      key       The key to parse from the JSON array data.
+ * @param      index     The index to parse from the JSON array data.
+ * @param      json_data The JSON array data to parse.
+ * @note       The received data will be handled asynchronously via the callback.
+ */
+bool flipper_http_parse_json_array(FlipperHTTP *fhttp, const char *key, int index, const char *json_data)
+{
+    if (!fhttp)
+    {
+        FURI_LOG_E(HTTP_TAG, "Failed to get context.");
+        return false;
+    }
+    if (!key || !json_data)
+    {
+        FURI_LOG_E("FlipperHTTP", "Invalid arguments provided to flipper_http_parse_json_array.");
+        return false;
+    }
+
+    FlipperHTTPCommandWriter writer;
+    if (!flipper_http_command_begin(fhttp, &writer, "[PARSE/ARRAY]{\"key\":"))
+    {
+        return false;
+    }
+    char number[32];
+    snprintf(number, sizeof(number), ",\"index\":%d,\"json\":", index);
+    flipper_http_command_write_string(&writer, key);
+    flipper_http_command_write(&writer, number);
+    flipper_http_command_write_json(&writer, json_data);
+    flipper_http_command_write(&writer, "}");
+    flipper_http_command_end(&writer);
+    return true;
+}
+
+/**
+ * @brief Process requests and parse JSON data asynchronously
+ * @param fhttp The FlipperHTTP context
+ * @param http_request The function to send the request
+ * @param parse_json The function to parse the JSON
+ * @return true if successful, false otherwise
+ */
+bool flipper_http_process_response_async(FlipperHTTP *fhttp, bool (*http_request)(void), bool (*parse_json)(void))
+{
+    if (!fhttp)
+    {
+        FURI_LOG_E(HTTP_TAG, "Failed to get context.");
+        return false;
+    }
+    if (http_request()) // start the async request, flipper_http_request starts its timeouts
+    {
+        fhttp->state = RECEIVING;
+    }
+    else
+    {
+        FURI_LOG_E(HTTP_TAG, "Failed to send request");
+        return false;
+    }
+    while (fhttp->state == RECEIVING && flipper_http_timeout_running(fhttp))
+    {
+        // Wait for the request to be received
+        furi_delay_ms(100);
+    }
+    flipper_http_timeout_stop(fhttp);
+    if (!parse_json()) // parse the JSON before switching to the view (synchonous)
+    {
+        FURI_LOG_E(HTTP_TAG, "Failed to parse the JSON...");
+        return false;
+    }
+    return true;
+}
+
+// Function to send a request with its timeouts, zero fields taken from fhttp->timeouts
+static bool flipper_http_send_request(FlipperHTTP *fhttp, HTTPMethod method, const char *url, const char *headers, const char *payload, const FlipperHTTPTimeouts *timeouts)
+{
+    if (!fhttp)
+    {
+        FURI_LOG_E("FlipperHTTP", "Failed to get context.");
+        return false;
+    }
+    if (!url)
+    {
+        FURI_LOG_E("FlipperHTTP", "Invalid arguments provided to flipper_http_request.");
+        return false;
+    }
+
+    // Command prefix, the JSON after it is written in pieces with the URL escaped
+    const char *prefix = NULL;
+    bool has_payload = true;
+
+    switch (method)
+    {
+    case GET:
+        prefix = "[GET/HTTP]";
+        has_payload = false;
+        break;
+    case POST:
+        prefix = "[POST/HTTP]";
+        break;
+    case PUT:
+        prefix = "[PUT/HTTP]";
+        break;
+    case DELETE:
+        prefix = "[DELETE/HTTP]";
+        break;
+    case BYTES:
+        prefix = "[GET/BYTES]";
+        has_payload = false;
+        break;
+    case BYTES_POST:
+        prefix = "[POST/BYTES]";
+        break;
+    }
+    if (!prefix || (method != GET && !headers) || (has_payload && !payload))
+    {
+        FURI_LOG_E("FlipperHTTP", "Invalid arguments provided to flipper_http_request.");
+        return false;
+    }
+    if (method == BYTES || method == BYTES_POST)
+    {
+        if (strlen(fhttp->file_path) == 0)
+        {
+            FURI_LOG_E("FlipperHTTP", "File path is not set.");
+            return false;
+        }
+        fhttp->save_received_data = false;
+        fhttp->is_bytes_request = true;
+    }
+
+    // set method
+    fhttp->method = method;
+
+    // set the timeouts of this request
+    fhttp->active_timeouts.first_byte_ms = timeouts->first_byte_ms ? timeouts->first_byte_ms : fhttp->timeouts.first_byte_ms;
+    fhttp->active_timeouts.idle_ms = timeouts->idle_ms ? timeouts->idle_ms : fhttp->timeouts.idle_ms;
+    fhttp->active_timeouts.total_ms = timeouts->total_ms ? timeouts->total_ms : fhttp->timeouts.total_ms;
+
+    // Armed before the command is written, so they already run when the first byte of the answer comes back
+    flipper_http_timeout_start(fhttp);
+
+    // Send request via UART
+    FlipperHTTPCommandWriter writer;
+    uint32_t unanswered_command = fhttp->unanswered_command;
+    if (method == GET && (!headers || strlen(headers) == 0))
+    {
+        if (!flipper_http_command_begin(fhttp, &writer, "[GET]"))
+        {
+            flipper_http_timeout_stop(fhttp);
+            return false;
+        }
+        flipper_http_command_write(&writer, url);
+        flipper_http_command_end(&writer);
+        fhttp->request_command = fhttp->commands_sent;
+        fhttp->unanswered_command = unanswered_command;
+        return true;
+    }
+
+    if (!flipper_http_command_begin(fhttp, &writer, prefix))
+    {
+        flipper_http_timeout_stop(fhttp);
+        return false;
+    }
+    fhttp->request_command = fhttp->commands_sent;
+    fhttp->unanswered_command = unanswered_command;
+    flipper_http_command_write(&writer, "{\"url\":");
+    flipper_http_command_write_string(&writer, url);
+    flipper_http_command_write(&writer, ",\"headers\":");
+    flipper_http_command_write_json(&writer, headers);
+    if ((method == BYTES || method == BYTES_POST) && fhttp->active_timeouts.idle_ms != TIMEOUT_DURATION_TICKS)
+    {
+        // The board gives up on a silent server a little before the Flipper gives up on the board
+        uint32_t idle_ms = fhttp->active_timeouts.idle_ms;
+        char number[32];
+        snprintf(number, sizeof(number), ",\"timeout\":%lu", idle_ms > 2 * BOARD_TIMEOUT_MARGIN_MS ? idle_ms - BOARD_TIMEOUT_MARGIN_MS : idle_ms / 2);
+        flipper_http_command_write(&writer, number);
+    }
+    if (has_payload)
+    {
+        flipper_http_command_write(&writer, ",\"payload\":");
+        flipper_http_command_write_json(&writer, payload);
+    }
+    flipper_http_command_write(&writer, "}");
+    flipper_http_command_end(&writer);
+    return true;
+}
+
+/**
+ * @brief      Send a request to the specified URL.
+ * @return     true if the request was successful, false otherwise.
+ * @param      fhttp The FlipperHTTP context
+ * @param      method The HTTP method to use.
+ * @param      url  The URL to send the request to.
+ * @param      headers  The headers to send with the request.
+ * @param      payload  The data to send with the request.
+ * @note       The received data will be handled asynchronously via the callback.
+ *             The request's timeouts start before it is written (see flipper_http_timeout_running).
+ */
+bool flipper_http_request(FlipperHTTP *fhttp, HTTPMethod method, const char *url, const char *headers, const char *payload)
+{
+    if (!fhttp)
+    {
+        FURI_LOG_E("FlipperHTTP", "Failed to get context.");
+        return false;
+    }
+    return flipper_http_send_request(fhttp, method, url, headers, payload, &fhttp->timeouts);
+}
+
+// Function to get the submitted request the board is answering, NULL if none
+static FlipperHTTPQueuedRequest *flipper_http_active_request(FlipperHTTP *fhttp)
+{
+    if (fhttp->queue_count == 0 || !fhttp->queue[fhttp->queue_head].sent)
+    {
+        return NULL;
+    }
+    return &fhttp->queue[fhttp->queue_head];
+}
+
+// Function to free the strings of a queued request and clear its slot
+static void flipper_http_queue_release(FlipperHTTPQueuedRequest *queued)
+{
+    free((void *)queued->request.url);
+    free((void *)queued->request.headers);
+    free((void *)queued->request.payload);
+    free((void *)queued->request.file_path);
+    memset(queued, 0, sizeof(FlipperHTTPQueuedRequest));
+}
+
+// Function to drop the oldest request from the queue into finished, which the caller reports once queue_mutex is released
+static void flipper_http_queue_finish(FlipperHTTP *fhttp, FlipperHTTPQueuedRequest *finished)
+{
+    *finished = fhttp->queue[fhttp->queue_head];
+    memset(&fhttp->queue[fhttp->queue_head], 0, sizeof(FlipperHTTPQueuedRequest));
+    fhttp->queue_head = (fhttp->queue_head + 1) % REQUEST_QUEUE_SIZE;
+    fhttp->queue_count--;
+    flipper_http_timeout_stop(fhttp);
+}
+
+// Function to report the result of a request taken out of the queue and free it (without queue_mutex, so the callback may use the API)
+static void flipper_http_queue_report(FlipperHTTPQueuedRequest *finished, bool success, int status_code)
+{
+    if (finished->request.on_complete)
+    {
+        finished->request.on_complete(finished->id, success, status_code, finished->request.context);
+    }
+    flipper_http_queue_release(finished);
+}
+
+// Function to send the oldest submitted request if the board is free, returns true if it could not be sent and was moved to failed
+static bool flipper_http_queue_send_next(FlipperHTTP *fhttp, FlipperHTTPQueuedRequest *failed)
+{
+    if (fhttp->queue_count == 0 || fhttp->queue[fhttp->queue_head].sent || fhttp->started_receiving)
+    {
+        return false;
+    }
+    FlipperHTTPQueuedRequest *queued = &fhttp->queue[fhttp->queue_head];
+    const FlipperHTTPRequest *request = &queued->request;
+
+    snprintf(fhttp->file_path, sizeof(fhttp->file_path), "%s", request->file_path ? request->file_path : "");
+    fhttp->save_received_data = request->file_path != NULL; // bytes requests switch this off again
+    fhttp->is_bytes_request = false;
+    fhttp->status_code = 0;
+
+    // An [ERROR] line is only this request's if the board has nothing else left to answer
+    bool owns_errors = fhttp->unanswered_command == 0;
+
+    // Marked first, the worker may see the response before flipper_http_request returns
+    queued->sent = true;
+    if (flipper_http_send_request(
+            fhttp,
+            request->method,
+            request->url,
+            request->method == GET ? request->headers : (request->headers ? request->headers : "{}"),
+            request->payload ? request->payload : "{}",
+            &request->timeouts))
+    {
+        queued->owns_errors = owns_errors;
+        return false;
+    }
+    FURI_LOG_E(HTTP_TAG, "Failed to send request %lu.", queued->id);
+    flipper_http_queue_finish(fhttp, failed);
+    return true;
+}
+
+// Function to send the submitted requests waiting for the board, failing the ones that cannot be sent
+static void flipper_http_queue_advance(FlipperHTTP *fhttp)
+{
+    FlipperHTTPQueuedRequest failed;
+    while (true)
+    {
+        furi_mutex_acquire(fhttp->queue_mutex, FuriWaitForever);
+        bool sent_failed = flipper_http_queue_send_next(fhttp, &failed);
+        furi_mutex_release(fhttp->queue_mutex);
+        if (!sent_failed)
+        {
+            return;
+        }
+        flipper_http_queue_report(&failed, false, 0);
+    }
+}
+
+// Function to end the submitted request the board was answering and send the next one
+static void flipper_http_queue_complete(FlipperHTTP *fhttp, bool success)
+{
+    if (!fhttp->queue_mutex)
+    {
+        return;
+    }
+    FlipperHTTPQueuedRequest finished;
+    int status_code = fhttp->status_code;
+    furi_mutex_acquire(fhttp->queue_mutex, FuriWaitForever);
+    bool ended = flipper_http_active_request(fhttp) != NULL;
+    if (ended)
+    {
+        flipper_http_queue_finish(fhttp, &finished);
+    }
+    furi_mutex_release(fhttp->queue_mutex);
+
+    // Reported before the next request is sent
+    if (ended)
+    {
+        flipper_http_queue_report(&finished, success, status_code);
+    }
+    flipper_http_queue_advance(fhttp);
+}
+
+// Function to fail the submitted request on an [ERROR] line, unless the line may be about another command
+// (a WebSocket message, [PARSE] and the like); such a request ends with its own response or timeout
+static void flipper_http_queue_error(FlipperHTTP *fhttp)
+{
+    if (!fhttp->queue_mutex)
+    {
+        return;
+    }
+    furi_mutex_acquire(fhttp->queue_mutex, FuriWaitForever);
+    FlipperHTTPQueuedRequest *active = flipper_http_active_request(fhttp);
+    bool owns_error = active && active->owns_errors;
+    furi_mutex_release(fhttp->queue_mutex);
+
+    // Only the worker ends a request that was sent, so it is still the active one
+    if (owns_error)
+    {
+        flipper_http_queue_complete(fhttp, false);
+    }
+}
+
+// Function to pass a piece of the body to the callbacks of the submitted request being answered
+static void flipper_http_queue_body(FlipperHTTP *fhttp, const uint8_t *data, size_t len)
+{
+    if (!fhttp->queue_mutex)
+    {
+        return;
+    }
+    uint32_t request_id = 0;
+    FlipperHTTPChunkCallback on_chunk = NULL;
+    void *context = NULL;
+    furi_mutex_acquire(fhttp->queue_mutex, FuriWaitForever);
+    FlipperHTTPQueuedRequest *active = flipper_http_active_request(fhttp);
+    if (active)
+    {
+        request_id = active->id;
+        on_chunk = active->request.on_chunk;
+        context = active->request.context;
+    }
+    furi_mutex_release(fhttp->queue_mutex);
+    if (on_chunk)
+    {
+        on_chunk(request_id, data, len, context);
+    }
+}
+
+// Function to get the time left until the first timeout of the last request runs out, 0 if one has
+static uint32_t flipper_http_timeout_remaining(FlipperHTTP *fhttp, const char **reason)
+{
+    const FlipperHTTPTimeouts *timeouts = &fhttp->active_timeouts;
+    uint32_t now = furi_get_tick(); // one tick is one millisecond
+    uint32_t since, limit;
+    if (fhttp->first_byte_received)
+    {
+        since = now - fhttp->last_rx_tick;
+        limit = timeouts->idle_ms;
+        *reason = "Idle timeout reached";
+    }
+    else
+    {
+        since = now - fhttp->request_tick;
+        limit = timeouts->first_byte_ms;
+        *reason = "No answer from the board";
+    }
+    uint32_t remaining = since < limit ? limit - since : 0;
+
+    if (timeouts->total_ms > 0)
+    {
+        since = now - fhttp->request_tick;
+        uint32_t total_remaining = since < timeouts->total_ms ? timeouts->total_ms - since : 0;
+        if (total_remaining < remaining)
+        {
+            remaining = total_remaining;
+            *reason = "Request deadline reached";
+        }
+    }
+    return remaining;
+}
+
+/**
+ * @brief      Set the default timeouts of requests.
+ * @return     void
+ * @param      fhttp    The FlipperHTTP context
+ * @param      timeouts The timeouts; zero first-byte and idle timeouts mean TIMEOUT_DURATION_TICKS, a zero total means no deadline.
+ * @note       An idle timeout other than TIMEOUT_DURATION_TICKS is also sent to the board for [GET/BYTES] and [POST/BYTES].
+ */
+void flipper_http_set_timeouts(FlipperHTTP *fhttp, const FlipperHTTPTimeouts *timeouts)
 {
     if (!fhttp)
     {
         FURI_LOG_E(HTTP_TAG, "Failed to get context.");
-        return false;
+        return;
     }
-    if (!key || !json_data)
+    if (!timeouts)
     {
-        FURI_LOG_E("FlipperHTTP", "Invalid arguments provided to flipper_http_parse_json.");
-        return false;
+        FURI_LOG_E(HTTP_TAG, "Invalid arguments provided to flipper_http_set_timeouts.");
+        return;
     }
+    fhttp->timeouts.first_byte_ms = timeouts->first_byte_ms ? timeouts->first_byte_ms : TIMEOUT_DURATION_TICKS;
+    fhttp->timeouts.idle_ms = timeouts->idle_ms ? timeouts->idle_ms : TIMEOUT_DURATION_TICKS;
+    fhttp->timeouts.total_ms = timeouts->total_ms;
+}
 
-    char buffer[512];
-    int ret =
-        snprintf(buffer, sizeof(buffer), "[PARSE]{\"key\":\"%s\",\"json\":%s}", key, json_data);
-
-    if (ret < 0 || ret >= (int)sizeof(buffer))
+/**
+ * @brief      Start the timeouts of the last request again, from now.
+ * @return     void
+ * @param      fhttp The FlipperHTTP context
+ * @note       flipper_http_request and flipper_http_submit start them before the request is written, so this is not needed after them.
+ *             When one runs out, fhttp->state becomes ISSUE. Received bytes, not lines, keep the idle timeout from running out.
+ */
+void flipper_http_timeout_start(FlipperHTTP *fhttp)
+{
+    if (!fhttp)
     {
-        FURI_LOG_E("FlipperHTTP", "Failed to format JSON parse command.");
-        return false;
+        FURI_LOG_E(HTTP_TAG, "Failed to get context.");
+        return;
     }
+    fhttp->request_tick = furi_get_tick();
+    fhttp->last_rx_tick = fhttp->request_tick;
+    fhttp->first_byte_received = false;
+    fhttp->timeout_armed = true;
 
-    return flipper_http_send_data(fhttp, buffer);
+    // The timer only wakes the worker at the nearest deadline, it is not restarted for every byte
+    const char *reason;
+    furi_timer_start(fhttp->get_timeout_timer, flipper_http_timeout_remaining(fhttp, &reason));
 }
 
 /**
- * @brief      Parse JSON array data.
- * @return     true if the JSON array data was parsed successfully, false otherwise.
+ * @brief      Stop the timeouts of the last request.
+ * @return     void
  * @param      fhttp The FlipperHTTP context
- * @param      key       The key to parse from the JSON array data.
- * @param      index     The index to parse from the JSON array data.
- * @param      json_data The JSON array data to parse.
- * @note       The received data will be handled asynchronously via the callback.
  */
-bool flipper_http_parse_json_array(FlipperHTTP *fhttp, const char *key, int index, const char *json_data)
+void flipper_http_timeout_stop(FlipperHTTP *fhttp)
 {
     if (!fhttp)
     {
         FURI_LOG_E(HTTP_TAG, "Failed to get context.");
-        return false;
+        return;
     }
-    if (!key || !json_data)
+    fhttp->timeout_armed = false;
+    furi_timer_stop(fhttp->get_timeout_timer);
+}
+
+/**
+ * @brief      Check if the timeouts of the last request are still running.
+ * @return     true until the response ends, a timeout runs out or flipper_http_timeout_stop is called.
+ * @param      fhttp The FlipperHTTP context
+ */
+bool flipper_http_timeout_running(FlipperHTTP *fhttp)
+{
+    if (!fhttp)
     {
-        FURI_LOG_E("FlipperHTTP", "Invalid arguments provided to flipper_http_parse_json_array.");
+        FURI_LOG_E(HTTP_TAG, "Failed to get context.");
         return false;
     }
+    return fhttp->timeout_armed;
+}
 
-    char buffer[512];
-    int ret = snprintf(
-        buffer,
-        sizeof(buffer),
-        "[PARSE/ARRAY]{\"key\":\"%s\",\"index\":%d,\"json\":%s}",
-        key,
-        index,
-        json_data);
-
-    if (ret < 0 || ret >= (int)sizeof(buffer))
+/**
+ * @brief      Set a callback for the progress of every response (request_id is 0 unless it was submitted).
+ * @return     void
+ * @param      fhttp    The FlipperHTTP context
+ * @param      callback The callback, NULL to remove it. It is called at most every PROGRESS_INTERVAL_MS
+ *                      while a response is received, and once more when it ends.
+ * @param      context  The context for the callback.
+ * @note       fhttp->transfer_stats holds the measurements of the last response that ended.
+ */
+void flipper_http_set_progress_callback(FlipperHTTP *fhttp, FlipperHTTPProgressCallback callback, void *context)
+{
+    if (!fhttp)
     {
-        FURI_LOG_E("FlipperHTTP", "Failed to format JSON parse array command.");
-        return false;
+        FURI_LOG_E(HTTP_TAG, "Failed to get context.");
+        return;
     }
-
-    return flipper_http_send_data(fhttp, buffer);
+    fhttp->progress_context = context;
+    fhttp->progress_cb = callback;
 }
 
 /**
- * @brief Process requests and parse JSON data asynchronously
- * @param fhttp The FlipperHTTP context
- * @param http_request The function to send the request
- * @param parse_json The function to parse the JSON
- * @return true if successful, false otherwise
+ * @brief      Queue a request and return at once; its callbacks report the body, progress and result.
+ * @return     The handle of the request, 0 if it could not be queued.
+ * @param      fhttp   The FlipperHTTP context
+ * @param      request The request (its strings are copied).
+ * @note       Requests are sent to the board one after another, each once the previous one ended.
+ *             Do not call flipper_http_request while submitted requests are pending.
+ *             An [ERROR] line fails the request being answered only if no other command was waiting for an
+ *             answer when it was sent, or was sent after it; otherwise its response or a timeout ends it.
  */
-bool flipper_http_process_response_async(FlipperHTTP *fhttp, bool (*http_request)(void), bool (*parse_json)(void))
+uint32_t flipper_http_submit(FlipperHTTP *fhttp, const FlipperHTTPRequest *request)
 {
-    if (!fhttp)
+    if (!fhttp || !fhttp->queue_mutex)
     {
         FURI_LOG_E(HTTP_TAG, "Failed to get context.");
-        return false;
+        return 0;
     }
-    if (http_request()) // start the async request
+    if (!request || !request->url)
     {
-        furi_timer_start(fhttp->get_timeout_timer, TIMEOUT_DURATION_TICKS);
-        fhttp->state = RECEIVING;
+        FURI_LOG_E(HTTP_TAG, "Invalid arguments provided to flipper_http_submit.");
+        return 0;
     }
-    else
+    if ((request->method == BYTES || request->method == BYTES_POST) && !request->file_path)
     {
-        FURI_LOG_E(HTTP_TAG, "Failed to send request");
-        return false;
+        FURI_LOG_E(HTTP_TAG, "File path is not set.");
+        return 0;
     }
-    while (fhttp->state == RECEIVING && furi_timer_is_running(fhttp->get_timeout_timer) > 0)
+
+    furi_mutex_acquire(fhttp->queue_mutex, FuriWaitForever);
+    if (fhttp->queue_count == REQUEST_QUEUE_SIZE)
     {
-        // Wait for the request to be received
-        furi_delay_ms(100);
+        FURI_LOG_E(HTTP_TAG, "Request queue is full.");
+        furi_mutex_release(fhttp->queue_mutex);
+        return 0;
     }
-    furi_timer_stop(fhttp->get_timeout_timer);
-    if (!parse_json()) // parse the JSON before switching to the view (synchonous)
+    FlipperHTTPQueuedRequest *queued = &fhttp->queue[(fhttp->queue_head + fhttp->queue_count) % REQUEST_QUEUE_SIZE];
+    queued->request = *request;
+    queued->request.url = strdup(request->url);
+    queued->request.headers = request->headers ? strdup(request->headers) : NULL;
+    queued->request.payload = request->payload ? strdup(request->payload) : NULL;
+    queued->request.file_path = request->file_path ? strdup(request->file_path) : NULL;
+    if (!queued->request.url ||
+        (request->headers && !queued->request.headers) ||
+        (request->payload && !queued->request.payload) ||
+        (request->file_path && !queued->request.file_path))
     {
-        FURI_LOG_E(HTTP_TAG, "Failed to parse the JSON...");
-        return false;
+        FURI_LOG_E(HTTP_TAG, "Failed to allocate memory for the request.");
+        flipper_http_queue_release(queued);
+        furi_mutex_release(fhttp->queue_mutex);
+        return 0;
     }
-    return true;
+
+    // 0 is never a handle
+    if (++fhttp->next_request_id == 0)
+    {
+        fhttp->next_request_id = 1;
+    }
+    queued->id = fhttp->next_request_id;
+    queued->sent = false;
+    queued->owns_errors = false;
+    fhttp->queue_count++;
+
+    uint32_t request_id = queued->id;
+    furi_mutex_release(fhttp->queue_mutex);
+    flipper_http_queue_advance(fhttp); // right away if the board is free
+    return request_id;
 }
 
 /**
- * @brief      Send a request to the specified URL.
- * @return     true if the request was successful, false otherwise.
- * @param      fhttp The FlipperHTTP context
- * @param      method The HTTP method to use.
- * @param      url  The URL to send the request to.
- * @param      headers  The headers to send with the request.
- * @param      payload  The data to send with the request.
- * @note       The received data will be handled asynchronously via the callback.
+ * @brief      Cancel a submitted request. A queued request is dropped; for one the board is
+ *             already answering, only its callbacks are dropped.
+ * @return     true if the request was found, false otherwise.
+ * @param      fhttp      The FlipperHTTP context
+ * @param      request_id The handle returned by flipper_http_submit.
  */
-bool flipper_http_request(FlipperHTTP *fhttp, HTTPMethod method, const char *url, const char *headers, const char *payload)
+bool flipper_http_cancel(FlipperHTTP *fhttp, uint32_t request_id)
 {
-    if (!fhttp)
-    {
-        FURI_LOG_E("FlipperHTTP", "Failed to get context.");
-        return false;
-    }
-    if (!url)
+    if (!fhttp || !fhttp->queue_mutex)
     {
-        FURI_LOG_E("FlipperHTTP", "Invalid arguments provided to flipper_http_request.");
+        FURI_LOG_E(HTTP_TAG, "Failed to get context.");
         return false;
     }
-
-    // Prepare request command
-    char command[512];
-    int ret = 0;
-
-    switch (method)
+    furi_mutex_acquire(fhttp->queue_mutex, FuriWaitForever);
+    for (size_t i = 0; i < fhttp->queue_count; i++)
     {
-    case GET:
-        if (headers && strlen(headers) > 0)
-            ret = snprintf(command, sizeof(command), "[GET/HTTP]{\"url\":\"%s\",\"headers\":%s}", url, headers);
-        else
-            ret = snprintf(command, sizeof(command), "[GET]%s", url);
-        break;
-    case POST:
-        if (!headers || !payload)
-        {
-            FURI_LOG_E("FlipperHTTP", "Invalid arguments provided to flipper_http_request.");
-            return false;
-        }
-        ret = snprintf(command, sizeof(command), "[POST/HTTP]{\"url\":\"%s\",\"headers\":%s,\"payload\":%s}", url, headers, payload);
-        break;
-    case PUT:
-        if (!headers || !payload)
-        {
-            FURI_LOG_E("FlipperHTTP", "Invalid arguments provided to flipper_http_request.");
-            return false;
-        }
-        ret = snprintf(command, sizeof(command), "[PUT/HTTP]{\"url\":\"%s\",\"headers\":%s,\"payload\":%s}", url, headers, payload);
-        break;
-    case DELETE:
-        if (!headers || !payload)
-        {
-            FURI_LOG_E("FlipperHTTP", "Invalid arguments provided to flipper_http_request.");
-            return false;
-        }
-        ret = snprintf(command, sizeof(command), "[DELETE/HTTP]{\"url\":\"%s\",\"headers\":%s,\"payload\":%s}", url, headers, payload);
-        break;
-    case BYTES:
-        if (!headers)
-        {
-            FURI_LOG_E("FlipperHTTP", "Invalid arguments provided to flipper_http_request.");
-            return false;
-        }
-        if (strlen(fhttp->file_path) == 0)
+        FlipperHTTPQueuedRequest *queued = &fhttp->queue[(fhttp->queue_head + i) % REQUEST_QUEUE_SIZE];
+        if (queued->id != request_id)
         {
-            FURI_LOG_E("FlipperHTTP", "File path is not set.");
-            return false;
+            continue;
         }
-        fhttp->save_received_data = false;
-        fhttp->is_bytes_request = true;
-        ret = snprintf(command, sizeof(command), "[GET/BYTES]{\"url\":\"%s\",\"headers\":%s}", url, headers);
-        break;
-    case BYTES_POST:
-        if (!headers || !payload)
+        if (queued->sent)
         {
-            FURI_LOG_E("FlipperHTTP", "Invalid arguments provided to flipper_http_request.");
-            return false;
+            // The response still has to be received, the queue moves on once it ends
+            queued->request.on_chunk = NULL;
+            queued->request.on_progress = NULL;
+            queued->request.on_complete = NULL;
         }
-        if (strlen(fhttp->file_path) == 0)
+        else
         {
-            FURI_LOG_E("FlipperHTTP", "File path is not set.");
-            return false;
+            flipper_http_queue_release(queued);
+            // Close the gap, keeping the order of the requests behind it
+            for (size_t j = i; j + 1 < fhttp->queue_count; j++)
+            {
+                fhttp->queue[(fhttp->queue_head + j) % REQUEST_QUEUE_SIZE] =
+                    fhttp->queue[(fhttp->queue_head + j + 1) % REQUEST_QUEUE_SIZE];
+            }
+            memset(&fhttp->queue[(fhttp->queue_head + fhttp->queue_count - 1) % REQUEST_QUEUE_SIZE], 0, sizeof(FlipperHTTPQueuedRequest));
+            fhttp->queue_count--;
         }
-        fhttp->save_received_data = false;
-        fhttp->is_bytes_request = true;
-        ret = snprintf(command, sizeof(command), "[POST/BYTES]{\"url\":\"%s\",\"headers\":%s,\"payload\":%s}", url, headers, payload);
-        break;
+        furi_mutex_release(fhttp->queue_mutex);
+        return true;
     }
-
-    // check if ret is valid
-    if (ret < 0 || ret >= (int)sizeof(command))
-    {
-        FURI_LOG_E("FlipperHTTP", "Failed to format request command.");
-        return false;
-    }
-
-    // set method
-    fhttp->method = method;
-
-    // Send request via UART
-    return flipper_http_send_data(fhttp, command);
+    furi_mutex_release(fhttp->queue_mutex);
+    return false;
 }
 
 /**
@@ -973,18 +2338,17 @@ bool flipper_http_save_wifi(FlipperHTTP *fhttp, const char *ssid, const char *pa
         return false;
     }
 
-    char buffer[256];
-
-    int ret = snprintf(
-        buffer, sizeof(buffer), "[WIFI/SAVE]{\"ssid\":\"%s\",\"password\":\"%s\"}", ssid, password);
-
-    if (ret < 0 || ret >= (int)sizeof(buffer))
+    FlipperHTTPCommandWriter writer;
+    if (!flipper_http_command_begin(fhttp, &writer, "[WIFI/SAVE]{\"ssid\":"))
     {
-        FURI_LOG_E("FlipperHTTP", "Failed to format WiFi save command.");
         return false;
     }
-
-    return flipper_http_send_data(fhttp, buffer);
+    flipper_http_command_write_string(&writer, ssid);
+    flipper_http_command_write(&writer, ",\"password\":");
+    flipper_http_command_write_string(&writer, password);
+    flipper_http_command_write(&writer, "}");
+    flipper_http_command_end(&writer);
+    return true;
 }
 
 /**
@@ -1025,18 +2389,206 @@ bool flipper_http_send_command(FlipperHTTP *fhttp, HTTPCommand command)
         return flipper_http_send_data(fhttp, "[PING]");
     case HTTP_CMD_REBOOT:
         return flipper_http_send_data(fhttp, "[REBOOT]");
+    case HTTP_CMD_TIMING_ON:
+        return flipper_http_send_data(fhttp, "[TIMING/ON]");
+    case HTTP_CMD_TIMING_OFF:
+        return flipper_http_send_data(fhttp, "[TIMING/OFF]");
     default:
         FURI_LOG_E(HTTP_TAG, "Invalid command.");
         return false;
     }
 }
 
+/**
+ * @brief      Start a command written in pieces, for commands of any length.
+ * @return     true if the command can be sent, false otherwise.
+ * @param fhttp The FlipperHTTP context
+ * @param      writer The writer to start.
+ * @param      prefix The start of the command, for example "[POST/HTTP]".
+ * @note       Finish it with flipper_http_command_end, which adds the newline.
+ */
+bool flipper_http_command_begin(FlipperHTTP *fhttp, FlipperHTTPCommandWriter *writer, const char *prefix)
+{
+    if (!fhttp)
+    {
+        FURI_LOG_E(HTTP_TAG, "Failed to get context.");
+        return false;
+    }
+    if (!writer || !prefix)
+    {
+        FURI_LOG_E(HTTP_TAG, "Invalid arguments provided to flipper_http_command_begin.");
+        return false;
+    }
+
+    if (fhttp->state == INACTIVE && ((strstr(prefix, "[PING]") == NULL) &&
+                                     (strstr(prefix, "[WIFI/CONNECT]") == NULL)))
+    {
+        FURI_LOG_E("FlipperHTTP", "Cannot send data while INACTIVE.");
+        snprintf(fhttp->last_response, RX_BUF_SIZE, "Cannot send data while INACTIVE.");
+        return false;
+    }
+
+    // The board answers commands in order, so an [ERROR] line may now be about this command
+    // (flipper_http_send_request takes the mark back for requests, whose answers are framed)
+    FlipperHTTPQueuedRequest *active = flipper_http_active_request(fhttp);
+    if (active)
+    {
+        active->owns_errors = false;
+    }
+    fhttp->commands_sent++;
+    fhttp->unanswered_command = fhttp->commands_sent;
+
+    fhttp->state = SENDING;
+    writer->fhttp = fhttp;
+    writer->len = 0;
+    flipper_http_command_write(writer, prefix);
+    return true;
+}
+
+// Function to write what a command writer has collected to the UART
+static void command_writer_flush(FlipperHTTPCommandWriter *writer)
+{
+    if (writer->len > 0)
+    {
+        furi_hal_serial_tx(writer->fhttp->serial_handle, writer->buffer, writer->len);
+        writer->len = 0;
+    }
+}
+
+// Function to add one byte to a command
+static void command_writer_put(FlipperHTTPCommandWriter *writer, char c)
+{
+    if (writer->len == COMMAND_WRITER_BUFFER)
+    {
+        command_writer_flush(writer);
+    }
+    writer->buffer[writer->len++] = (uint8_t)c;
+}
+
+/**
+ * @brief      Add text to a command as it is.
+ * @return     void
+ * @param      writer The writer.
+ * @param      text   The text to add.
+ */
+void flipper_http_command_write(FlipperHTTPCommandWriter *writer, const char *text)
+{
+    if (!writer || !writer->fhttp || !text)
+    {
+        return;
+    }
+    size_t len = strlen(text);
+    while (len > 0)
+    {
+        if (writer->len == COMMAND_WRITER_BUFFER)
+        {
+            command_writer_flush(writer);
+        }
+        size_t n = MIN(len, (size_t)(COMMAND_WRITER_BUFFER - writer->len));
+        memcpy(&writer->buffer[writer->len], text, n);
+        writer->len += n;
+        text += n;
+        len -= n;
+    }
+}
+
+/**
+ * @brief      Add a string to a command as a quoted, escaped JSON string.
+ * @return     void
+ * @param      writer The writer.
+ * @param      value  The string to add.
+ */
+void flipper_http_command_write_string(FlipperHTTPCommandWriter *writer, const char *value)
+{
+    if (!writer || !writer->fhttp || !value)
+    {
+        return;
+    }
+    static const char hex[] = "0123456789abcdef";
+    command_writer_put(writer, '"');
+    for (; *value; value++)
+    {
+        uint8_t c = (uint8_t)*value;
+        if (c == '"' || c == '\\')
+        {
+            command_writer_put(writer, '\\');
+            command_writer_put(writer, (char)c);
+        }
+        else if (c == '\n')
+        {
+            command_writer_put(writer, '\\');
+            command_writer_put(writer, 'n');
+        }
+        else if (c == '\r')
+        {
+            command_writer_put(writer, '\\');
+            command_writer_put(writer, 'r');
+        }
+        else if (c == '\t')
+        {
+            command_writer_put(writer, '\\');
+            command_writer_put(writer, 't');
+        }
+        else if (c < 0x20)
+        {
+            // other control characters as \u00XX
+            flipper_http_command_write(writer, "\\u00");
+            command_writer_put(writer, hex[c >> 4]);
+            command_writer_put(writer, hex[c & 0x0F]);
+        }
+        else
+        {
+            command_writer_put(writer, (char)c); // UTF-8 passes through
+        }
+    }
+    command_writer_put(writer, '"');
+}
+
+/**
+ * @brief      Add JSON text (an object, array or value) to a command.
+ * @return     void
+ * @param      writer The writer.
+ * @param      json   The JSON to add; line breaks become spaces, since a newline ends the command.
+ */
+void flipper_http_command_write_json(FlipperHTTPCommandWriter *writer, const char *json)
+{
+    if (!writer || !writer->fhttp || !json)
+    {
+        return;
+    }
+    // Line breaks are only allowed between tokens in JSON, where a space means the same
+    for (; *json; json++)
+    {
+        command_writer_put(writer, (*json == '\n' || *json == '\r') ? ' ' : *json);
+    }
+}
+
+/**
+ * @brief      Finish a command: add the newline and send what is left.
+ * @return     void
+ * @param      writer The writer.
+ */
+void flipper_http_command_end(FlipperHTTPCommandWriter *writer)
+{
+    if (!writer || !writer->fhttp)
+    {
+        return;
+    }
+    command_writer_put(writer, '\n');
+    command_writer_flush(writer);
+
+    // FURI_LOG_I("FlipperHTTP", "Sent command over UART");
+    writer->fhttp->state = IDLE;
+    writer->fhttp = NULL;
+}
+
 /**
  * @brief      Send data over UART with newline termination.
  * @return     true if the data was sent successfully, false otherwise.
  * @param fhttp The FlipperHTTP context
  * @param      data  The data to send over UART.
  * @note       The data will be sent over UART with a newline character appended.
+ *             It is written in pieces, so its length is not limited.
  */
 bool flipper_http_send_data(FlipperHTTP *fhttp, const char *data)
 {
@@ -1045,154 +2597,247 @@ bool flipper_http_send_data(FlipperHTTP *fhttp, const char *data)
         FURI_LOG_E(HTTP_TAG, "Failed to get context.");
         return false;
     }
-
-    size_t data_length = strlen(data);
-    if (data_length == 0)
+    if (!data || strlen(data) == 0)
     {
         FURI_LOG_E("FlipperHTTP", "Attempted to send empty data.");
         return false;
     }
 
-    // Create a buffer with data + '\n'
-    size_t send_length = data_length + 1; // +1 for '\n'
-    if (send_length > 512)
-    { // Ensure buffer size is sufficient
-        FURI_LOG_E("FlipperHTTP", "Data too long to send over FHTTP->");
-        return false;
-    }
-
-    char send_buffer[513]; // 512 + 1 for safety
-    strncpy(send_buffer, data, 512);
-    send_buffer[data_length] = '\n';     // Append newline
-    send_buffer[data_length + 1] = '\0'; // Null-terminate
-
-    if (fhttp->state == INACTIVE && ((strstr(send_buffer, "[PING]") == NULL) &&
-                                     (strstr(send_buffer, "[WIFI/CONNECT]") == NULL)))
+    FlipperHTTPCommandWriter writer;
+    if (!flipper_http_command_begin(fhttp, &writer, data))
     {
-        FURI_LOG_E("FlipperHTTP", "Cannot send data while INACTIVE.");
-        fhttp->last_response = "Cannot send data while INACTIVE.";
         return false;
     }
-
-    fhttp->state = SENDING;
-    furi_hal_serial_tx(fhttp->serial_handle, (const uint8_t *)send_buffer, send_length);
-
-    // FURI_LOG_I("FlipperHTTP", "Sent data over UART: %s", send_buffer);
-    fhttp->state = IDLE;
+    flipper_http_command_end(&writer);
     return true;
 }
 
-// Function to set content length and status code
+// Function to read one phase from the "Timing" object of a SUCCESS line
+static uint32_t get_timing(const char *timing, const char *key)
+{
+    const char *value = strstr(timing, key);
+    if (!value)
+    {
+        return 0;
+    }
+    return strtoul(value + strlen(key), NULL, 10);
+}
+
+// Function to set content length, status code and timings
 static void set_header(FlipperHTTP *fhttp)
 {
     // example response: [GET/SUCCESS]{"Status-Code":200,"Content-Length":12528}
+    // with [TIMING/ON]: [GET/SUCCESS]{"Status-Code":200,"Content-Length":12528,"Timing":{"dns":0,"connect":0,"tls":311200,"ttfb":95000,"transfer":0}}
     if (!fhttp)
     {
         FURI_LOG_E(HTTP_TAG, "Invalid arguments provided to set_header.");
         return;
     }
 
-    size_t error_size = -1;
-
     // reset values
     fhttp->content_length = 0;
     fhttp->status_code = 0;
     fhttp->bytes_received = 0;
+    fhttp->timing_dns_us = 0;
+    fhttp->timing_connect_us = 0;
+    fhttp->timing_tls_us = 0;
+    fhttp->timing_ttfb_us = 0;
+    fhttp->timing_transfer_us = 0;
 
-    FuriString *furi_string = furi_string_alloc_set_str(fhttp->last_response);
-    if (!furi_string)
-    {
-        FURI_LOG_E(HTTP_TAG, "Failed to allocate memory for furi_string.");
-        return;
-    }
-
-    size_t status_code_start = furi_string_search_str(furi_string, "\"Status-Code\":", 0);
-    if (status_code_start != error_size)
+    // parsed in place, nothing is allocated
+    const char *status_code = strstr(fhttp->last_response, "\"Status-Code\":");
+    if (status_code)
     {
-        // trim everything, including the status code and colon
-        furi_string_right(furi_string, status_code_start + strlen("\"Status-Code\":"));
-
-        // find comma (we have this currently: 200,"Content-Length":12528})
-        size_t comma = furi_string_search_str(furi_string, ",\"Content-Length\":", 0);
-        if (comma == error_size)
-        {
-            FURI_LOG_E(HTTP_TAG, "Failed to find comma in furi_string.");
-            furi_string_free(furi_string);
-            return;
-        }
-
-        // set status code
-        FuriString *status_code_str = furi_string_alloc();
+        status_code += strlen("\"Status-Code\":");
+        fhttp->status_code = atoi(status_code);
 
-        // dest, src, start, length
-        furi_string_set_n(status_code_str, furi_string, 0, comma);
-        fhttp->status_code = atoi(furi_string_get_cstr(status_code_str));
-        furi_string_free(status_code_str);
-
-        // trim left to remove everything before the content length
-        furi_string_right(furi_string, comma + strlen(",\"Content-Length\":"));
-
-        // find closing brace (we have this currently: 12528})
-        size_t closing_brace = furi_string_search_str(furi_string, "}", 0);
-        if (closing_brace == error_size)
+        const char *content_length = strstr(status_code, "\"Content-Length\":");
+        if (content_length)
         {
-            FURI_LOG_E(HTTP_TAG, "Failed to find closing brace in furi_string.");
-            furi_string_free(furi_string);
-            return;
+            fhttp->content_length = atoi(content_length + strlen("\"Content-Length\":"));
         }
+    }
 
-        // set content length
-        FuriString *content_length_str = furi_string_alloc();
-
-        // dest, src, start, length
-        furi_string_set_n(content_length_str, furi_string, 0, closing_brace);
-        fhttp->content_length = atoi(furi_string_get_cstr(content_length_str));
-        furi_string_free(content_length_str);
+    const char *timing = strstr(fhttp->last_response, "\"Timing\":{");
+    if (timing)
+    {
+        fhttp->timing_dns_us = get_timing(timing, "\"dns\":");
+        fhttp->timing_connect_us = get_timing(timing, "\"connect\":");
+        fhttp->timing_tls_us = get_timing(timing, "\"tls\":");
+        fhttp->timing_ttfb_us = get_timing(timing, "\"ttfb\":");
+        fhttp->timing_transfer_us = get_timing(timing, "\"transfer\":");
     }
 
     // print results
     // FURI_LOG_I(HTTP_TAG, "Status Code: %d", fhttp->status_code);
     // FURI_LOG_I(HTTP_TAG, "Content Length: %d", fhttp->content_length);
-
-    // free the furi_string
-    furi_string_free(furi_string);
 }
 
-// Function to trim leading and trailing spaces and newlines from a constant string
-static char *trim(const char *str)
+// Function to find the part of a string without leading and trailing spaces and newlines (no copy)
+static const char *trim_span(const char *str, size_t *len)
 {
-    const char *end;
-    char *trimmed_str;
-    size_t len;
-
-    // Trim leading space
     while (isspace((unsigned char)*str))
         str++;
 
-    // All spaces?
-    if (*str == 0)
-        return strdup(""); // Return an empty string if all spaces
+    size_t n = strlen(str);
+    while (n > 0 && isspace((unsigned char)str[n - 1]))
+        n--;
+
+    *len = n;
+    return str;
+}
+
+// Function to check if a trimmed line ends with one of the [METHOD/END] markers
+static bool is_end_marker(const char *line, size_t len)
+{
+    static const char *const markers[] = {"[GET/END]", "[POST/END]", "[PUT/END]", "[DELETE/END]"};
+    static const size_t marker_lens[] = {9, 10, 9, 12};
+
+    // every marker ends in "/END]", which rejects almost every line with one comparison
+    if (len < 9 || memcmp(line + len - 5, "/END]", 5) != 0)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < COUNT_OF(markers); i++)
+    {
+        if (len >= marker_lens[i] && memcmp(line + len - marker_lens[i], markers[i], marker_lens[i]) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function to open the file sink when a response that should be saved starts
+static void flipper_http_start_file(FlipperHTTP *fhttp)
+{
+    if ((fhttp->is_bytes_request || fhttp->save_received_data) &&
+        !flipper_http_file_sink_open(&fhttp->file_sink, fhttp->file_path, true))
+    {
+        FURI_LOG_E(HTTP_TAG, "Failed to open file: %s", fhttp->file_path);
+    }
+}
+
+// Function to write the body bytes a marker matcher handed out
+static void flipper_http_save_body(const uint8_t *data, size_t len, void *context)
+{
+    FlipperHTTP *fhttp = (FlipperHTTP *)context;
+    fhttp->bytes_received += len;
+    fhttp->just_started_bytes = false;
+    if (fhttp->file_sink.file && !flipper_http_file_sink_write(&fhttp->file_sink, data, len))
+    {
+        FURI_LOG_E(HTTP_TAG, "Failed to append data to file");
+    }
+    flipper_http_queue_body(fhttp, data, len);
+    flipper_http_report_progress(fhttp, false);
+}
 
-    // Trim trailing space
-    end = str + strlen(str) - 1;
-    while (end > str && isspace((unsigned char)*end))
-        end--;
+// Function to start the progress and measurements of a response at its SUCCESS line
+static void flipper_http_start_transfer(FlipperHTTP *fhttp)
+{
+    memset(&fhttp->progress, 0, sizeof(FlipperHTTPProgress));
+    fhttp->progress_start_tick = furi_get_tick();
+    fhttp->progress_tick = fhttp->progress_start_tick;
+    fhttp->progress_bytes = 0;
+    fhttp->rx_dropped_at_start = fhttp->rx_dropped;
+    fhttp->file_sink.write_us = 0;
+    fhttp->file_sink.writes = 0;
+}
 
-    // Set length for the trimmed string
-    len = end - str + 1;
+// Function to report the progress of the response being received, at most every PROGRESS_INTERVAL_MS unless final
+static void flipper_http_report_progress(FlipperHTTP *fhttp, bool final)
+{
+    uint32_t now = furi_get_tick(); // one tick is one millisecond
+    uint32_t since_report_ms = now - fhttp->progress_tick;
+    if (!final && since_report_ms < PROGRESS_INTERVAL_MS)
+    {
+        return;
+    }
+    FlipperHTTPProgress *progress = &fhttp->progress;
+    progress->bytes_received = fhttp->bytes_received;
+    progress->content_length = fhttp->content_length;
+    progress->elapsed_ms = now - fhttp->progress_start_tick;
+    if (since_report_ms > 0)
+    {
+        progress->rate_bps = (uint32_t)((uint64_t)(fhttp->bytes_received - fhttp->progress_bytes) * 1000 / since_report_ms);
+    }
+    if (progress->elapsed_ms > 0)
+    {
+        progress->average_bps = (uint32_t)((uint64_t)fhttp->bytes_received * 1000 / progress->elapsed_ms);
+    }
+    fhttp->progress_tick = now;
+    fhttp->progress_bytes = fhttp->bytes_received;
 
-    // Allocate space for the trimmed string and null terminator
-    trimmed_str = (char *)malloc(len + 1);
-    if (trimmed_str == NULL)
+    uint32_t request_id = 0;
+    FlipperHTTPProgressCallback on_progress = NULL;
+    void *context = NULL;
+    if (fhttp->queue_mutex)
     {
-        return NULL; // Handle memory allocation failure
+        furi_mutex_acquire(fhttp->queue_mutex, FuriWaitForever);
+        FlipperHTTPQueuedRequest *active = flipper_http_active_request(fhttp);
+        if (active)
+        {
+            request_id = active->id;
+            on_progress = active->request.on_progress;
+            context = active->request.context;
+        }
+        furi_mutex_release(fhttp->queue_mutex);
+    }
+    if (fhttp->progress_cb)
+    {
+        fhttp->progress_cb(request_id, progress, fhttp->progress_context);
     }
+    if (on_progress)
+    {
+        on_progress(request_id, progress, context);
+    }
+}
+
+// Function to write what the END marker matcher still holds, close the file sink and keep the measurements
+static void flipper_http_finish_file(FlipperHTTP *fhttp)
+{
+    marker_matcher_flush(&fhttp->end_marker, flipper_http_save_body, fhttp);
+    if (!flipper_http_file_sink_close(&fhttp->file_sink))
+    {
+        FURI_LOG_E(HTTP_TAG, "Failed to write data to file.");
+    }
+
+    flipper_http_report_progress(fhttp, true);
+    FlipperHTTPTransferStats *stats = &fhttp->transfer_stats;
+    stats->bytes = fhttp->progress.bytes_received;
+    stats->duration_ms = fhttp->progress.elapsed_ms;
+    stats->average_bps = fhttp->progress.average_bps;
+    stats->sd_write_us = fhttp->file_sink.write_us;
+    stats->sd_writes = fhttp->file_sink.writes;
+    stats->uart_us = stats->duration_ms * 1000 > stats->sd_write_us ? stats->duration_ms * 1000 - stats->sd_write_us : 0;
+    stats->rx_dropped = fhttp->rx_dropped - fhttp->rx_dropped_at_start;
+    FURI_LOG_I(
+        HTTP_TAG,
+        "Received %u bytes in %lu ms (%lu B/s), SD writes %lu us in %lu writes, %lu bytes dropped.",
+        stats->bytes,
+        stats->duration_ms,
+        stats->average_bps,
+        stats->sd_write_us,
+        stats->sd_writes,
+        stats->rx_dropped);
+}
 
-    // Copy the trimmed part of the string into trimmed_str
-    strncpy(trimmed_str, str, len);
-    trimmed_str[len] = '\0'; // Null terminate the string
+// Function to finish the response being received once its END marker arrived
+static void flipper_http_end_response(FlipperHTTP *fhttp)
+{
+    FURI_LOG_I(HTTP_TAG, "%s request completed.", response_markers[fhttp->response_method].name);
+    // Stop the timeouts since we've completed the request
+    flipper_http_timeout_stop(fhttp);
+    fhttp->started_receiving = false;
+    fhttp->just_started = false;
+    fhttp->state = IDLE;
+    fhttp->save_bytes = false;
+    fhttp->is_bytes_request = false;
+    fhttp->save_received_data = false;
 
-    return trimmed_str;
+    // Write what is left and close the file
+    flipper_http_finish_file(fhttp);
+    flipper_http_queue_complete(fhttp, true);
 }
 
 /**
@@ -1216,20 +2861,15 @@ static void flipper_http_rx_callback(const char *line, void *context)
         return;
     }
 
-    // Trim the received line to check if it's empty
-    char *trimmed_line = trim(line);
-    if (trimmed_line != NULL && trimmed_line[0] != '\0')
+    // Keep the trimmed line as the last response unless it is empty or an END marker
+    size_t trimmed_len;
+    const char *trimmed_line = trim_span(line, &trimmed_len);
+    if (trimmed_len > 0 && !is_end_marker(trimmed_line, trimmed_len))
     {
-        // if the line is not [GET/END] or [POST/END] or [PUT/END] or [DELETE/END]
-        if (strstr(trimmed_line, "[GET/END]") == NULL &&
-            strstr(trimmed_line, "[POST/END]") == NULL &&
-            strstr(trimmed_line, "[PUT/END]") == NULL &&
-            strstr(trimmed_line, "[DELETE/END]") == NULL)
-        {
-            strncpy(fhttp->last_response, trimmed_line, RX_BUF_SIZE);
-        }
+        size_t copy_len = MIN(trimmed_len, (size_t)(RX_BUF_SIZE - 1));
+        memcpy(fhttp->last_response, trimmed_line, copy_len);
+        fhttp->last_response[copy_len] = '\0';
     }
-    free(trimmed_line); // Free the allocated memory for trimmed_line
 
     if (fhttp->state != INACTIVE && fhttp->state != ISSUE)
     {
@@ -1239,68 +2879,30 @@ static void flipper_http_rx_callback(const char *line, void *context)
     // Uncomment below line to log the data received over UART
     // FURI_LOG_I(HTTP_TAG, "Received UART line: %s", line);
 
-    // Check if we've started receiving data from a GET request
-    if (fhttp->started_receiving && (fhttp->method == GET || fhttp->method == BYTES))
+    // Lines of a text response, up to its END line (bytes responses never get here)
+    if (fhttp->started_receiving)
     {
-        // Restart the timeout timer each time new data is received
-        furi_timer_restart(fhttp->get_timeout_timer, TIMEOUT_DURATION_TICKS);
-
-        if (strstr(line, "[GET/END]") != NULL)
+        if (strstr(line, response_markers[fhttp->response_method].end_line) != NULL)
         {
-            FURI_LOG_I(HTTP_TAG, "GET request completed.");
-            // Stop the timer since we've completed the GET request
-            furi_timer_stop(fhttp->get_timeout_timer);
-            fhttp->started_receiving = false;
-            fhttp->just_started = false;
-            fhttp->state = IDLE;
-            fhttp->save_bytes = false;
-            fhttp->save_received_data = false;
-
-            if (fhttp->is_bytes_request)
-            {
-                // Search for the binary marker `[GET/END]` in the file buffer
-                const char marker[] = "[GET/END]";
-                const size_t marker_len = sizeof(marker) - 1; // Exclude null terminator
-
-                for (size_t i = 0; i <= fhttp->file_buffer_len - marker_len; i++)
-                {
-                    // Check if the marker is found
-                    if (memcmp(&fhttp->file_buffer[i], marker, marker_len) == 0)
-                    {
-                        // Remove the marker by shifting the remaining data left
-                        size_t remaining_len = fhttp->file_buffer_len - (i + marker_len);
-                        memmove(&fhttp->file_buffer[i], &fhttp->file_buffer[i + marker_len], remaining_len);
-                        fhttp->file_buffer_len -= marker_len;
-                        break;
-                    }
-                }
-
-                // If there is data left in the buffer, append it to the file
-                if (fhttp->file_buffer_len > 0)
-                {
-                    if (!flipper_http_append_to_file(fhttp->file_buffer, fhttp->file_buffer_len, false, fhttp->file_path))
-                    {
-                        FURI_LOG_E(HTTP_TAG, "Failed to append data to file.");
-                    }
-                    fhttp->file_buffer_len = 0;
-                }
-            }
-
-            fhttp->is_bytes_request = false;
+            flipper_http_end_response(fhttp);
             return;
         }
 
         // Append the new line to the existing data
         if (fhttp->save_received_data &&
-            !flipper_http_append_to_file(
-                line, strlen(line), !fhttp->just_started, fhttp->file_path))
+            !flipper_http_file_sink_write(&fhttp->file_sink, line, strlen(line)))
         {
             FURI_LOG_E(HTTP_TAG, "Failed to append data to file.");
+            flipper_http_file_sink_close(&fhttp->file_sink);
             fhttp->started_receiving = false;
             fhttp->just_started = false;
             fhttp->state = IDLE;
+            flipper_http_timeout_stop(fhttp);
+            flipper_http_queue_complete(fhttp, false);
             return;
         }
+        flipper_http_queue_body(fhttp, (const uint8_t *)line, strlen(line));
+        flipper_http_report_progress(fhttp, false);
 
         if (!fhttp->just_started)
         {
@@ -1309,152 +2911,45 @@ static void flipper_http_rx_callback(const char *line, void *context)
         return;
     }
 
-    // Check if we've started receiving data from a POST request
-    else if (fhttp->started_receiving && (fhttp->method == POST || fhttp->method == BYTES_POST))
+    // A [METHOD/SUCCESS] line starts a response
+    for (size_t i = 0; i < COUNT_OF(response_markers); i++)
     {
-        // Restart the timeout timer each time new data is received
-        furi_timer_restart(fhttp->get_timeout_timer, TIMEOUT_DURATION_TICKS);
-
-        if (strstr(line, "[POST/END]") != NULL)
+        if (strstr(line, response_markers[i].success) != NULL)
         {
-            FURI_LOG_I(HTTP_TAG, "POST request completed.");
-            // Stop the timer since we've completed the POST request
-            furi_timer_stop(fhttp->get_timeout_timer);
-            fhttp->started_receiving = false;
-            fhttp->just_started = false;
-            fhttp->state = IDLE;
-            fhttp->save_bytes = false;
-            fhttp->save_received_data = false;
-
-            if (fhttp->is_bytes_request)
+            FURI_LOG_I(HTTP_TAG, "%s request succeeded.", response_markers[i].name);
+            if (!fhttp->timeout_armed)
             {
-                // Search for the binary marker `[POST/END]` in the file buffer
-                const char marker[] = "[POST/END]";
-                const size_t marker_len = sizeof(marker) - 1; // Exclude null terminator
-
-                for (size_t i = 0; i <= fhttp->file_buffer_len - marker_len; i++)
-                {
-                    // Check if the marker is found
-                    if (memcmp(&fhttp->file_buffer[i], marker, marker_len) == 0)
-                    {
-                        // Remove the marker by shifting the remaining data left
-                        size_t remaining_len = fhttp->file_buffer_len - (i + marker_len);
-                        memmove(&fhttp->file_buffer[i], &fhttp->file_buffer[i + marker_len], remaining_len);
-                        fhttp->file_buffer_len -= marker_len;
-                        break;
-                    }
-                }
-
-                // If there is data left in the buffer, append it to the file
-                if (fhttp->file_buffer_len > 0)
-                {
-                    if (!flipper_http_append_to_file(fhttp->file_buffer, fhttp->file_buffer_len, false, fhttp->file_path))
-                    {
-                        FURI_LOG_E(HTTP_TAG, "Failed to append data to file.");
-                    }
-                    fhttp->file_buffer_len = 0;
-                }
+                // A raw command from flipper_http_send_data has no timeouts yet, the END marker may still never come
+                flipper_http_timeout_start(fhttp);
             }
 
-            fhttp->is_bytes_request = false;
-            return;
-        }
-
-        // Append the new line to the existing data
-        if (fhttp->save_received_data &&
-            !flipper_http_append_to_file(
-                line, strlen(line), !fhttp->just_started, fhttp->file_path))
-        {
-            FURI_LOG_E(HTTP_TAG, "Failed to append data to file.");
-            fhttp->started_receiving = false;
-            fhttp->just_started = false;
-            fhttp->state = IDLE;
-            return;
-        }
-
-        if (!fhttp->just_started)
-        {
-            fhttp->just_started = true;
-        }
-        return;
-    }
+            // The board answers in order, so it is done with the commands sent before this request
+            if (fhttp->unanswered_command < fhttp->request_command)
+            {
+                fhttp->unanswered_command = 0;
+            }
 
-    // Check if we've started receiving data from a PUT request
-    else if (fhttp->started_receiving && fhttp->method == PUT)
-    {
-        // Restart the timeout timer each time new data is received
-        furi_timer_restart(fhttp->get_timeout_timer, TIMEOUT_DURATION_TICKS);
+            fhttp->response_method = (HTTPMethod)i;
+            fhttp->started_receiving = true;
+            fhttp->state = RECEIVING;
 
-        if (strstr(line, "[PUT/END]") != NULL)
-        {
-            FURI_LOG_I(HTTP_TAG, "PUT request completed.");
-            // Stop the timer since we've completed the PUT request
-            furi_timer_stop(fhttp->get_timeout_timer);
-            fhttp->started_receiving = false;
-            fhttp->just_started = false;
-            fhttp->state = IDLE;
-            fhttp->save_bytes = false;
-            fhttp->is_bytes_request = false;
-            fhttp->save_received_data = false;
-            return;
-        }
+            // save the raw bytes only for bytes requests, other responses are saved line by line
+            fhttp->save_bytes = fhttp->is_bytes_request;
+            fhttp->just_started_bytes = true;
+            marker_matcher_init(&fhttp->end_marker, response_markers[i].end_bytes);
 
-        // Append the new line to the existing data
-        if (fhttp->save_received_data &&
-            !flipper_http_append_to_file(
-                line, strlen(line), !fhttp->just_started, fhttp->file_path))
-        {
-            FURI_LOG_E(HTTP_TAG, "Failed to append data to file.");
-            fhttp->started_receiving = false;
-            fhttp->just_started = false;
-            fhttp->state = IDLE;
+            // set header
+            set_header(fhttp);
+            flipper_http_start_transfer(fhttp);
+            flipper_http_start_file(fhttp);
             return;
         }
-
-        if (!fhttp->just_started)
-        {
-            fhttp->just_started = true;
-        }
-        return;
     }
 
-    // Check if we've started receiving data from a DELETE request
-    else if (fhttp->started_receiving && fhttp->method == DELETE)
+    // Any other line answers a command, except the messages of WebSocket sessions
+    if (strncmp(line, "[SOCKET/", 8) != 0 || !isdigit((unsigned char)line[8]))
     {
-        // Restart the timeout timer each time new data is received
-        furi_timer_restart(fhttp->get_timeout_timer, TIMEOUT_DURATION_TICKS);
-
-        if (strstr(line, "[DELETE/END]") != NULL)
-        {
-            FURI_LOG_I(HTTP_TAG, "DELETE request completed.");
-            // Stop the timer since we've completed the DELETE request
-            furi_timer_stop(fhttp->get_timeout_timer);
-            fhttp->started_receiving = false;
-            fhttp->just_started = false;
-            fhttp->state = IDLE;
-            fhttp->save_bytes = false;
-            fhttp->is_bytes_request = false;
-            fhttp->save_received_data = false;
-            return;
-        }
-
-        // Append the new line to the existing data
-        if (fhttp->save_received_data &&
-            !flipper_http_append_to_file(
-                line, strlen(line), !fhttp->just_started, fhttp->file_path))
-        {
-            FURI_LOG_E(HTTP_TAG, "Failed to append data to file.");
-            fhttp->started_receiving = false;
-            fhttp->just_started = false;
-            fhttp->state = IDLE;
-            return;
-        }
-
-        if (!fhttp->just_started)
-        {
-            fhttp->just_started = true;
-        }
-        return;
+        fhttp->unanswered_command = 0;
     }
 
     // Handle different types of responses
@@ -1471,64 +2966,6 @@ static void flipper_http_rx_callback(const char *line, void *context)
             fhttp->state = IDLE;
         }
     }
-    else if (strstr(line, "[GET/SUCCESS]") != NULL)
-    {
-        FURI_LOG_I(HTTP_TAG, "GET request succeeded.");
-        furi_timer_start(fhttp->get_timeout_timer, TIMEOUT_DURATION_TICKS);
-
-        fhttp->started_receiving = true;
-        fhttp->state = RECEIVING;
-
-        // for GET request, save data only if it's a bytes request
-        fhttp->save_bytes = fhttp->is_bytes_request;
-        fhttp->just_started_bytes = true;
-        fhttp->file_buffer_len = 0;
-
-        // set header
-        set_header(fhttp);
-        return;
-    }
-    else if (strstr(line, "[POST/SUCCESS]") != NULL)
-    {
-        FURI_LOG_I(HTTP_TAG, "POST request succeeded.");
-        furi_timer_start(fhttp->get_timeout_timer, TIMEOUT_DURATION_TICKS);
-
-        fhttp->started_receiving = true;
-        fhttp->state = RECEIVING;
-
-        // for POST request, save data only if it's a bytes request
-        fhttp->save_bytes = fhttp->is_bytes_request;
-        fhttp->just_started_bytes = true;
-        fhttp->file_buffer_len = 0;
-
-        // set header
-        set_header(fhttp);
-        return;
-    }
-    else if (strstr(line, "[PUT/SUCCESS]") != NULL)
-    {
-        FURI_LOG_I(HTTP_TAG, "PUT request succeeded.");
-        furi_timer_start(fhttp->get_timeout_timer, TIMEOUT_DURATION_TICKS);
-
-        fhttp->started_receiving = true;
-        fhttp->state = RECEIVING;
-
-        // set header
-        set_header(fhttp);
-        return;
-    }
-    else if (strstr(line, "[DELETE/SUCCESS]") != NULL)
-    {
-        FURI_LOG_I(HTTP_TAG, "DELETE request succeeded.");
-        furi_timer_start(fhttp->get_timeout_timer, TIMEOUT_DURATION_TICKS);
-
-        fhttp->started_receiving = true;
-        fhttp->state = RECEIVING;
-
-        // set header
-        set_header(fhttp);
-        return;
-    }
     else if (strstr(line, "[DISCONNECTED]") != NULL)
     {
         FURI_LOG_I(HTTP_TAG, "WiFi disconnected successfully.");
@@ -1537,6 +2974,7 @@ static void flipper_http_rx_callback(const char *line, void *context)
     {
         FURI_LOG_E(HTTP_TAG, "Received error: %s", line);
         fhttp->state = ISSUE;
+        flipper_http_queue_error(fhttp);
         return;
     }
     else if (strstr(line, "[PONG]") != NULL)
@@ -1587,24 +3025,19 @@ bool flipper_http_websocket_start(FlipperHTTP *fhttp, const char *url, uint16_t
         return false;
     }
 
-    // Prepare WebSocket request command with headers
-    char command[512];
-    int ret = snprintf(
-        command,
-        sizeof(command),
-        "[SOCKET/START]{\"url\":\"%s\",\"port\":%d,\"headers\":%s}",
-        url,
-        port,
-        headers);
-
-    if (ret < 0 || ret >= (int)sizeof(command))
+    FlipperHTTPCommandWriter writer;
+    if (!flipper_http_command_begin(fhttp, &writer, "[SOCKET/START]{\"url\":"))
     {
-        FURI_LOG_E("FlipperHTTP", "Failed to format WebSocket start command with headers.");
         return false;
     }
-
-    // Send WebSocket request via UART
-    return flipper_http_send_data(fhttp, command);
+    char number[32];
+    snprintf(number, sizeof(number), ",\"port\":%u,\"headers\":", port);
+    flipper_http_command_write_string(&writer, url);
+    flipper_http_command_write(&writer, number);
+    flipper_http_command_write_json(&writer, headers);
+    flipper_http_command_write(&writer, "}");
+    flipper_http_command_end(&writer);
+    return true;
 }
 
 /**
@@ -1621,4 +3054,93 @@ bool flipper_http_websocket_stop(FlipperHTTP *fhttp)
         return false;
     }
     return flipper_http_send_data(fhttp, "[SOCKET/STOP]");
+}
+
+/**
+ * @brief      Send a request to open a WebSocket session that stays open alongside other commands.
+ * @return     true if the request was successful, false otherwise.
+ * @param fhttp The FlipperHTTP context
+ * @param      url  The URL to send the WebSocket request to.
+ * @param port The port to connect to
+ * @param headers The headers to send with the WebSocket request
+ * @note       The board replies with [SOCKET/OPENED]{"id":<id>}; messages from the server arrive as [SOCKET/<id>]<message>.
+ */
+bool flipper_http_websocket_open(FlipperHTTP *fhttp, const char *url, uint16_t port, const char *headers)
+{
+    if (!fhttp)
+    {
+        FURI_LOG_E(HTTP_TAG, "Failed to get context.");
+        return false;
+    }
+    if (!url || !headers)
+    {
+        FURI_LOG_E(HTTP_TAG, "Invalid arguments provided to flipper_http_websocket_open.");
+        return false;
+    }
+
+    FlipperHTTPCommandWriter writer;
+    if (!flipper_http_command_begin(fhttp, &writer, "[SOCKET/OPEN]{\"url\":"))
+    {
+        return false;
+    }
+    char number[32];
+    snprintf(number, sizeof(number), ",\"port\":%u,\"headers\":", port);
+    flipper_http_command_write_string(&writer, url);
+    flipper_http_command_write(&writer, number);
+    flipper_http_command_write_json(&writer, headers);
+    flipper_http_command_write(&writer, "}");
+    flipper_http_command_end(&writer);
+    return true;
+}
+
+/**
+ * @brief      Send a text message on a WebSocket session.
+ * @return     true if the request was successful, false otherwise.
+ * @param fhttp The FlipperHTTP context
+ * @param id The session ID returned in [SOCKET/OPENED]
+ * @param message The message to send (a single line)
+ */
+bool flipper_http_websocket_send(FlipperHTTP *fhttp, uint8_t id, const char *message)
+{
+    if (!fhttp)
+    {
+        FURI_LOG_E(HTTP_TAG, "Failed to get context.");
+        return false;
+    }
+    if (!message)
+    {
+        FURI_LOG_E(HTTP_TAG, "Invalid arguments provided to flipper_http_websocket_send.");
+        return false;
+    }
+
+    char prefix[16];
+    snprintf(prefix, sizeof(prefix), "[SOCKET/%u]", id);
+    FlipperHTTPCommandWriter writer;
+    if (!flipper_http_command_begin(fhttp, &writer, prefix))
+    {
+        return false;
+    }
+    flipper_http_command_write(&writer, message);
+    flipper_http_command_end(&writer);
+    return true;
+}
+
+/**
+ * @brief      Send a request to close a WebSocket session.
+ * @return     true if the request was successful, false otherwise.
+ * @param fhttp The FlipperHTTP context
+ * @param id The session ID returned in [SOCKET/OPENED]
+ * @note       The board replies with [SOCKET/CLOSED]{"id":<id>,"reason":"closed"}; "timeout" and "stalled" mark sessions the board closed itself.
+ */
+bool flipper_http_websocket_close(FlipperHTTP *fhttp, uint8_t id)
+{
+    if (!fhttp)
+    {
+        FURI_LOG_E(HTTP_TAG, "Failed to get context.");
+        return false;
+    }
+
+    char command[32];
+    snprintf(command, sizeof(command), "[SOCKET/CLOSE]{\"id\":%u}", id);
+    return flipper_http_send_data(fhttp, command);
 }
\ No newline at end of file
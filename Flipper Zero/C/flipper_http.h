@@ -17,12 +17,23 @@
 #define HTTP_TAG "FlipperHTTP"            // change this to your app name
 #define http_tag "flipper_http"           // change this to your app id
 #define UART_CH (FuriHalSerialIdUsart)    // UART channel
-#define TIMEOUT_DURATION_TICKS (5 * 1000) // 5 seconds
+#define TIMEOUT_DURATION_TICKS (5 * 1000) // 5 seconds, default first-byte and idle timeout
 #define BAUDRATE (115200)                 // UART baudrate
 #define RX_BUF_SIZE 2048                  // UART RX buffer size
+#define RX_CHUNK_SIZE 64                  // Bytes moved at once from DMA to the stream buffer and from there to the worker
 #define RX_LINE_BUFFER_SIZE 3000          // UART RX line buffer size (increase for large responses)
 #define MAX_FILE_SHOW 3000                // Maximum data from file to show
-#define FILE_BUFFER_SIZE 512              // File buffer size
+#define FILE_SINK_BUFFER_SIZE 4096        // Bytes collected before each SD write (a multiple of the 512-byte sector)
+#define FILE_READER_WINDOW 512            // Bytes of a file held in memory at once by a file reader
+#define MARKER_MAX_LEN 16                 // Longest marker a marker matcher can find
+#define COMMAND_WRITER_BUFFER 64          // Bytes of a command collected before each UART write
+#define PROGRESS_INTERVAL_MS 100          // Shortest time between two progress reports of a response
+#define BOARD_TIMEOUT_MARGIN_MS 500       // The board ends a stream this long before the idle timeout, so its END marker still counts
+#define REQUEST_QUEUE_SIZE 4              // Requests flipper_http_submit can hold, including the one being answered
+#define WORKER_STACK_SIZE 4096            // Stack of the worker thread, shared with the callbacks of requests
+#define JSON_MAX_DEPTH 16                 // Deepest nesting of objects and arrays the JSON tokenizer follows
+#define JSON_TOKEN_SIZE 128               // Longest string, key or number kept by the JSON tokenizer (longer ones are cut)
+#define JSON_PATH_SIZE 128                // Longest path kept by the JSON tokenizer (longer ones are cut)
 
 // Forward declaration for callback
 typedef void (*FlipperHTTP_Callback)(const char *line, void *context);
@@ -42,6 +53,7 @@ typedef enum
 {
     WorkerEvtStop = (1 << 0),
     WorkerEvtRxDone = (1 << 1),
+    WorkerEvtTimeout = (1 << 2),
 } WorkerEvtFlags;
 
 typedef enum
@@ -66,11 +78,158 @@ typedef enum
     HTTP_CMD_LED_ON,
     HTTP_CMD_LED_OFF,
     HTTP_CMD_PING,
-    HTTP_CMD_REBOOT
+    HTTP_CMD_REBOOT,
+    HTTP_CMD_TIMING_ON,
+    HTTP_CMD_TIMING_OFF
 } HTTPCommand; // list of non-input commands
 
-// FlipperHTTP Structure
+// File that received data is written to, kept open for a whole transfer
+typedef struct
+{
+    Storage *storage;  // Storage record, open while the file is
+    File *file;        // Open file, NULL when the sink is closed
+    uint8_t *buffer;   // FILE_SINK_BUFFER_SIZE bytes waiting to be written (NULL: write straight through)
+    size_t buffer_len; // Number of bytes in buffer
+    uint32_t write_us; // Time spent writing to and closing the file since it was opened
+    uint32_t writes;   // Number of writes to the file since it was opened
+} FlipperHTTPFileSink;
+
+// Finds a marker in a byte stream, even when it is split across received blocks (KMP)
+typedef struct
+{
+    const char *marker;           // Marker to find
+    size_t len;                   // Length of marker
+    size_t matched;               // Bytes of marker matched by the last bytes seen
+    size_t held;                  // Bytes of the partial match from earlier blocks, not handed out yet
+    uint8_t fail[MARKER_MAX_LEN]; // Length of the longest proper prefix that is also a suffix of marker[0..i]
+} FlipperHTTPMarkerMatcher;
+
+// File read through a fixed window, so a saved response never has to fit in memory
+typedef struct
+{
+    Storage *storage;                   // Storage record, open while the file is
+    File *file;                         // Open file, NULL when the reader is closed
+    size_t file_size;                   // Size of the file
+    size_t window_offset;               // File offset of window[0]
+    size_t window_len;                  // Number of valid bytes in window
+    size_t window_pos;                  // Index of the next unread byte in window
+    uint8_t window[FILE_READER_WINDOW]; // Bytes read from the file
+} FlipperHTTPFileReader;
+
+// Events reported by the JSON tokenizer
+typedef enum
+{
+    JSON_EVENT_OBJECT_START, // '{' (path is the path of the object)
+    JSON_EVENT_OBJECT_END,   // '}'
+    JSON_EVENT_ARRAY_START,  // '['
+    JSON_EVENT_ARRAY_END,    // ']'
+    JSON_EVENT_STRING,       // String value, with escapes decoded
+    JSON_EVENT_NUMBER,       // Number, as written
+    JSON_EVENT_TRUE,         // true
+    JSON_EVENT_FALSE,        // false
+    JSON_EVENT_NULL,         // null
+} FlipperHTTPJsonEvent;
+
+// Called for each JSON value, return false to stop the tokenizer.
+// path looks like "data.items[2].name" ("" for the top-level value), value is null-terminated.
+typedef bool (*FlipperHTTPJson_Callback)(FlipperHTTPJsonEvent event, const char *path, const char *value, size_t value_len, void *context);
+
+// Incremental JSON tokenizer: it is fed any number of pieces and allocates nothing
+typedef struct
+{
+    FlipperHTTPJson_Callback callback; // Callback for each value
+    void *context;                     // Context for the callback
+    uint8_t expect;                    // What may come next
+    uint8_t token;                     // Token being read
+    bool error;                        // Set on a syntax error
+    bool stopped;                      // Set when the callback returned false
+    const char *literal;               // true, false or null being matched
+    uint8_t literal_pos;               // Characters of literal matched so far
+    uint8_t unicode_digits;            // Hex digits of a \u escape read so far
+    uint16_t unicode;                  // Value of the \u escape being read
+    uint16_t high_surrogate;           // First half of a UTF-16 surrogate pair, 0 if none
+    uint8_t depth;                     // Number of open objects and arrays
+    bool in_array[JSON_MAX_DEPTH];     // Whether each open container is an array
+    uint16_t index[JSON_MAX_DEPTH];    // Index of the current element of each open array
+    uint16_t base[JSON_MAX_DEPTH];     // Length of the path of each open container
+    char path[JSON_PATH_SIZE];         // Path of the current value
+    uint16_t path_len;                 // Length of path
+    char value[JSON_TOKEN_SIZE];       // String, key or number being read
+    uint16_t value_len;                // Length of value
+} FlipperHTTPJson;
+
+// Writes a command to the board in pieces, so its length is not limited by a buffer
+typedef struct
+{
+    struct FlipperHTTP *fhttp;             // Context the command is sent through
+    uint8_t buffer[COMMAND_WRITER_BUFFER]; // Bytes not yet written to the UART
+    size_t len;                            // Number of bytes in buffer
+} FlipperHTTPCommandWriter;
+
+// Progress of the response being received
+typedef struct
+{
+    size_t bytes_received; // Body bytes received so far
+    size_t content_length; // Content-Length sent by the server, 0 if unknown
+    uint32_t elapsed_ms;   // Time since the response started
+    uint32_t rate_bps;     // Bytes per second since the previous report
+    uint32_t average_bps;  // Bytes per second since the response started
+} FlipperHTTPProgress;
+
+// Timeouts of a request in milliseconds, 0 for the default (fhttp->timeouts, or none for total_ms)
+typedef struct
+{
+    uint32_t first_byte_ms; // From sending the request to the first byte of the answer
+    uint32_t idle_ms;       // Longest gap between two received bytes after that
+    uint32_t total_ms;      // Deadline for the whole request
+} FlipperHTTPTimeouts;
+
+// Measurements of a whole response, from its SUCCESS line to its END marker
 typedef struct
+{
+    size_t bytes;         // Body bytes received
+    uint32_t duration_ms; // Time from the SUCCESS line to the end
+    uint32_t sd_write_us; // Time spent writing the response to the SD card
+    uint32_t sd_writes;   // Number of SD card writes
+    uint32_t uart_us;     // The rest of the time: waiting for and handling UART data
+    uint32_t average_bps; // Bytes per second over the whole response
+    uint32_t rx_dropped;  // Bytes lost because the worker fell behind and the RX stream buffer was full
+} FlipperHTTPTransferStats;
+
+// Callbacks of requests, called on the FlipperHTTP worker thread (keep them short) without the
+// request queue locked, so they may submit or cancel requests and wait on threads that do.
+// They share its WORKER_STACK_SIZE stack with the receive path and SD card writes: keep their
+// locals under about 2 KB and put larger buffers in the context or on the heap.
+typedef void (*FlipperHTTPChunkCallback)(uint32_t request_id, const uint8_t *data, size_t len, void *context);
+typedef void (*FlipperHTTPProgressCallback)(uint32_t request_id, const FlipperHTTPProgress *progress, void *context);
+typedef void (*FlipperHTTPCompleteCallback)(uint32_t request_id, bool success, int status_code, void *context);
+
+// Request for flipper_http_submit, its strings are copied
+typedef struct
+{
+    HTTPMethod method;                       // HTTP method (BYTES and BYTES_POST need file_path)
+    const char *url;                         // URL to send the request to
+    const char *headers;                     // Headers as a JSON object, NULL for none
+    const char *payload;                     // Payload as JSON, NULL for none
+    const char *file_path;                   // File the response is saved to, NULL to not save it
+    FlipperHTTPChunkCallback on_chunk;       // Body as it arrives (line by line for text responses), NULL for none
+    FlipperHTTPProgressCallback on_progress; // Progress after each piece of the body, NULL for none
+    FlipperHTTPCompleteCallback on_complete; // Called once when the request ends, NULL for none
+    void *context;                           // Context for the callbacks
+    FlipperHTTPTimeouts timeouts;            // Timeouts of this request, zero fields use fhttp->timeouts
+} FlipperHTTPRequest;
+
+// Request held by the queue of flipper_http_submit
+typedef struct
+{
+    uint32_t id;                // Handle of the request, 0 for a free slot
+    FlipperHTTPRequest request; // Copy of the request, its strings owned by the queue
+    bool sent;                  // Sent to the board, waiting for the response
+    bool owns_errors;           // No other command was waiting for an answer, so an [ERROR] line is about this request
+} FlipperHTTPQueuedRequest;
+
+// FlipperHTTP Structure
+typedef struct FlipperHTTP
 {
     FuriStreamBuffer *flipper_http_stream;    // Stream buffer for UART communication
     FuriHalSerialHandle *serial_handle;       // Serial handle for UART communication
@@ -83,6 +242,12 @@ typedef struct
     char *last_response;                      // variable to store the last received data from the UART
     char file_path[256];                      // Path to save the received data
     FuriTimer *get_timeout_timer;             // Timer for HTTP request timeout
+    FlipperHTTPTimeouts timeouts;             // Default timeouts, set with flipper_http_set_timeouts
+    FlipperHTTPTimeouts active_timeouts;      // Timeouts of the last request sent
+    bool timeout_armed;                       // The timeouts of the last request are running
+    bool first_byte_received;                 // A byte arrived since the timeouts were started
+    uint32_t request_tick;                    // Tick when the timeouts were started
+    uint32_t last_rx_tick;                    // Tick when the worker last received bytes
     bool started_receiving;                   // Indicates if a request has started
     bool just_started;                        // Indicates if data reception has just started
     bool is_bytes_request;                    // Flag to indicate if the request is for bytes
@@ -91,10 +256,33 @@ typedef struct
     bool just_started_bytes;                  // Indicates if bytes data reception has just started
     size_t bytes_received;                    // Number of bytes received
     char rx_line_buffer[RX_LINE_BUFFER_SIZE]; // Buffer for received lines
-    uint8_t file_buffer[FILE_BUFFER_SIZE];    // Buffer for file data
-    size_t file_buffer_len;                   // Length of the file buffer
+    HTTPMethod response_method;               // Method whose markers frame the response being received
+    FlipperHTTPMarkerMatcher end_marker;      // Finds the END marker of a bytes response
+    FlipperHTTPFileSink file_sink;            // File the current response is saved to
     size_t content_length;                    // Length of the content received
     int status_code;                          // HTTP status code
+    uint32_t timing_dns_us;                   // DNS lookup time of the last request (HTTP_CMD_TIMING_ON), 0 when the board resolves inside connect
+    uint32_t timing_connect_us;               // TCP connect time of the last plain request
+    uint32_t timing_tls_us;                   // TCP connect and TLS handshake time of the last secure request
+    uint32_t timing_ttfb_us;                  // Time from sending the last request to its response headers
+    uint32_t timing_transfer_us;              // Body transfer time of the last request (0 for streamed requests)
+    FlipperHTTPProgressCallback progress_cb;  // Progress of every response, NULL for none
+    void *progress_context;                   // Context for progress_cb
+    FlipperHTTPProgress progress;             // Progress of the response being received
+    uint32_t progress_start_tick;             // Tick when the response started
+    uint32_t progress_tick;                   // Tick of the last progress report
+    size_t progress_bytes;                    // Bytes received at the last progress report
+    FlipperHTTPTransferStats transfer_stats;  // Measurements of the last response that ended
+    uint32_t rx_dropped;                      // Bytes lost since alloc because the RX stream buffer was full
+    uint32_t rx_dropped_at_start;             // rx_dropped when the response started
+    FlipperHTTPQueuedRequest queue[REQUEST_QUEUE_SIZE]; // Requests from flipper_http_submit, the oldest at queue_head
+    size_t queue_head;                        // Index of the oldest queued request
+    size_t queue_count;                       // Number of queued requests
+    uint32_t next_request_id;                 // Last handle given out by flipper_http_submit
+    FuriMutex *queue_mutex;                   // Guards the queue between the app and the worker thread
+    uint32_t commands_sent;                   // Number of commands written to the board since alloc
+    uint32_t request_command;                 // commands_sent when the last request was written
+    uint32_t unanswered_command;              // commands_sent when the last other command the board may not have answered was written, 0 if none
 } FlipperHTTP;
 
 /**
@@ -123,6 +311,33 @@ void flipper_http_free(FlipperHTTP *fhttp);
  */
 bool flipper_http_append_to_file(const void *data, size_t data_size, bool start_new_file, char *file_path);
 
+/**
+ * @brief      Open a file sink for a transfer.
+ * @return     true if the file was opened, false otherwise.
+ * @param      sink           The sink to open (closed first if it is open).
+ * @param      file_path      The path to the file.
+ * @param      start_new_file Flag to indicate if a new file should be created instead of appending.
+ * @note       The file stays open until flipper_http_file_sink_close, so each write is a memory copy
+ *             and the SD card is only written in FILE_SINK_BUFFER_SIZE blocks.
+ */
+bool flipper_http_file_sink_open(FlipperHTTPFileSink *sink, const char *file_path, bool start_new_file);
+
+/**
+ * @brief      Write data to an open file sink.
+ * @return     true if the data was written (or buffered), false otherwise.
+ * @param      sink      The sink to write to.
+ * @param      data      The data to write.
+ * @param      data_size The size of the data.
+ */
+bool flipper_http_file_sink_write(FlipperHTTPFileSink *sink, const void *data, size_t data_size);
+
+/**
+ * @brief      Write what is buffered and close a file sink.
+ * @return     true if everything was written, false otherwise.
+ * @param      sink The sink to close. Closing a closed sink does nothing.
+ */
+bool flipper_http_file_sink_close(FlipperHTTPFileSink *sink);
+
 /**
  * @brief      Send a command to deauthenticate a WiFi network.
  * @return     true if the request was successful, false otherwise.
@@ -139,10 +354,122 @@ bool flipper_http_deauth_start(FlipperHTTP *fhttp, const char *ssid);
  */
 bool flipper_http_deauth_stop(FlipperHTTP *fhttp);
 
+/**
+ * @brief      Open a file for reading through a fixed-size window.
+ * @return     true if the file was opened, false otherwise.
+ * @param      reader    The reader to open (closed first if it is open).
+ * @param      file_path The path to the file.
+ */
+bool flipper_http_file_reader_open(FlipperHTTPFileReader *reader, const char *file_path);
+
+/**
+ * @brief      Close a file reader. Closing a closed reader does nothing.
+ * @return     void
+ * @param      reader The reader to close.
+ */
+void flipper_http_file_reader_close(FlipperHTTPFileReader *reader);
+
+/**
+ * @brief      Get the next piece of the file without copying it.
+ * @return     true if data was returned, false at the end of the file.
+ * @param      reader The reader.
+ * @param      data   Set to the next unread bytes, valid until the next call on the reader.
+ * @param      len    Set to the number of bytes (at most FILE_READER_WINDOW).
+ */
+bool flipper_http_file_reader_next_chunk(FlipperHTTPFileReader *reader, const uint8_t **data, size_t *len);
+
+/**
+ * @brief      Copy the next bytes of the file.
+ * @return     The number of bytes copied, 0 at the end of the file.
+ * @param      reader The reader.
+ * @param      buffer The buffer to copy to.
+ * @param      size   The size of the buffer.
+ */
+size_t flipper_http_file_reader_read(FlipperHTTPFileReader *reader, void *buffer, size_t size);
+
+/**
+ * @brief      Read the next line of the file.
+ * @return     true if a line was read, false at the end of the file.
+ * @param      reader The reader.
+ * @param      line   The buffer for the line, without the trailing "\r\n" and null-terminated.
+ * @param      size   The size of the line buffer. Longer lines are cut, and the rest is skipped.
+ */
+bool flipper_http_file_reader_read_line(FlipperHTTPFileReader *reader, char *line, size_t size);
+
+/**
+ * @brief      Move to a position in the file.
+ * @return     true if the position is inside the file, false otherwise.
+ * @param      reader The reader.
+ * @param      offset The offset from the start of the file.
+ */
+bool flipper_http_file_reader_seek(FlipperHTTPFileReader *reader, size_t offset);
+
+/**
+ * @brief      Get the current position in the file.
+ * @return     The offset of the next byte to be read.
+ * @param      reader The reader.
+ */
+size_t flipper_http_file_reader_tell(FlipperHTTPFileReader *reader);
+
+/**
+ * @brief      Initialize a JSON tokenizer.
+ * @return     void
+ * @param      json     The tokenizer to initialize.
+ * @param      callback The callback for each value.
+ * @param      context  The context for the callback.
+ */
+void flipper_http_json_init(FlipperHTTPJson *json, FlipperHTTPJson_Callback callback, void *context);
+
+/**
+ * @brief      Feed the next piece of a JSON document to a tokenizer.
+ * @return     true if the tokenizer can take more, false after a syntax error or once the callback stopped it.
+ * @param      json The tokenizer.
+ * @param      data The next bytes of the document (tokens may be split anywhere).
+ * @param      len  The number of bytes.
+ */
+bool flipper_http_json_feed(FlipperHTTPJson *json, const char *data, size_t len);
+
+/**
+ * @brief      Tell a tokenizer that the document has ended.
+ * @return     true if a complete JSON document was read, false otherwise.
+ * @param      json The tokenizer.
+ */
+bool flipper_http_json_finish(FlipperHTTPJson *json);
+
+/**
+ * @brief      Run a JSON tokenizer over a file, one window at a time.
+ * @return     true if the file was read without a syntax error (or the callback stopped early), false otherwise.
+ * @param      json      The initialized tokenizer.
+ * @param      file_path The path to the file.
+ */
+bool flipper_http_json_parse_file(FlipperHTTPJson *json, const char *file_path);
+
+/**
+ * @brief      Extract a value from JSON data by its path.
+ * @return     true if the path names a string, number, true, false or null, false otherwise.
+ * @param      json_data The JSON data.
+ * @param      path      The path of the value, for example "data.items[2].name".
+ * @param      value     The buffer for the value (strings without quotes, cut to fit).
+ * @param      size      The size of the buffer.
+ */
+bool flipper_http_json_extract(const char *json_data, const char *path, char *value, size_t size);
+
+/**
+ * @brief      Extract a value from a JSON file by its path, without loading the file.
+ * @return     true if the path names a string, number, true, false or null, false otherwise.
+ * @param      file_path The path to the JSON file, for example a saved response.
+ * @param      path      The path of the value, for example "data.items[2].name".
+ * @param      value     The buffer for the value (strings without quotes, cut to fit).
+ * @param      size      The size of the buffer.
+ * @note       Parsing stops at the value, so values near the start of large files are found quickly.
+ */
+bool flipper_http_json_extract_from_file(const char *file_path, const char *path, char *value, size_t size);
+
 /**
  * @brief      Load data from a file.
  * @return     The loaded data as a FuriString.
  * @param      file_path The path to the file to load.
+ * @note       At most MAX_FILE_SHOW bytes are loaded. Use a FlipperHTTPFileReader for larger files.
  */
 FuriString *flipper_http_load_from_file(char *file_path);
 
@@ -178,6 +505,7 @@ void flipper_http_loading_task(FlipperHTTP *fhttp,
  * @param      key       The key to parse from the JSON data.
  * @param      json_data The JSON data to parse.
  * @note       The received data will be handled asynchronously via the callback.
+ *             flipper_http_json_extract does the same on the Flipper, without a round trip to the board.
  */
 bool flipper_http_parse_json(FlipperHTTP *fhttp, const char *key, const char *json_data);
 
@@ -210,9 +538,75 @@ bool flipper_http_process_response_async(FlipperHTTP *fhttp, bool (*http_request
  * @param      headers  The headers to send with the request.
  * @param      payload  The data to send with the request.
  * @note       The received data will be handled asynchronously via the callback.
+ *             The request's timeouts start before it is written (see flipper_http_timeout_running).
  */
 bool flipper_http_request(FlipperHTTP *fhttp, HTTPMethod method, const char *url, const char *headers, const char *payload);
 
+/**
+ * @brief      Set the default timeouts of requests.
+ * @return     void
+ * @param      fhttp    The FlipperHTTP context
+ * @param      timeouts The timeouts; zero first-byte and idle timeouts mean TIMEOUT_DURATION_TICKS, a zero total means no deadline.
+ * @note       An idle timeout other than TIMEOUT_DURATION_TICKS is also sent to the board for [GET/BYTES] and [POST/BYTES].
+ */
+void flipper_http_set_timeouts(FlipperHTTP *fhttp, const FlipperHTTPTimeouts *timeouts);
+
+/**
+ * @brief      Start the timeouts of the last request again, from now.
+ * @return     void
+ * @param      fhttp The FlipperHTTP context
+ * @note       flipper_http_request and flipper_http_submit start them before the request is written, so this is not needed after them.
+ *             When one runs out, fhttp->state becomes ISSUE. Received bytes, not lines, keep the idle timeout from running out.
+ */
+void flipper_http_timeout_start(FlipperHTTP *fhttp);
+
+/**
+ * @brief      Stop the timeouts of the last request.
+ * @return     void
+ * @param      fhttp The FlipperHTTP context
+ */
+void flipper_http_timeout_stop(FlipperHTTP *fhttp);
+
+/**
+ * @brief      Check if the timeouts of the last request are still running.
+ * @return     true until the response ends, a timeout runs out or flipper_http_timeout_stop is called.
+ * @param      fhttp The FlipperHTTP context
+ */
+bool flipper_http_timeout_running(FlipperHTTP *fhttp);
+
+/**
+ * @brief      Set a callback for the progress of every response (request_id is 0 unless it was submitted).
+ * @return     void
+ * @param      fhttp    The FlipperHTTP context
+ * @param      callback The callback, NULL to remove it. It is called at most every PROGRESS_INTERVAL_MS
+ *                      while a response is received, and once more when it ends.
+ * @param      context  The context for the callback.
+ * @note       fhttp->transfer_stats holds the measurements of the last response that ended.
+ */
+void flipper_http_set_progress_callback(FlipperHTTP *fhttp, FlipperHTTPProgressCallback callback, void *context);
+
+/**
+ * @brief      Queue a request and return at once; its callbacks report the body, progress and result.
+ * @return     The handle of the request, 0 if it could not be queued.
+ * @param      fhttp   The FlipperHTTP context
+ * @param      request The request (its strings are copied).
+ * @note       Requests are sent to the board one after another, each once the previous one ended.
+ *             Do not call flipper_http_request while submitted requests are pending.
+ *             An [ERROR] line fails the request being answered only if no other command was waiting for an
+ *             answer when it was sent, or was sent after it; otherwise its response or a timeout ends it.
+ */
+uint32_t flipper_http_submit(FlipperHTTP *fhttp, const FlipperHTTPRequest *request);
+
+/**
+ * @brief      Cancel a submitted request. A queued request is dropped; for one the board is
+ *             already answering, only its callbacks are dropped (one the worker has
+ *             already picked up may still run once).
+ * @return     true if the request was found, false otherwise.
+ * @param      fhttp      The FlipperHTTP context
+ * @param      request_id The handle returned by flipper_http_submit.
+ */
+bool flipper_http_cancel(FlipperHTTP *fhttp, uint32_t request_id);
+
 /**
  * @brief      Send a command to save WiFi settings.
  * @return     true if the request was successful, false otherwise.
@@ -236,9 +630,51 @@ bool flipper_http_send_command(FlipperHTTP *fhttp, HTTPCommand command);
  * @param fhttp The FlipperHTTP context
  * @param      data  The data to send over UART.
  * @note       The data will be sent over UART with a newline character appended.
+ *             It is written in pieces, so its length is not limited.
  */
 bool flipper_http_send_data(FlipperHTTP *fhttp, const char *data);
 
+/**
+ * @brief      Start a command written in pieces, for commands of any length.
+ * @return     true if the command can be sent, false otherwise.
+ * @param fhttp The FlipperHTTP context
+ * @param      writer The writer to start.
+ * @param      prefix The start of the command, for example "[POST/HTTP]".
+ * @note       Finish it with flipper_http_command_end, which adds the newline.
+ */
+bool flipper_http_command_begin(FlipperHTTP *fhttp, FlipperHTTPCommandWriter *writer, const char *prefix);
+
+/**
+ * @brief      Add text to a command as it is.
+ * @return     void
+ * @param      writer The writer.
+ * @param      text   The text to add.
+ */
+void flipper_http_command_write(FlipperHTTPCommandWriter *writer, const char *text);
+
+/**
+ * @brief      Add a string to a command as a quoted, escaped JSON string.
+ * @return     void
+ * @param      writer The writer.
+ * @param      value  The string to add.
+ */
+void flipper_http_command_write_string(FlipperHTTPCommandWriter *writer, const char *value);
+
+/**
+ * @brief      Add JSON text (an object, array or value) to a command.
+ * @return     void
+ * @param      writer The writer.
+ * @param      json   The JSON to add; line breaks become spaces, since a newline ends the command.
+ */
+void flipper_http_command_write_json(FlipperHTTPCommandWriter *writer, const char *json);
+
+/**
+ * @brief      Finish a command: add the newline and send what is left.
+ * @return     void
+ * @param      writer The writer.
+ */
+void flipper_http_command_end(FlipperHTTPCommandWriter *writer);
+
 /**
  * @brief      Send a request to the specified URL to start a WebSocket connection.
  * @return     true if the request was successful, false otherwise.
@@ -256,4 +692,33 @@ bool flipper_http_websocket_start(FlipperHTTP *fhttp, const char *url, uint16_t
  * @param fhttp The FlipperHTTP context
  * @note       The received data will be handled asynchronously via the callback.
  */
-bool flipper_http_websocket_stop(FlipperHTTP *fhttp);
\ No newline at end of file
+bool flipper_http_websocket_stop(FlipperHTTP *fhttp);
+
+/**
+ * @brief      Send a request to open a WebSocket session that stays open alongside other commands.
+ * @return     true if the request was successful, false otherwise.
+ * @param fhttp The FlipperHTTP context
+ * @param      url  The URL to send the WebSocket request to.
+ * @param port The port to connect to
+ * @param headers The headers to send with the WebSocket request
+ * @note       The board replies with [SOCKET/OPENED]{"id":<id>}; messages from the server arrive as [SOCKET/<id>]<message>.
+ */
+bool flipper_http_websocket_open(FlipperHTTP *fhttp, const char *url, uint16_t port, const char *headers);
+
+/**
+ * @brief      Send a text message on a WebSocket session.
+ * @return     true if the request was successful, false otherwise.
+ * @param fhttp The FlipperHTTP context
+ * @param id The session ID returned in [SOCKET/OPENED]
+ * @param message The message to send (a single line)
+ */
+bool flipper_http_websocket_send(FlipperHTTP *fhttp, uint8_t id, const char *message);
+
+/**
+ * @brief      Send a request to close a WebSocket session.
+ * @return     true if the request was successful, false otherwise.
+ * @param fhttp The FlipperHTTP context
+ * @param id The session ID returned in [SOCKET/OPENED]
+ * @note       The board replies with [SOCKET/CLOSED]{"id":<id>,"reason":"closed"}; "timeout" and "stalled" mark sessions the board closed itself.
+ */
+bool flipper_http_websocket_close(FlipperHTTP *fhttp, uint8_t id);
\ No newline at end of file
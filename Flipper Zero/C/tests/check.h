@@ -0,0 +1,27 @@
+// Minimal test helpers: CHECK records a failure and carries on, the test's main returns check_result()
+#pragma once
+
+#include <stdio.h>
+
+static int check_failures = 0;
+
+#define CHECK(condition)                                                     \
+    do                                                                       \
+    {                                                                        \
+        if (!(condition))                                                    \
+        {                                                                    \
+            fprintf(stderr, "%s:%d: CHECK(%s)\n", __FILE__, __LINE__, #condition); \
+            check_failures++;                                                \
+        }                                                                    \
+    } while (0)
+
+static int check_result(const char *name)
+{
+    if (check_failures > 0)
+    {
+        fprintf(stderr, "%s: %d check(s) failed\n", name, check_failures);
+        return 1;
+    }
+    printf("%s: passed\n", name);
+    return 0;
+}
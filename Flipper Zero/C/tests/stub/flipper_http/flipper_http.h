@@ -0,0 +1,2 @@
+// The client's header, where an app that copies the library into flipper_http/ would find it
+#include "../../../flipper_http.h"
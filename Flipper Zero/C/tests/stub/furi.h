@@ -0,0 +1,116 @@
+// Host stand-ins for the parts of the Flipper SDK that flipper_http.c uses, see stub.c
+#pragma once
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNUSED(x) (void)(x)
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#define APP_DATA_PATH(path) "apps_data/flipper_http/" path
+#define RECORD_STORAGE "storage"
+
+// Logs are printed only when FLIPPER_HTTP_TEST_LOG is set, so expected errors stay quiet
+void furi_log_print(const char *level, const char *tag, const char *format, ...);
+#define FURI_LOG_E(tag, format, ...) furi_log_print("E", tag, format, ##__VA_ARGS__)
+#define FURI_LOG_W(tag, format, ...) furi_log_print("W", tag, format, ##__VA_ARGS__)
+#define FURI_LOG_I(tag, format, ...) furi_log_print("I", tag, format, ##__VA_ARGS__)
+#define FURI_LOG_D(tag, format, ...) furi_log_print("D", tag, format, ##__VA_ARGS__)
+
+typedef enum
+{
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+} FuriStatus;
+
+#define FuriWaitForever 0xFFFFFFFFU
+#define FuriFlagWaitAny 0U
+
+size_t memmgr_heap_get_max_free_block(void);
+
+uint32_t furi_get_tick(void);
+uint32_t furi_kernel_get_tick_frequency(void);
+void furi_delay_ms(uint32_t milliseconds);
+
+void *furi_record_open(const char *name);
+void furi_record_close(const char *name);
+
+// Threads do not run on the host: tests drive the code a worker would run themselves
+typedef struct FuriThread FuriThread;
+typedef void *FuriThreadId;
+typedef int32_t (*FuriThreadCallback)(void *context);
+FuriThread *furi_thread_alloc(void);
+void furi_thread_free(FuriThread *thread);
+void furi_thread_set_name(FuriThread *thread, const char *name);
+void furi_thread_set_stack_size(FuriThread *thread, size_t stack_size);
+void furi_thread_set_context(FuriThread *thread, void *context);
+void furi_thread_set_callback(FuriThread *thread, FuriThreadCallback callback);
+void furi_thread_start(FuriThread *thread);
+bool furi_thread_join(FuriThread *thread);
+FuriThreadId furi_thread_get_id(FuriThread *thread);
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags);
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout);
+
+typedef enum
+{
+    FuriTimerTypeOnce,
+    FuriTimerTypePeriodic,
+} FuriTimerType;
+typedef enum
+{
+    FuriTimerThreadPriorityNormal,
+    FuriTimerThreadPriorityElevated,
+} FuriTimerThreadPriority;
+typedef struct FuriTimer FuriTimer;
+typedef void (*FuriTimerCallback)(void *context);
+FuriTimer *furi_timer_alloc(FuriTimerCallback callback, FuriTimerType type, void *context);
+void furi_timer_free(FuriTimer *timer);
+FuriStatus furi_timer_start(FuriTimer *timer, uint32_t ticks);
+FuriStatus furi_timer_stop(FuriTimer *timer);
+void furi_timer_set_thread_priority(FuriTimerThreadPriority priority);
+bool stub_timer_running(const FuriTimer *timer); // Started and not stopped since
+
+typedef enum
+{
+    FuriMutexTypeNormal,
+    FuriMutexTypeRecursive,
+} FuriMutexType;
+typedef struct FuriMutex FuriMutex;
+FuriMutex *furi_mutex_alloc(FuriMutexType type);
+void furi_mutex_free(FuriMutex *mutex);
+FuriStatus furi_mutex_acquire(FuriMutex *mutex, uint32_t timeout);
+FuriStatus furi_mutex_release(FuriMutex *mutex);
+bool stub_mutex_held(const FuriMutex *mutex); // Acquired and not released since
+
+typedef struct FuriStreamBuffer FuriStreamBuffer;
+FuriStreamBuffer *furi_stream_buffer_alloc(size_t size, size_t trigger_level);
+void furi_stream_buffer_free(FuriStreamBuffer *stream_buffer);
+size_t furi_stream_buffer_send(FuriStreamBuffer *stream_buffer, const void *data, size_t length, uint32_t timeout);
+size_t furi_stream_buffer_receive(FuriStreamBuffer *stream_buffer, void *data, size_t length, uint32_t timeout);
+
+typedef struct FuriString FuriString;
+FuriString *furi_string_alloc(void);
+void furi_string_free(FuriString *string);
+void furi_string_reserve(FuriString *string, size_t size);
+void furi_string_push_back(FuriString *string, char c);
+size_t furi_string_size(const FuriString *string);
+const char *furi_string_get_cstr(const FuriString *string);
+
+// Cycle counter, advanced by furi_get_tick so durations are never zero
+typedef struct
+{
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+extern DWT_Type *DWT;
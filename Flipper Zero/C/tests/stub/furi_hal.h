@@ -0,0 +1,5 @@
+#pragma once
+
+#include <furi.h>
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void);
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <furi.h>
+
+typedef enum
+{
+    FuriHalSerialIdUsart,
+    FuriHalSerialIdLpuart,
+} FuriHalSerialId;
+
+typedef enum
+{
+    FuriHalSerialDirectionTx,
+    FuriHalSerialDirectionRx,
+} FuriHalSerialDirection;
+
+typedef enum
+{
+    FuriHalSerialRxEventData = (1 << 0),
+    FuriHalSerialRxEventIdle = (1 << 1),
+} FuriHalSerialRxEvent;
+
+typedef struct FuriHalSerialHandle FuriHalSerialHandle;
+typedef void (*FuriHalSerialDmaRxCallback)(FuriHalSerialHandle *handle, FuriHalSerialRxEvent event, size_t data_len, void *context);
+
+bool furi_hal_serial_control_is_busy(FuriHalSerialId serial_id);
+FuriHalSerialHandle *furi_hal_serial_control_acquire(FuriHalSerialId serial_id);
+void furi_hal_serial_control_release(FuriHalSerialHandle *handle);
+void furi_hal_serial_init(FuriHalSerialHandle *handle, uint32_t baud);
+void furi_hal_serial_deinit(FuriHalSerialHandle *handle);
+void furi_hal_serial_enable_direction(FuriHalSerialHandle *handle, FuriHalSerialDirection direction);
+void furi_hal_serial_disable_direction(FuriHalSerialHandle *handle, FuriHalSerialDirection direction);
+void furi_hal_serial_dma_rx_start(FuriHalSerialHandle *handle, FuriHalSerialDmaRxCallback callback, void *context, bool report_errors);
+void furi_hal_serial_dma_rx_stop(FuriHalSerialHandle *handle);
+size_t furi_hal_serial_dma_rx(FuriHalSerialHandle *handle, uint8_t *data, size_t len);
+void furi_hal_serial_tx(FuriHalSerialHandle *handle, const uint8_t *buffer, size_t buffer_size);
+void furi_hal_serial_tx_wait_complete(FuriHalSerialHandle *handle);
+
+// Everything written with furi_hal_serial_tx since the last reset, null-terminated
+const char *stub_uart_tx_data(void);
+size_t stub_uart_tx_len(void);
+size_t stub_uart_tx_calls(void);
+void stub_uart_tx_reset(void);
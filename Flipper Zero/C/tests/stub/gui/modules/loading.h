@@ -0,0 +1,8 @@
+#pragma once
+
+#include <gui/view.h>
+
+typedef struct Loading Loading;
+Loading *loading_alloc(void);
+void loading_free(Loading *loading);
+View *loading_get_view(Loading *loading);
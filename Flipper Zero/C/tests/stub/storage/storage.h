@@ -0,0 +1,48 @@
+#pragma once
+
+#include <furi.h>
+
+// Paths are host paths, relative to the directory the test runs in
+typedef struct Storage Storage;
+typedef struct File File;
+
+typedef enum
+{
+    FSAM_READ = (1 << 0),
+    FSAM_WRITE = (1 << 1),
+    FSAM_READ_WRITE = FSAM_READ | FSAM_WRITE,
+} FS_AccessMode;
+
+typedef enum
+{
+    FSOM_OPEN_EXISTING = 1,
+    FSOM_OPEN_ALWAYS = 2,
+    FSOM_OPEN_APPEND = 4,
+    FSOM_CREATE_NEW = 8,
+    FSOM_CREATE_ALWAYS = 16,
+} FS_OpenMode;
+
+typedef enum
+{
+    FSE_OK,
+    FSE_NOT_READY,
+    FSE_EXIST,
+    FSE_NOT_EXIST,
+    FSE_INVALID_PARAMETER,
+    FSE_DENIED,
+    FSE_INVALID_NAME,
+    FSE_INTERNAL,
+} FS_Error;
+
+File *storage_file_alloc(Storage *storage);
+void storage_file_free(File *file);
+bool storage_file_open(File *file, const char *path, FS_AccessMode access_mode, FS_OpenMode open_mode);
+bool storage_file_close(File *file);
+size_t storage_file_read(File *file, void *buff, size_t bytes_to_read);
+size_t storage_file_write(File *file, const void *buff, size_t bytes_to_write);
+void stub_storage_fail_writes(bool fail); // Make every write fail while set
+bool storage_file_seek(File *file, uint32_t offset, bool from_start);
+uint64_t storage_file_size(File *file);
+FS_Error storage_file_get_error(File *file);
+bool storage_file_exists(Storage *storage, const char *path);
+bool storage_simply_remove_recursive(Storage *storage, const char *path);
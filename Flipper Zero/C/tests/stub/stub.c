@@ -0,0 +1,588 @@
+// Host implementations of the stub SDK headers: enough for flipper_http.c to link and for the
+// tests to call its parsing, matching and command writing code directly.
+#include <furi.h>
+#include <furi_hal.h>
+#include <furi_hal_serial.h>
+#include <gui/modules/loading.h>
+#include <gui/view_dispatcher.h>
+#include <storage/storage.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+static DWT_Type dwt;
+DWT_Type *DWT = &dwt;
+
+void furi_log_print(const char *level, const char *tag, const char *format, ...)
+{
+    if (!getenv("FLIPPER_HTTP_TEST_LOG"))
+    {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "[%s][%s] ", level, tag);
+    vfprintf(stderr, format, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+}
+
+size_t memmgr_heap_get_max_free_block(void)
+{
+    return 64 * 1024; // about what a Flipper app has
+}
+
+uint32_t furi_get_tick(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    dwt.CYCCNT += 64;
+    return (uint32_t)(now.tv_sec * 1000 + now.tv_nsec / 1000000);
+}
+
+uint32_t furi_kernel_get_tick_frequency(void)
+{
+    return 1000;
+}
+
+void furi_delay_ms(uint32_t milliseconds)
+{
+    usleep(milliseconds * 1000);
+}
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void)
+{
+    return 64;
+}
+
+// Records have no state on the host, any non-NULL pointer will do
+static int record;
+
+void *furi_record_open(const char *name)
+{
+    UNUSED(name);
+    return &record;
+}
+
+void furi_record_close(const char *name)
+{
+    UNUSED(name);
+}
+
+struct FuriThread
+{
+    int unused;
+};
+
+FuriThread *furi_thread_alloc(void)
+{
+    return calloc(1, sizeof(FuriThread));
+}
+
+void furi_thread_free(FuriThread *thread)
+{
+    free(thread);
+}
+
+void furi_thread_set_name(FuriThread *thread, const char *name)
+{
+    UNUSED(thread);
+    UNUSED(name);
+}
+
+void furi_thread_set_stack_size(FuriThread *thread, size_t stack_size)
+{
+    UNUSED(thread);
+    UNUSED(stack_size);
+}
+
+void furi_thread_set_context(FuriThread *thread, void *context)
+{
+    UNUSED(thread);
+    UNUSED(context);
+}
+
+void furi_thread_set_callback(FuriThread *thread, FuriThreadCallback callback)
+{
+    UNUSED(thread);
+    UNUSED(callback);
+}
+
+void furi_thread_start(FuriThread *thread)
+{
+    UNUSED(thread);
+}
+
+bool furi_thread_join(FuriThread *thread)
+{
+    UNUSED(thread);
+    return true;
+}
+
+FuriThreadId furi_thread_get_id(FuriThread *thread)
+{
+    return thread;
+}
+
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags)
+{
+    UNUSED(thread_id);
+    return flags;
+}
+
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout)
+{
+    UNUSED(options);
+    UNUSED(timeout);
+    return flags;
+}
+
+struct FuriTimer
+{
+    bool running;
+};
+
+FuriTimer *furi_timer_alloc(FuriTimerCallback callback, FuriTimerType type, void *context)
+{
+    UNUSED(callback);
+    UNUSED(type);
+    UNUSED(context);
+    return calloc(1, sizeof(FuriTimer));
+}
+
+void furi_timer_free(FuriTimer *timer)
+{
+    free(timer);
+}
+
+FuriStatus furi_timer_start(FuriTimer *timer, uint32_t ticks)
+{
+    UNUSED(ticks);
+    timer->running = true;
+    return FuriStatusOk;
+}
+
+FuriStatus furi_timer_stop(FuriTimer *timer)
+{
+    timer->running = false;
+    return FuriStatusOk;
+}
+
+void furi_timer_set_thread_priority(FuriTimerThreadPriority priority)
+{
+    UNUSED(priority);
+}
+
+bool stub_timer_running(const FuriTimer *timer)
+{
+    return timer->running;
+}
+
+// Mutexes count how deep they are held, a normal one taken twice would deadlock on the Flipper
+struct FuriMutex
+{
+    FuriMutexType type;
+    int held;
+};
+
+FuriMutex *furi_mutex_alloc(FuriMutexType type)
+{
+    FuriMutex *mutex = calloc(1, sizeof(FuriMutex));
+    mutex->type = type;
+    return mutex;
+}
+
+void furi_mutex_free(FuriMutex *mutex)
+{
+    free(mutex);
+}
+
+FuriStatus furi_mutex_acquire(FuriMutex *mutex, uint32_t timeout)
+{
+    UNUSED(timeout);
+    if (mutex->type == FuriMutexTypeNormal && mutex->held > 0)
+    {
+        fprintf(stderr, "furi_mutex_acquire: normal mutex taken again by its holder\n");
+        abort();
+    }
+    mutex->held++;
+    return FuriStatusOk;
+}
+
+FuriStatus furi_mutex_release(FuriMutex *mutex)
+{
+    mutex->held--;
+    return FuriStatusOk;
+}
+
+bool stub_mutex_held(const FuriMutex *mutex)
+{
+    return mutex->held > 0;
+}
+
+// Byte queue, so tests can hand the worker's code received blocks
+struct FuriStreamBuffer
+{
+    uint8_t *data;
+    size_t size;
+    size_t head;
+    size_t len;
+};
+
+FuriStreamBuffer *furi_stream_buffer_alloc(size_t size, size_t trigger_level)
+{
+    UNUSED(trigger_level);
+    FuriStreamBuffer *stream_buffer = calloc(1, sizeof(FuriStreamBuffer));
+    if (stream_buffer)
+    {
+        stream_buffer->data = malloc(size);
+        stream_buffer->size = size;
+    }
+    return stream_buffer;
+}
+
+void furi_stream_buffer_free(FuriStreamBuffer *stream_buffer)
+{
+    if (stream_buffer)
+    {
+        free(stream_buffer->data);
+        free(stream_buffer);
+    }
+}
+
+size_t furi_stream_buffer_send(FuriStreamBuffer *stream_buffer, const void *data, size_t length, uint32_t timeout)
+{
+    UNUSED(timeout);
+    size_t sent = 0;
+    while (sent < length && stream_buffer->len < stream_buffer->size)
+    {
+        stream_buffer->data[(stream_buffer->head + stream_buffer->len++) % stream_buffer->size] = ((const uint8_t *)data)[sent++];
+    }
+    return sent;
+}
+
+size_t furi_stream_buffer_receive(FuriStreamBuffer *stream_buffer, void *data, size_t length, uint32_t timeout)
+{
+    UNUSED(timeout);
+    size_t received = 0;
+    while (received < length && stream_buffer->len > 0)
+    {
+        ((uint8_t *)data)[received++] = stream_buffer->data[stream_buffer->head];
+        stream_buffer->head = (stream_buffer->head + 1) % stream_buffer->size;
+        stream_buffer->len--;
+    }
+    return received;
+}
+
+struct FuriString
+{
+    char *data;
+    size_t len;
+    size_t capacity;
+};
+
+FuriString *furi_string_alloc(void)
+{
+    FuriString *string = calloc(1, sizeof(FuriString));
+    if (string)
+    {
+        furi_string_reserve(string, 16);
+    }
+    return string;
+}
+
+void furi_string_free(FuriString *string)
+{
+    if (string)
+    {
+        free(string->data);
+        free(string);
+    }
+}
+
+void furi_string_reserve(FuriString *string, size_t size)
+{
+    if (size + 1 > string->capacity)
+    {
+        string->data = realloc(string->data, size + 1);
+        string->capacity = size + 1;
+        string->data[string->len] = '\0';
+    }
+}
+
+void furi_string_push_back(FuriString *string, char c)
+{
+    if (string->len + 1 >= string->capacity)
+    {
+        furi_string_reserve(string, string->capacity * 2);
+    }
+    string->data[string->len++] = c;
+    string->data[string->len] = '\0';
+}
+
+size_t furi_string_size(const FuriString *string)
+{
+    return string->len;
+}
+
+const char *furi_string_get_cstr(const FuriString *string)
+{
+    return string->data;
+}
+
+// UART: writes are collected for the tests, nothing is ever received
+static char *tx_data;
+static size_t tx_len;
+static size_t tx_capacity;
+static size_t tx_calls;
+static int serial_handle;
+
+bool furi_hal_serial_control_is_busy(FuriHalSerialId serial_id)
+{
+    UNUSED(serial_id);
+    return false;
+}
+
+FuriHalSerialHandle *furi_hal_serial_control_acquire(FuriHalSerialId serial_id)
+{
+    UNUSED(serial_id);
+    return (FuriHalSerialHandle *)&serial_handle;
+}
+
+void furi_hal_serial_control_release(FuriHalSerialHandle *handle)
+{
+    UNUSED(handle);
+}
+
+void furi_hal_serial_init(FuriHalSerialHandle *handle, uint32_t baud)
+{
+    UNUSED(handle);
+    UNUSED(baud);
+}
+
+void furi_hal_serial_deinit(FuriHalSerialHandle *handle)
+{
+    UNUSED(handle);
+}
+
+void furi_hal_serial_enable_direction(FuriHalSerialHandle *handle, FuriHalSerialDirection direction)
+{
+    UNUSED(handle);
+    UNUSED(direction);
+}
+
+void furi_hal_serial_disable_direction(FuriHalSerialHandle *handle, FuriHalSerialDirection direction)
+{
+    UNUSED(handle);
+    UNUSED(direction);
+}
+
+void furi_hal_serial_dma_rx_start(FuriHalSerialHandle *handle, FuriHalSerialDmaRxCallback callback, void *context, bool report_errors)
+{
+    UNUSED(handle);
+    UNUSED(callback);
+    UNUSED(context);
+    UNUSED(report_errors);
+}
+
+void furi_hal_serial_dma_rx_stop(FuriHalSerialHandle *handle)
+{
+    UNUSED(handle);
+}
+
+size_t furi_hal_serial_dma_rx(FuriHalSerialHandle *handle, uint8_t *data, size_t len)
+{
+    UNUSED(handle);
+    UNUSED(data);
+    UNUSED(len);
+    return 0;
+}
+
+void furi_hal_serial_tx(FuriHalSerialHandle *handle, const uint8_t *buffer, size_t buffer_size)
+{
+    UNUSED(handle);
+    if (tx_len + buffer_size + 1 > tx_capacity)
+    {
+        tx_capacity = (tx_len + buffer_size + 1) * 2;
+        tx_data = realloc(tx_data, tx_capacity);
+    }
+    memcpy(tx_data + tx_len, buffer, buffer_size);
+    tx_len += buffer_size;
+    tx_data[tx_len] = '\0';
+    tx_calls++;
+}
+
+void furi_hal_serial_tx_wait_complete(FuriHalSerialHandle *handle)
+{
+    UNUSED(handle);
+}
+
+const char *stub_uart_tx_data(void)
+{
+    return tx_data ? tx_data : "";
+}
+
+size_t stub_uart_tx_len(void)
+{
+    return tx_len;
+}
+
+size_t stub_uart_tx_calls(void)
+{
+    return tx_calls;
+}
+
+void stub_uart_tx_reset(void)
+{
+    tx_len = 0;
+    tx_calls = 0;
+    if (tx_data)
+    {
+        tx_data[0] = '\0';
+    }
+}
+
+// GUI: nothing is drawn on the host
+struct Loading
+{
+    int unused;
+};
+
+Loading *loading_alloc(void)
+{
+    return calloc(1, sizeof(Loading));
+}
+
+void loading_free(Loading *loading)
+{
+    free(loading);
+}
+
+View *loading_get_view(Loading *loading)
+{
+    return (View *)loading;
+}
+
+void view_dispatcher_add_view(ViewDispatcher *view_dispatcher, uint32_t view_id, View *view)
+{
+    UNUSED(view_dispatcher);
+    UNUSED(view_id);
+    UNUSED(view);
+}
+
+void view_dispatcher_remove_view(ViewDispatcher *view_dispatcher, uint32_t view_id)
+{
+    UNUSED(view_dispatcher);
+    UNUSED(view_id);
+}
+
+void view_dispatcher_switch_to_view(ViewDispatcher *view_dispatcher, uint32_t view_id)
+{
+    UNUSED(view_dispatcher);
+    UNUSED(view_id);
+}
+
+// Storage: files are host files
+struct File
+{
+    FILE *stream;
+    FS_Error error;
+};
+
+File *storage_file_alloc(Storage *storage)
+{
+    UNUSED(storage);
+    return calloc(1, sizeof(File));
+}
+
+void storage_file_free(File *file)
+{
+    if (file && file->stream)
+    {
+        fclose(file->stream);
+    }
+    free(file);
+}
+
+bool storage_file_open(File *file, const char *path, FS_AccessMode access_mode, FS_OpenMode open_mode)
+{
+    const char *mode = "rb";
+    if ((access_mode & FSAM_WRITE) && open_mode == FSOM_OPEN_APPEND)
+    {
+        mode = "ab";
+    }
+    else if ((access_mode & FSAM_WRITE) && open_mode == FSOM_OPEN_EXISTING)
+    {
+        mode = "r+b";
+    }
+    else if (access_mode & FSAM_WRITE)
+    {
+        mode = "wb";
+    }
+    file->stream = fopen(path, mode);
+    file->error = file->stream ? FSE_OK : FSE_NOT_EXIST;
+    return file->stream != NULL;
+}
+
+bool storage_file_close(File *file)
+{
+    if (!file->stream)
+    {
+        return false;
+    }
+    bool ok = fclose(file->stream) == 0;
+    file->stream = NULL;
+    return ok;
+}
+
+size_t storage_file_read(File *file, void *buff, size_t bytes_to_read)
+{
+    size_t n = fread(buff, 1, bytes_to_read, file->stream);
+    file->error = ferror(file->stream) ? FSE_INTERNAL : FSE_OK;
+    return n;
+}
+
+// Writes fail while set, as on a full or removed SD card
+static bool fail_writes;
+
+void stub_storage_fail_writes(bool fail)
+{
+    fail_writes = fail;
+}
+
+size_t storage_file_write(File *file, const void *buff, size_t bytes_to_write)
+{
+    size_t n = fail_writes ? 0 : fwrite(buff, 1, bytes_to_write, file->stream);
+    file->error = n == bytes_to_write ? FSE_OK : FSE_INTERNAL;
+    return n;
+}
+
+bool storage_file_seek(File *file, uint32_t offset, bool from_start)
+{
+    bool ok = fseek(file->stream, (long)offset, from_start ? SEEK_SET : SEEK_CUR) == 0;
+    file->error = ok ? FSE_OK : FSE_INVALID_PARAMETER;
+    return ok;
+}
+
+uint64_t storage_file_size(File *file)
+{
+    struct stat info;
+    return fstat(fileno(file->stream), &info) == 0 ? (uint64_t)info.st_size : 0;
+}
+
+FS_Error storage_file_get_error(File *file)
+{
+    return file->error;
+}
+
+bool storage_file_exists(Storage *storage, const char *path)
+{
+    UNUSED(storage);
+    return access(path, F_OK) == 0;
+}
+
+bool storage_simply_remove_recursive(Storage *storage, const char *path)
+{
+    UNUSED(storage);
+    return remove(path) == 0;
+}
@@ -0,0 +1,122 @@
+// Command writer: long commands are written in 64-byte pieces, fields are escaped and read back intact
+#include "../flipper_http.c"
+#include "check.h"
+
+// Function to check the framing of the command just written and return its JSON (after prefix), or NULL
+static char *sent_json(const char *prefix)
+{
+    const char *sent = stub_uart_tx_data();
+    size_t len = stub_uart_tx_len();
+    size_t prefix_len = strlen(prefix);
+    CHECK(len > prefix_len && strncmp(sent, prefix, prefix_len) == 0);
+    CHECK(len > 0 && sent[len - 1] == '\n');
+    CHECK(strlen(sent) == len);
+
+    // One line, written a full buffer at a time
+    CHECK(memchr(sent, '\n', len) == sent + len - 1);
+    CHECK(memchr(sent, '\r', len) == NULL);
+    CHECK(stub_uart_tx_calls() == (len + COMMAND_WRITER_BUFFER - 1) / COMMAND_WRITER_BUFFER);
+    if (len <= prefix_len)
+    {
+        return NULL;
+    }
+    return strndup(sent + prefix_len, len - prefix_len - 1);
+}
+
+static void test_request(FlipperHTTP *fhttp)
+{
+    // A URL that breaks JSON when pasted in with %s
+    const char *url = "https://example.com/a\"b\\c?d=\x01\x1f&e=\t\r\nend/caf\xc3\xa9";
+    const char *headers = "{\"Content-Type\": \"application/json\",\n \"X-Key\": \"k\\\"ey\"}";
+
+    // A multi-line payload of about 3 KB, the old limit was 512 bytes for the whole command
+    char *payload = malloc(8192);
+    size_t n = (size_t)sprintf(payload, "{\n  \"items\": [");
+    for (int i = 0; i < 90; i++)
+    {
+        n += (size_t)sprintf(payload + n, "%s\r\n    {\"id\": %d, \"text\": \"line\\n%d\"}", i ? "," : "", i, i);
+    }
+    sprintf(payload + n, "\n  ],\n  \"last\": \"ok\"\n}\n");
+    CHECK(strlen(payload) > 3000);
+
+    stub_uart_tx_reset();
+    CHECK(flipper_http_request(fhttp, POST, url, headers, payload));
+    CHECK(fhttp->state == IDLE);
+    char *json = sent_json("[POST/HTTP]");
+    char value[128];
+    if (json)
+    {
+        CHECK(flipper_http_json_extract(json, "url", value, sizeof(value)));
+        CHECK(strcmp(value, url) == 0);
+        CHECK(flipper_http_json_extract(json, "headers.X-Key", value, sizeof(value)));
+        CHECK(strcmp(value, "k\"ey") == 0);
+        CHECK(flipper_http_json_extract(json, "payload.items[89].text", value, sizeof(value)));
+        CHECK(strcmp(value, "line\n89") == 0);
+        CHECK(flipper_http_json_extract(json, "payload.last", value, sizeof(value)));
+        CHECK(strcmp(value, "ok") == 0);
+        free(json);
+    }
+    free(payload);
+
+    // GET without headers keeps the short form
+    stub_uart_tx_reset();
+    CHECK(flipper_http_request(fhttp, GET, "http://example.com/x", NULL, NULL));
+    CHECK(strcmp(stub_uart_tx_data(), "[GET]http://example.com/x\n") == 0);
+}
+
+static void test_save_wifi(FlipperHTTP *fhttp)
+{
+    const char *ssid = "Caf\xc3\xa9 \"Guest\"";
+    const char *password = "p\\a\"ss\x7f\x02";
+    stub_uart_tx_reset();
+    CHECK(flipper_http_save_wifi(fhttp, ssid, password));
+    char *json = sent_json("[WIFI/SAVE]");
+    char value[64];
+    if (json)
+    {
+        CHECK(strstr(json, "\\u0002") != NULL);
+        CHECK(flipper_http_json_extract(json, "ssid", value, sizeof(value)));
+        CHECK(strcmp(value, ssid) == 0);
+        CHECK(flipper_http_json_extract(json, "password", value, sizeof(value)));
+        CHECK(strcmp(value, password) == 0);
+        free(json);
+    }
+}
+
+static void test_send_data(FlipperHTTP *fhttp)
+{
+    // Sent as it is, at any length
+    char data[2000];
+    memset(data, 'x', sizeof(data) - 1);
+    data[sizeof(data) - 1] = '\0';
+    memcpy(data, "[PARSE]", 7);
+    stub_uart_tx_reset();
+    CHECK(flipper_http_send_data(fhttp, data));
+    CHECK(stub_uart_tx_len() == sizeof(data));
+    CHECK(strncmp(stub_uart_tx_data(), data, sizeof(data) - 1) == 0);
+    CHECK(stub_uart_tx_calls() == (sizeof(data) + COMMAND_WRITER_BUFFER - 1) / COMMAND_WRITER_BUFFER);
+
+    // Nothing goes out while the board has not answered a [PING]
+    fhttp->state = INACTIVE;
+    stub_uart_tx_reset();
+    CHECK(!flipper_http_send_data(fhttp, "[LIST]"));
+    CHECK(stub_uart_tx_len() == 0);
+    CHECK(flipper_http_send_data(fhttp, "[PING]"));
+    CHECK(strcmp(stub_uart_tx_data(), "[PING]\n") == 0);
+    fhttp->state = IDLE;
+}
+
+int main(void)
+{
+    FlipperHTTP *fhttp = flipper_http_alloc();
+    CHECK(fhttp != NULL);
+    if (!fhttp)
+    {
+        return check_result("test_command_writer");
+    }
+    test_request(fhttp);
+    test_save_wifi(fhttp);
+    test_send_data(fhttp);
+    flipper_http_free(fhttp);
+    return check_result("test_command_writer");
+}
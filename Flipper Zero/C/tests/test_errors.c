@@ -0,0 +1,149 @@
+// Failed requests: [ERROR] lines fail a submitted request only when no other command can have printed them,
+// a save that fails ends the request, and the callbacks never run with the request queue locked
+#include "../flipper_http.c"
+#include "check.h"
+
+static int completions;
+static bool last_success;
+
+static void on_chunk(uint32_t request_id, const uint8_t *data, size_t len, void *context)
+{
+    UNUSED(request_id);
+    UNUSED(data);
+    UNUSED(len);
+    CHECK(!stub_mutex_held(((FlipperHTTP *)context)->queue_mutex));
+}
+
+static void on_complete(uint32_t request_id, bool success, int status_code, void *context)
+{
+    UNUSED(request_id);
+    UNUSED(status_code);
+    CHECK(!stub_mutex_held(((FlipperHTTP *)context)->queue_mutex));
+    completions++;
+    last_success = success;
+}
+
+// Function to queue a GET with the test's callbacks, saved to file_path unless it is NULL
+static uint32_t submit_to(FlipperHTTP *fhttp, const char *file_path)
+{
+    FlipperHTTPRequest request = {0};
+    request.method = GET;
+    request.url = "http://example.com/json";
+    request.file_path = file_path;
+    request.on_chunk = on_chunk;
+    request.on_complete = on_complete;
+    request.context = fhttp;
+    return flipper_http_submit(fhttp, &request);
+}
+
+// Function to queue a GET with the test's callbacks
+static uint32_t submit(FlipperHTTP *fhttp)
+{
+    completions = 0;
+    return submit_to(fhttp, NULL);
+}
+
+// Function to answer the request being sent with a whole text response
+static void respond(FlipperHTTP *fhttp)
+{
+    flipper_http_rx_callback("[GET/SUCCESS]{\"Status-Code\":200,\"Content-Length\":2}", fhttp);
+    flipper_http_rx_callback("{}", fhttp);
+    flipper_http_rx_callback("[GET/END]", fhttp);
+}
+
+static void test_request_error(FlipperHTTP *fhttp)
+{
+    // The board had nothing else to answer, so the error is the request's
+    CHECK(submit(fhttp) != 0);
+    flipper_http_rx_callback("[ERROR] GET request failed or returned empty data.", fhttp);
+    CHECK(completions == 1 && !last_success);
+    CHECK(fhttp->queue_count == 0);
+}
+
+static void test_error_of_earlier_command(FlipperHTTP *fhttp)
+{
+    // A WebSocket message sent before the request: its [ERROR] comes first and must not fail the request
+    fhttp->state = IDLE;
+    CHECK(flipper_http_websocket_send(fhttp, 3, "hello"));
+    CHECK(submit(fhttp) != 0);
+    flipper_http_rx_callback("[ERROR] Invalid WebSocket session.", fhttp);
+    CHECK(completions == 0);
+    respond(fhttp);
+    CHECK(completions == 1 && last_success);
+}
+
+static void test_error_of_later_command(FlipperHTTP *fhttp)
+{
+    // A [PARSE] sent while the request is waiting
+    fhttp->state = IDLE;
+    CHECK(submit(fhttp) != 0);
+    CHECK(flipper_http_send_data(fhttp, "[PARSE]{\"key\":\"a\",\"json\":{}}"));
+    flipper_http_rx_callback("[ERROR] Key not found in JSON.", fhttp);
+    CHECK(completions == 0);
+    respond(fhttp);
+    CHECK(completions == 1 && last_success);
+}
+
+static void test_socket_messages(FlipperHTTP *fhttp)
+{
+    // Messages of an open session are not answers: a command sent before them may still print an error
+    fhttp->state = IDLE;
+    CHECK(flipper_http_send_data(fhttp, "[LED/ON]"));
+    flipper_http_rx_callback("[SOCKET/0]hello", fhttp);
+    CHECK(submit(fhttp) != 0);
+    flipper_http_rx_callback("[ERROR] Invalid WebSocket session.", fhttp);
+    CHECK(completions == 0);
+
+    // Once a request is answered, the board is past the commands sent before it
+    respond(fhttp);
+    CHECK(completions == 1 && last_success);
+    fhttp->state = IDLE;
+    CHECK(submit(fhttp) != 0);
+    flipper_http_rx_callback("[ERROR] Unable to connect to the server.", fhttp);
+    CHECK(completions == 1 && !last_success);
+}
+
+static void test_save_failure(FlipperHTTP *fhttp)
+{
+    // The SD card fails partway through a saved response: the request fails and the next one is sent
+    const char *file_path = "test_errors.txt";
+    fhttp->state = IDLE;
+    completions = 0;
+    CHECK(submit_to(fhttp, file_path) != 0);
+    CHECK(submit_to(fhttp, NULL) != 0);
+    flipper_http_rx_callback("[GET/SUCCESS]{\"Status-Code\":200}", fhttp);
+    char line[1024];
+    memset(line, 'x', sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+    stub_storage_fail_writes(true);
+    for (int i = 0; i < 8 && completions == 0; i++)
+    {
+        flipper_http_rx_callback(line, fhttp);
+    }
+    stub_storage_fail_writes(false);
+    CHECK(completions == 1 && !last_success);
+    CHECK(fhttp->file_sink.file == NULL);
+    CHECK(fhttp->queue_count == 1 && fhttp->queue[fhttp->queue_head].sent);
+
+    respond(fhttp);
+    CHECK(completions == 2 && last_success);
+    CHECK(!flipper_http_timeout_running(fhttp));
+    remove(file_path);
+}
+
+int main(void)
+{
+    FlipperHTTP *fhttp = flipper_http_alloc();
+    CHECK(fhttp != NULL);
+    if (!fhttp)
+    {
+        return check_result("test_errors");
+    }
+    test_request_error(fhttp);
+    test_error_of_earlier_command(fhttp);
+    test_error_of_later_command(fhttp);
+    test_socket_messages(fhttp);
+    test_save_failure(fhttp);
+    flipper_http_free(fhttp);
+    return check_result("test_errors");
+}
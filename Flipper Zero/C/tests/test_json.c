@@ -0,0 +1,217 @@
+// JSON tokenizer: documents fed whole, split at every offset and byte by byte must give the same events
+#include "../flipper_http.c"
+#include "check.h"
+
+#define LOG_SIZE 4096
+
+// Events of one run, written as "event path=value;"
+typedef struct
+{
+    char text[LOG_SIZE];
+    size_t len;
+} EventLog;
+
+static bool log_event(FlipperHTTPJsonEvent event, const char *path, const char *value, size_t value_len, void *context)
+{
+    static const char *names[] = {"{", "}", "[", "]", "str", "num", "true", "false", "null"};
+    EventLog *log = (EventLog *)context;
+    int n = snprintf(log->text + log->len, LOG_SIZE - log->len, "%s %s=", names[event], path);
+    log->len += (size_t)n;
+    CHECK(strlen(value) == value_len);
+    CHECK(log->len + value_len + 2 < LOG_SIZE);
+    memcpy(log->text + log->len, value, value_len);
+    log->len += value_len;
+    log->text[log->len++] = ';';
+    log->text[log->len] = '\0';
+    return true;
+}
+
+// Function to tokenize a document in pieces of at most piece bytes (the first one cut at split)
+static bool tokenize(const char *document, size_t split, size_t piece, EventLog *log)
+{
+    FlipperHTTPJson json;
+    memset(log, 0, sizeof(EventLog));
+    flipper_http_json_init(&json, log_event, log);
+    size_t len = strlen(document);
+    size_t pos = MIN(split, len);
+    bool ok = flipper_http_json_feed(&json, document, pos);
+    while (ok && pos < len)
+    {
+        size_t n = MIN(piece, len - pos);
+        ok = flipper_http_json_feed(&json, document + pos, n);
+        pos += n;
+    }
+    return ok && flipper_http_json_finish(&json);
+}
+
+static void test_events(void)
+{
+    const char *document =
+        " {\"data\": {\"items\": [{\"name\": \"a\\\"b\\\\c\\/\"}, 12, -3.5e+2, true, false, null,"
+        " {\"name\": \"caf\\u00e9 \\ud83d\\ude00\\n\\t\"}], \"empty\": {}, \"none\": []}, \"id\": 0}\r\n";
+    const char *expected =
+        "{ =;"
+        "{ data=;"
+        "[ data.items=;"
+        "{ data.items[0]=;"
+        "str data.items[0].name=a\"b\\c/;"
+        "} data.items[0]=;"
+        "num data.items[1]=12;"
+        "num data.items[2]=-3.5e+2;"
+        "true data.items[3]=true;"
+        "false data.items[4]=false;"
+        "null data.items[5]=null;"
+        "{ data.items[6]=;"
+        "str data.items[6].name=caf\xc3\xa9 \xf0\x9f\x98\x80\n\t;"
+        "} data.items[6]=;"
+        "] data.items=;"
+        "{ data.empty=;"
+        "} data.empty=;"
+        "[ data.none=;"
+        "] data.none=;"
+        "} data=;"
+        "num id=0;"
+        "} =;";
+
+    EventLog whole;
+    CHECK(tokenize(document, strlen(document), 1, &whole));
+    CHECK(strcmp(whole.text, expected) == 0);
+    if (strcmp(whole.text, expected) != 0)
+    {
+        fprintf(stderr, "got:      %s\nexpected: %s\n", whole.text, expected);
+    }
+
+    // Every split into two pieces, and one byte at a time
+    EventLog split;
+    for (size_t i = 0; i <= strlen(document); i++)
+    {
+        CHECK(tokenize(document, i, strlen(document), &split));
+        CHECK(strcmp(split.text, whole.text) == 0);
+    }
+    CHECK(tokenize(document, 0, 1, &split));
+    CHECK(strcmp(split.text, whole.text) == 0);
+}
+
+static void test_top_level_values(void)
+{
+    EventLog log;
+    CHECK(tokenize("42", 1, 1, &log));
+    CHECK(strcmp(log.text, "num =42;") == 0);
+    CHECK(tokenize(" \"x\" ", 2, 1, &log));
+    CHECK(strcmp(log.text, "str =x;") == 0);
+    CHECK(tokenize("null", 2, 2, &log));
+    CHECK(strcmp(log.text, "null =null;") == 0);
+}
+
+static void test_malformed(void)
+{
+    static const char *documents[] = {
+        "",
+        "{",
+        "{\"a\":}",
+        "{\"a\" 1}",
+        "{\"a\":1,}",
+        "[1,]",
+        "[1 2]",
+        "{\"a\":1}}",
+        "{\"a\":1} 2",
+        "[}",
+        "{]",
+        "tru",
+        "trux",
+        "\"abc",
+        "\"\\x\"",
+        "\"\\u12G4\"",
+        "{1:2}",
+        "[1,,2]",
+        "nul",
+    };
+    EventLog log;
+    for (size_t d = 0; d < COUNT_OF(documents); d++)
+    {
+        size_t len = strlen(documents[d]);
+        for (size_t i = 0; i <= len; i++)
+        {
+            bool ok = tokenize(documents[d], i, 1, &log);
+            CHECK(!ok);
+            if (ok)
+            {
+                fprintf(stderr, "accepted: %s\n", documents[d]);
+            }
+        }
+    }
+}
+
+static void test_long_values_are_cut(void)
+{
+    char document[JSON_TOKEN_SIZE * 3];
+    size_t n = 0;
+    document[n++] = '"';
+    for (size_t i = 0; i < JSON_TOKEN_SIZE * 2; i++)
+    {
+        document[n++] = 'a' + (char)(i % 26);
+    }
+    document[n++] = '"';
+    document[n] = '\0';
+    char value[JSON_TOKEN_SIZE * 2];
+    CHECK(flipper_http_json_extract(document, "", value, sizeof(value)));
+    CHECK(strlen(value) == JSON_TOKEN_SIZE - 1);
+    CHECK(strncmp(value, document + 1, JSON_TOKEN_SIZE - 1) == 0);
+}
+
+static void test_extract(void)
+{
+    const char *document = "{\"fact\":\"Cats sleep\",\"length\":10,\"data\":{\"items\":[{\"name\":\"x\"},{\"name\":\"y\"}]}}";
+    char value[32];
+    CHECK(flipper_http_json_extract(document, "fact", value, sizeof(value)));
+    CHECK(strcmp(value, "Cats sleep") == 0);
+    CHECK(flipper_http_json_extract(document, "length", value, sizeof(value)));
+    CHECK(strcmp(value, "10") == 0);
+    CHECK(flipper_http_json_extract(document, "data.items[1].name", value, sizeof(value)));
+    CHECK(strcmp(value, "y") == 0);
+    CHECK(!flipper_http_json_extract(document, "data.items", value, sizeof(value))); // not a single value
+    CHECK(!flipper_http_json_extract(document, "missing", value, sizeof(value)));
+
+    // Cut to the buffer
+    char small[5];
+    CHECK(flipper_http_json_extract(document, "fact", small, sizeof(small)));
+    CHECK(strcmp(small, "Cats") == 0);
+}
+
+static void test_extract_from_file(void)
+{
+    // Many times the file reader's window, with the wanted value at the end
+    const char *file_path = "test_json.json";
+    FILE *file = fopen(file_path, "wb");
+    CHECK(file != NULL);
+    if (!file)
+    {
+        return;
+    }
+    fputs("{\"items\":[", file);
+    for (int i = 0; i < 2000; i++)
+    {
+        fprintf(file, "%s{\"id\":%d,\"name\":\"item %d\"}", i ? "," : "", i, i);
+    }
+    fputs("],\"last\":\"end\"}", file);
+    fclose(file);
+
+    char value[32];
+    CHECK(flipper_http_json_extract_from_file(file_path, "items[1999].name", value, sizeof(value)));
+    CHECK(strcmp(value, "item 1999") == 0);
+    CHECK(flipper_http_json_extract_from_file(file_path, "last", value, sizeof(value)));
+    CHECK(strcmp(value, "end") == 0);
+    CHECK(!flipper_http_json_extract_from_file(file_path, "items[2000].name", value, sizeof(value)));
+    remove(file_path);
+}
+
+int main(void)
+{
+    test_events();
+    test_top_level_values();
+    test_malformed();
+    test_long_values_are_cut();
+    test_extract();
+    test_extract_from_file();
+    return check_result("test_json");
+}
@@ -0,0 +1,153 @@
+// END marker matcher: random binary bodies split into random blocks must come out whole, without the marker
+#include "../flipper_http.c"
+#include "check.h"
+
+#define BODY_MAX 4096
+
+// Bytes handed out by the matcher, and where they came from
+typedef struct
+{
+    uint8_t data[BODY_MAX + MARKER_MAX_LEN];
+    size_t len;
+    const uint8_t *block; // Block being fed
+    size_t block_len;
+    const char *marker;
+} Output;
+
+static void collect(const uint8_t *data, size_t len, void *context)
+{
+    Output *out = (Output *)context;
+    // Slices of the block or of the marker, never a copy
+    bool in_block = data >= out->block && data + len <= out->block + out->block_len;
+    bool in_marker = data == (const uint8_t *)out->marker && len <= strlen(out->marker);
+    CHECK(in_block || in_marker);
+    CHECK(len > 0);
+    CHECK(out->len + len <= sizeof(out->data));
+    memcpy(out->data + out->len, data, len);
+    out->len += len;
+}
+
+static uint32_t random_state = 12345;
+
+static uint32_t random_next(void)
+{
+    random_state = random_state * 1103515245 + 12345;
+    return (random_state >> 16) & 0x7FFF;
+}
+
+// Function to feed body + marker + tail in blocks of 1 to max_block bytes and check what comes out
+static void run(const char *marker, const uint8_t *body, size_t body_len, size_t max_block)
+{
+    static uint8_t stream[BODY_MAX + 64];
+    static const uint8_t tail[] = "\n[INFO] after";
+    size_t marker_len = strlen(marker);
+    memcpy(stream, body, body_len);
+    memcpy(stream + body_len, marker, marker_len);
+    memcpy(stream + body_len + marker_len, tail, sizeof(tail) - 1);
+    size_t stream_len = body_len + marker_len + sizeof(tail) - 1;
+
+    FlipperHTTPMarkerMatcher matcher;
+    marker_matcher_init(&matcher, marker);
+    Output out = {.len = 0, .marker = marker};
+    size_t pos = 0;
+    bool found = false;
+    while (pos < stream_len && !found)
+    {
+        size_t block_len = MIN(1 + random_next() % max_block, stream_len - pos);
+        out.block = stream + pos;
+        out.block_len = block_len;
+        pos += marker_matcher_feed(&matcher, stream + pos, block_len, &found, collect, &out);
+    }
+
+    // The body, all of it, and nothing after the marker
+    CHECK(found);
+    CHECK(pos == body_len + marker_len);
+    CHECK(out.len == body_len);
+    CHECK(memcmp(out.data, body, body_len) == 0);
+    CHECK(matcher.matched == 0 && matcher.held == 0);
+}
+
+static void test_random_bodies(void)
+{
+    static uint8_t body[BODY_MAX];
+    const char *marker = response_markers[GET].end_bytes;
+    size_t marker_len = strlen(marker);
+    for (int round = 0; round < 3000; round++)
+    {
+        size_t body_len = random_next() % BODY_MAX;
+        for (size_t i = 0; i < body_len; i++)
+        {
+            body[i] = (uint8_t)random_next();
+        }
+
+        // Plant pieces of the marker, the body must not contain all of it
+        size_t plants = random_next() % 8;
+        for (size_t p = 0; p < plants && body_len > marker_len; p++)
+        {
+            size_t at = random_next() % (body_len - marker_len);
+            size_t piece = 1 + random_next() % (marker_len - 1);
+            memcpy(body + at, marker, piece);
+        }
+        bool whole = false;
+        for (size_t i = 0; i + marker_len <= body_len; i++)
+        {
+            whole = whole || memcmp(body + i, marker, marker_len) == 0;
+        }
+        if (whole)
+        {
+            continue;
+        }
+
+        run(marker, body, body_len, 1 + random_next() % 256);
+    }
+}
+
+static void test_partial_matches(void)
+{
+    // Bodies made of marker prefixes, which make the matcher hold bytes back and release them
+    static const char *bodies[] = {
+        "",
+        "\r",
+        "\r\n",
+        "\r\r\n",
+        "\r\n[GET/EN",
+        "\r\n[GET/END\r\n[GET/EN",
+        "\r\n\r\n[\r\n[G",
+        "[GET/END]",
+        "abc\r\n[GET/ENDx\r\n[",
+        "\r\n[POST/END]",
+    };
+    const char *marker = response_markers[GET].end_bytes;
+    for (size_t b = 0; b < COUNT_OF(bodies); b++)
+    {
+        for (size_t max_block = 1; max_block <= 16; max_block++)
+        {
+            run(marker, (const uint8_t *)bodies[b], strlen(bodies[b]), max_block);
+        }
+    }
+}
+
+static void test_flush(void)
+{
+    // A response that stops partway into the marker keeps the bytes held back
+    const char *marker = response_markers[PUT].end_bytes;
+    const uint8_t data[] = "body\r\n[PUT/";
+    FlipperHTTPMarkerMatcher matcher;
+    marker_matcher_init(&matcher, marker);
+    Output out = {.len = 0, .marker = marker, .block = data, .block_len = sizeof(data) - 1};
+    bool found;
+    CHECK(marker_matcher_feed(&matcher, data, sizeof(data) - 1, &found, collect, &out) == sizeof(data) - 1);
+    CHECK(!found);
+    CHECK(out.len == 4);
+    marker_matcher_flush(&matcher, collect, &out);
+    CHECK(out.len == sizeof(data) - 1);
+    CHECK(memcmp(out.data, data, out.len) == 0);
+}
+
+int main(void)
+{
+    test_random_bodies();
+    test_partial_matches();
+    test_flush();
+    return check_result("test_marker");
+}
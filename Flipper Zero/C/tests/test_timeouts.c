@@ -0,0 +1,75 @@
+// Request timeouts: armed by the request itself, before it is written, and not restarted by its SUCCESS line
+#include "../flipper_http.c"
+#include "check.h"
+
+static void test_request_arms_timeouts(FlipperHTTP *fhttp)
+{
+    CHECK(!flipper_http_timeout_running(fhttp));
+    stub_uart_tx_reset();
+    CHECK(flipper_http_request(fhttp, GET, "http://example.com/json", "{}", NULL));
+    CHECK(stub_uart_tx_len() > 0);
+    CHECK(flipper_http_timeout_running(fhttp));
+    CHECK(stub_timer_running(fhttp->get_timeout_timer));
+
+    // The SUCCESS line finds them running and keeps their start
+    uint32_t request_tick = fhttp->request_tick;
+    furi_delay_ms(5);
+    flipper_http_rx_callback("[GET/SUCCESS]{\"Status-Code\":200,\"Content-Length\":2}", fhttp);
+    CHECK(fhttp->request_tick == request_tick);
+    flipper_http_rx_callback("{}", fhttp);
+    flipper_http_rx_callback("[GET/END]", fhttp);
+    CHECK(!flipper_http_timeout_running(fhttp));
+}
+
+static void test_unsent_request(FlipperHTTP *fhttp)
+{
+    // Nothing is written while INACTIVE, so nothing is left running
+    fhttp->state = INACTIVE;
+    stub_uart_tx_reset();
+    CHECK(!flipper_http_request(fhttp, POST, "http://example.com/json", "{}", "{}"));
+    CHECK(stub_uart_tx_len() == 0);
+    CHECK(!flipper_http_timeout_running(fhttp));
+    fhttp->state = IDLE;
+}
+
+static void test_submit_arms_timeouts(FlipperHTTP *fhttp)
+{
+    FlipperHTTPRequest request = {0};
+    request.method = GET;
+    request.url = "http://example.com/json";
+    request.timeouts.first_byte_ms = 1234;
+    CHECK(flipper_http_submit(fhttp, &request) != 0);
+    CHECK(flipper_http_timeout_running(fhttp));
+    CHECK(fhttp->active_timeouts.first_byte_ms == 1234);
+    flipper_http_rx_callback("[GET/SUCCESS]{\"Status-Code\":200,\"Content-Length\":2}", fhttp);
+    flipper_http_rx_callback("[GET/END]", fhttp);
+    CHECK(fhttp->queue_count == 0);
+    CHECK(!flipper_http_timeout_running(fhttp));
+}
+
+static void test_raw_command(FlipperHTTP *fhttp)
+{
+    // A request written with flipper_http_send_data gets its timeouts from the SUCCESS line
+    CHECK(flipper_http_send_data(fhttp, "[GET/HTTP]{\"url\":\"http://example.com/json\"}"));
+    CHECK(!flipper_http_timeout_running(fhttp));
+    flipper_http_rx_callback("[GET/SUCCESS]{\"Status-Code\":200,\"Content-Length\":2}", fhttp);
+    CHECK(flipper_http_timeout_running(fhttp));
+    flipper_http_rx_callback("[GET/END]", fhttp);
+    CHECK(!flipper_http_timeout_running(fhttp));
+}
+
+int main(void)
+{
+    FlipperHTTP *fhttp = flipper_http_alloc();
+    CHECK(fhttp != NULL);
+    if (!fhttp)
+    {
+        return check_result("test_timeouts");
+    }
+    test_request_arms_timeouts(fhttp);
+    test_unsent_request(fhttp);
+    test_submit_arms_timeouts(fhttp);
+    test_raw_command(fhttp);
+    flipper_http_free(fhttp);
+    return check_result("test_timeouts");
+}
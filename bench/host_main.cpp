@@ -0,0 +1,33 @@
+// Runs the firmware on a Linux host with the UART on a pty (see run_bench.py):
+//   flipperhttp_host <pty path>
+#include "../src/FlipperHTTP.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+FlipperHTTP fhttp;
+
+int main(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s <pty path>\n", argv[0]);
+        return 2;
+    }
+    int fd = open(argv[1], O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    Serial.attach(fd);
+    WiFi.begin("host", ""); // the host network stands in for a joined access point
+    fhttp.setup();
+    for (;;)
+    {
+        fhttp.loop();
+        if (Serial.available() == 0)
+        {
+            usleep(50); // the firmware polls, do not spin a host core at 100%
+        }
+    }
+}
@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+"""Drive the host build of the firmware over a pty and print the results as JSON.
+
+    cmake -S bench -B build/bench && cmake --build build/bench
+    python3 bench/run_bench.py --binary build/bench/flipperhttp_host
+
+HTTP goes to a server on 127.0.0.1 started by this script, so the numbers
+measure the firmware's own work (command parsing, JSON, buffering, UART
+framing) and not a WiFi link. They are host numbers: compare runs with each
+other, not with a board.
+"""
+import argparse
+import http.server
+import json
+import os
+import select
+import statistics
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+import tty
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    """/json answers a small JSON object, /bytes/<n> answers n bytes."""
+
+    def do_GET(self):
+        if self.path.startswith("/bytes/"):
+            body = bytes(i & 0xFF for i in range(int(self.path[len("/bytes/"):])))
+            content_type = "application/octet-stream"
+        else:
+            body = json.dumps({"fact": "x" * 200, "length": 200}).encode()
+            content_type = "application/json"
+        self.send_response(200)
+        self.send_header("Content-Type", content_type)
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def log_message(self, *args):
+        pass
+
+
+class Firmware:
+    """The firmware process and the master side of its UART pty."""
+
+    def __init__(self, binary, fs_dir):
+        self.master, slave = os.openpty()
+        tty.setraw(slave)
+        tty.setraw(self.master)
+        env = dict(os.environ, FLIPPERHTTP_FS=fs_dir)
+        self.process = subprocess.Popen([binary, os.ttyname(slave)], env=env)
+        os.close(slave)
+        self.buffer = b""
+
+    def send(self, line):
+        os.write(self.master, line.encode() + b"\n")
+
+    def read_until(self, marker, timeout):
+        """Bytes up to and including the line that contains marker, None on timeout."""
+        deadline = time.monotonic() + timeout
+        marker = marker.encode()
+        while True:
+            index = self.buffer.find(marker)
+            if index >= 0:
+                end = self.buffer.find(b"\n", index)
+                if end >= 0:
+                    out, self.buffer = self.buffer[: end + 1], self.buffer[end + 1 :]
+                    return out
+            left = deadline - time.monotonic()
+            if left <= 0 or self.process.poll() is not None:
+                return None
+            ready, _, _ = select.select([self.master], [], [], left)
+            if ready:
+                try:
+                    self.buffer += os.read(self.master, 65536)
+                except OSError:
+                    return None
+
+    def command(self, line, marker, timeout=10.0):
+        start = time.perf_counter()
+        self.send(line)
+        out = self.read_until(marker, timeout)
+        if out is None:
+            raise RuntimeError("no %r after %r" % (marker, line))
+        return out, time.perf_counter() - start
+
+    def json_command(self, line, timeout=10.0):
+        out, _ = self.command(line, "}", timeout)
+        text = out.decode(errors="replace")
+        return json.loads(text[text.index("{") : text.rindex("}") + 1])
+
+    def stop(self):
+        os.close(self.master)  # the firmware exits when its UART goes away
+        try:
+            _, status, usage = os.wait4(self.process.pid, 0)
+        except ChildProcessError:
+            return None
+        self.process.returncode = status
+        return usage.ru_maxrss  # KiB on Linux
+
+
+def latency_summary(samples):
+    ms = sorted(s * 1000.0 for s in samples)
+    return {
+        "count": len(ms),
+        "mean_ms": round(statistics.mean(ms), 3),
+        "p50_ms": round(ms[len(ms) // 2], 3),
+        "p95_ms": round(ms[min(len(ms) - 1, int(len(ms) * 0.95))], 3),
+        "max_ms": round(ms[-1], 3),
+    }
+
+
+def bench_ping(fw, count):
+    samples = []
+    start = time.perf_counter()
+    for _ in range(count):
+        samples.append(fw.command("[PING]", "[PONG]")[1])
+    elapsed = time.perf_counter() - start
+    result = latency_summary(samples)
+    result["commands_per_s"] = round(count / elapsed, 1)
+    return result
+
+
+def bench_get_http(fw, base, count):
+    line = "[GET/HTTP]" + json.dumps({"url": base + "/json"})
+    samples = [fw.command(line, "[GET/END]")[1] for _ in range(count)]
+    return latency_summary(samples)
+
+
+def bench_get_bytes(fw, base, size, count):
+    line = "[GET/BYTES]" + json.dumps({"url": "%s/bytes/%d" % (base, size)})
+    samples = []
+    for _ in range(count):
+        out, seconds = fw.command(line, "[GET/END]", timeout=60.0)
+        if len(out) < size:
+            raise RuntimeError("[GET/BYTES] returned %d bytes, expected at least %d" % (len(out), size))
+        samples.append(seconds)
+    result = latency_summary(samples)
+    result["size"] = size
+    result["bytes_per_s"] = round(size / statistics.mean(samples))
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--binary", required=True, help="path to flipperhttp_host")
+    parser.add_argument("--iterations", type=int, default=200, help="requests per latency benchmark")
+    parser.add_argument("--bytes", type=int, default=256 * 1024, help="body size for the [GET/BYTES] benchmark")
+    parser.add_argument("--quick", action="store_true", help="few iterations, for the ctest smoke test")
+    parser.add_argument("--output", help="also write the JSON results to this file")
+    args = parser.parse_args()
+    if args.quick:
+        args.iterations = 5
+        args.bytes = 16 * 1024
+
+    server = http.server.ThreadingHTTPServer(("127.0.0.1", 0), Handler)
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    base = "http://127.0.0.1:%d" % server.server_address[1]
+
+    with tempfile.TemporaryDirectory() as fs_dir:
+        fw = Firmware(args.binary, fs_dir)
+        try:
+            # [PING] until the firmware has finished setup()
+            deadline = time.monotonic() + 10
+            while True:
+                fw.send("[PING]")
+                if fw.read_until("[PONG]", 0.5) is not None:
+                    break
+                if time.monotonic() > deadline:
+                    raise RuntimeError("firmware did not answer [PING]")
+
+            fw.command("[STATS/RESET]", "[STATS/RESET]")
+            results = {
+                "ping": bench_ping(fw, args.iterations),
+                "get_http": bench_get_http(fw, base, args.iterations),
+                "get_bytes": bench_get_bytes(fw, base, args.bytes, max(1, args.iterations // 20)),
+            }
+            stats = fw.json_command("[STATS]")
+            heap = fw.json_command("[HEAP]")
+            results["firmware"] = {
+                "heap_free_low": stats["heap"]["low"],
+                "arena_peak": heap["arena_peak"],
+                "arena_overflows": heap["arena_overflows"],
+                "requests": stats["requests"],
+                "bytes": stats["bytes"],
+            }
+        except (RuntimeError, ValueError, KeyError) as error:
+            fw.stop()
+            server.shutdown()
+            print(json.dumps({"error": str(error)}), file=sys.stderr)
+            return 1
+        results["host"] = {"peak_rss_kib": fw.stop()}
+    server.shutdown()
+
+    text = json.dumps(results, indent=2)
+    print(text)
+    if args.output:
+        with open(args.output, "w") as out:
+            out.write(text + "\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,224 @@
+#pragma once
+// Thin Arduino core for running the firmware on a Linux host (bench/ only).
+// Just enough of String, Print, Stream and the timing functions for the
+// sources bench/CMakeLists.txt builds; the ESP32 code paths are the ones compiled.
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <string>
+
+#define PROGMEM
+#define F(text) (reinterpret_cast<const __FlashStringHelper *>(text))
+#define isDigit(c) (isdigit((unsigned char)(c)) != 0)
+
+typedef uint8_t byte;
+class __FlashStringHelper;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+long random(long max);
+
+class String
+{
+public:
+    String(const char *text = "") : s(text ? text : "") {}
+    String(const char *text, size_t length) : s(text, length) {}
+    String(const __FlashStringHelper *text) : s(reinterpret_cast<const char *>(text)) {}
+    String(char c) : s(1, c) {}
+    String(int value) : s(std::to_string(value)) {}
+    String(unsigned int value) : s(std::to_string(value)) {}
+    String(long value) : s(std::to_string(value)) {}
+    String(unsigned long value) : s(std::to_string(value)) {}
+    const char *c_str() const { return s.c_str(); }
+    unsigned int length() const { return s.length(); }
+    bool reserve(unsigned int size)
+    {
+        s.reserve(size);
+        return true;
+    }
+    char operator[](unsigned int index) const { return index < s.length() ? s[index] : '\0'; }
+    bool operator==(const String &other) const { return s == other.s; }
+    bool operator==(const char *other) const { return s == (other ? other : ""); }
+    bool operator!=(const String &other) const { return s != other.s; }
+    bool operator!=(const char *other) const { return !(*this == other); }
+    String &operator+=(const String &other)
+    {
+        s += other.s;
+        return *this;
+    }
+    String &operator+=(const char *other)
+    {
+        s += other ? other : "";
+        return *this;
+    }
+    String &operator+=(char c)
+    {
+        s += c;
+        return *this;
+    }
+    bool concat(const char *text, unsigned int length)
+    {
+        s.append(text, length);
+        return true;
+    }
+    bool startsWith(const String &prefix) const { return s.compare(0, prefix.s.length(), prefix.s) == 0; }
+    bool endsWith(const String &suffix) const
+    {
+        return s.length() >= suffix.s.length() && s.compare(s.length() - suffix.s.length(), suffix.s.length(), suffix.s) == 0;
+    }
+    int indexOf(char c, unsigned int from = 0) const { return toIndex(s.find(c, from)); }
+    int indexOf(const String &text, unsigned int from = 0) const { return toIndex(s.find(text.s, from)); }
+    String substring(unsigned int from) const { return from < s.length() ? String(s.substr(from).c_str()) : String(); }
+    String substring(unsigned int from, unsigned int to) const
+    {
+        if (from > to)
+        {
+            unsigned int swap = from;
+            from = to;
+            to = swap;
+        }
+        return from < s.length() ? String(s.substr(from, to - from).c_str()) : String();
+    }
+    void remove(unsigned int index) { s.erase(index < s.length() ? index : s.length()); }
+    void remove(unsigned int index, unsigned int count)
+    {
+        if (index < s.length())
+        {
+            s.erase(index, count);
+        }
+    }
+    long toInt() const { return atol(s.c_str()); }
+    void trim()
+    {
+        size_t start = 0;
+        while (start < s.length() && isspace((unsigned char)s[start]))
+        {
+            start++;
+        }
+        size_t end = s.length();
+        while (end > start && isspace((unsigned char)s[end - 1]))
+        {
+            end--;
+        }
+        s = s.substr(start, end - start);
+    }
+
+private:
+    static int toIndex(size_t position) { return position == std::string::npos ? -1 : (int)position; }
+    std::string s;
+};
+
+String operator+(const String &left, const String &right);
+String operator+(const String &left, const char *right);
+String operator+(const char *left, const String &right);
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        size_t n = 0;
+        while (size-- > 0)
+        {
+            n += write(*buffer++);
+        }
+        return n;
+    }
+    size_t write(const char *text) { return write((const uint8_t *)text, strlen(text)); }
+    size_t print(const char *text) { return write(text); }
+    size_t print(const String &text) { return write((const uint8_t *)text.c_str(), text.length()); }
+    size_t print(const __FlashStringHelper *text) { return write(reinterpret_cast<const char *>(text)); }
+    size_t print(long value) { return print(String(value)); }
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T &value) { return print(value) + println(); }
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+    virtual void flush() {}
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() { return -1; }
+    void setTimeout(unsigned long ms) { timeout = ms; }
+    virtual size_t readBytes(uint8_t *buffer, size_t size);
+    size_t readBytes(char *buffer, size_t size) { return readBytes((uint8_t *)buffer, size); }
+    String readString();
+    String readStringUntil(char terminator);
+
+protected:
+    int timedRead();
+    unsigned long timeout = 1000;
+};
+
+// UART backed by a file descriptor (a pty slave opened by host_main.cpp)
+class HardwareSerial : public Stream
+{
+public:
+    void attach(int fd);
+    void begin(unsigned long baudrate) { (void)baudrate; }
+    void setTxBufferSize(size_t size) { (void)size; }
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    void flush() override {}
+
+private:
+    void fill();
+    int fd = -1;
+    uint8_t rx[4096];
+    size_t rxStart = 0;
+    size_t rxEnd = 0;
+};
+
+extern HardwareSerial Serial;
+
+class IPAddress
+{
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : bytes{a, b, c, d} {}
+    bool fromString(const String &text)
+    {
+        unsigned int a, b, c, d;
+        if (sscanf(text.c_str(), "%u.%u.%u.%u", &a, &b, &c, &d) != 4)
+        {
+            return false;
+        }
+        *this = IPAddress(a, b, c, d);
+        return true;
+    }
+    String toString() const
+    {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+        return String(text);
+    }
+    uint8_t operator[](int index) const { return bytes[index]; }
+
+private:
+    uint8_t bytes[4];
+};
+
+// Heap figures come from the host allocator, scaled to an ESP32-sized heap
+class EspClass
+{
+public:
+    uint32_t getFreeHeap();
+    uint32_t getMaxAllocHeap();
+    void restart();
+};
+
+extern EspClass ESP;
@@ -0,0 +1,3 @@
+#pragma once
+// WebSocket sessions are stubbed on the host (bench/shim/stubs.cpp), only the type is needed
+class WebSocketClient;
@@ -0,0 +1,347 @@
+#pragma once
+// The part of the ArduinoJson 7 API the firmware uses, for the host build only.
+// Values live in a tree whose blocks come from the document's Allocator, so the
+// firmware's Arena sees the same allocate/reallocate/deallocate traffic shape.
+#include <Arduino.h>
+
+namespace ArduinoJson
+{
+    class Allocator
+    {
+    public:
+        virtual void *allocate(size_t size) = 0;
+        virtual void deallocate(void *pointer) = 0;
+        virtual void *reallocate(void *pointer, size_t size) = 0;
+
+    protected:
+        ~Allocator() = default;
+    };
+}
+
+class JsonDocument;
+class JsonVariant;
+class JsonObject;
+class JsonArray;
+struct JsonNode;
+
+enum JsonType
+{
+    JSON_NULL,
+    JSON_BOOL,
+    JSON_INTEGER,
+    JSON_FLOAT,
+    JSON_STRING,
+    JSON_ARRAY,
+    JSON_OBJECT,
+};
+
+struct JsonNode
+{
+    JsonType type;
+    bool boolean;
+    long long integer;
+    double real;
+    char *text;      // String value
+    char *key;       // Member name when the parent is an object
+    JsonNode *first; // First child of an array or object
+    JsonNode *next;  // Next sibling
+};
+
+class DeserializationError
+{
+public:
+    enum Code
+    {
+        Ok,
+        EmptyInput,
+        IncompleteInput,
+        InvalidInput,
+        NoMemory,
+        TooDeep,
+    };
+    DeserializationError(Code code = Ok) : code(code) {}
+    explicit operator bool() const { return code != Ok; }
+    bool operator==(Code other) const { return code == other; }
+    const char *c_str() const;
+
+private:
+    Code code;
+};
+
+class JsonString
+{
+public:
+    JsonString(const char *text) : text(text) {}
+    const char *c_str() const { return text; }
+
+private:
+    const char *text;
+};
+
+// A value in a document, or a member/element that does not exist yet (assigning creates it)
+class JsonVariant
+{
+public:
+    JsonVariant() {}
+    JsonVariant(JsonDocument *doc, JsonNode *node, JsonNode *parent = nullptr, const char *key = nullptr)
+        : doc(doc), node(node), parent(parent), key(key) {}
+
+    JsonVariant operator[](const char *name) const;
+    JsonVariant operator[](const String &name) const { return (*this)[name.c_str()]; }
+    JsonVariant operator[](int index) const;
+    JsonVariant operator[](size_t index) const { return (*this)[(int)index]; }
+
+    template <typename T>
+    bool is() const;
+    template <typename T>
+    T as() const;
+    template <typename T>
+    T to() const;
+    template <typename T>
+    operator T() const { return as<T>(); }
+
+    JsonVariant &operator=(const char *value);
+    JsonVariant &operator=(const String &value) { return *this = value.c_str(); }
+    JsonVariant &operator=(long long value);
+    JsonVariant &operator=(int value) { return *this = (long long)value; }
+    JsonVariant &operator=(bool value);
+
+    bool operator==(const char *value) const;
+    bool operator==(const String &value) const { return *this == value.c_str(); }
+    size_t size() const;
+    bool isNull() const { return node == nullptr || node->type == JSON_NULL; }
+    JsonNode *data() const { return node; }
+    JsonDocument *document() const { return doc; }
+
+protected:
+    JsonNode *create() const; // The node, added to the parent first if it does not exist
+    JsonDocument *doc = nullptr;
+    JsonNode *node = nullptr;
+    JsonNode *parent = nullptr; // Object or array the value is (or would be) in
+    const char *key = nullptr;  // Member name to create under parent, nullptr to append to an array
+};
+
+class JsonPair
+{
+public:
+    JsonPair(JsonDocument *doc, JsonNode *node) : doc(doc), node(node) {}
+    JsonString key() const { return JsonString(node->key); }
+    JsonVariant value() const { return JsonVariant(doc, node); }
+
+private:
+    JsonDocument *doc;
+    JsonNode *node;
+};
+
+template <typename Item>
+class JsonIterator
+{
+public:
+    JsonIterator(JsonDocument *doc, JsonNode *node) : doc(doc), node(node) {}
+    Item operator*() const { return Item(doc, node); }
+    JsonIterator &operator++()
+    {
+        node = node->next;
+        return *this;
+    }
+    bool operator!=(const JsonIterator &other) const { return node != other.node; }
+
+private:
+    JsonDocument *doc;
+    JsonNode *node;
+};
+
+class JsonObject : public JsonVariant
+{
+public:
+    JsonObject() {}
+    JsonObject(JsonDocument *doc, JsonNode *node) : JsonVariant(doc, node && node->type == JSON_OBJECT ? node : nullptr) {}
+    JsonIterator<JsonPair> begin() const { return JsonIterator<JsonPair>(doc, node ? node->first : nullptr); }
+    JsonIterator<JsonPair> end() const { return JsonIterator<JsonPair>(doc, nullptr); }
+};
+
+class JsonArray : public JsonVariant
+{
+public:
+    JsonArray() {}
+    JsonArray(JsonDocument *doc, JsonNode *node) : JsonVariant(doc, node && node->type == JSON_ARRAY ? node : nullptr) {}
+    JsonIterator<JsonVariant> begin() const { return JsonIterator<JsonVariant>(doc, node ? node->first : nullptr); }
+    JsonIterator<JsonVariant> end() const { return JsonIterator<JsonVariant>(doc, nullptr); }
+    template <typename T>
+    T add() const;
+};
+
+class JsonDocument
+{
+public:
+    JsonDocument(ArduinoJson::Allocator *allocator = nullptr);
+    JsonDocument(const JsonDocument &) = delete;
+    JsonDocument &operator=(const JsonDocument &) = delete;
+    ~JsonDocument() { clear(); }
+
+    JsonVariant operator[](const char *name) { return root()[name]; }
+    JsonVariant operator[](const String &name) { return root()[name.c_str()]; }
+    JsonVariant root() { return JsonVariant(this, &rootNode); }
+    void clear();
+
+    JsonNode *newNode(JsonType type);
+    char *newString(const char *text, size_t length);
+    JsonNode rootNode;
+
+private:
+    struct Block
+    {
+        Block *next;
+    };
+    void *allocate(size_t size);
+    ArduinoJson::Allocator *allocator;
+    Block *blocks = nullptr; // Every block allocated since the last clear, freed together
+};
+
+DeserializationError deserializeJson(JsonDocument &doc, const char *input);
+DeserializationError deserializeJson(JsonDocument &doc, const char *input, size_t length);
+DeserializationError deserializeJson(JsonDocument &doc, const String &input);
+DeserializationError deserializeJson(JsonDocument &doc, Stream &input);
+size_t serializeJson(const JsonVariant &value, Print &out);
+size_t serializeJson(const JsonVariant &value, char *buffer, size_t size);
+size_t serializeJson(const JsonVariant &value, String &out);
+size_t serializeJson(JsonDocument &doc, Print &out);
+size_t serializeJson(JsonDocument &doc, char *buffer, size_t size);
+size_t serializeJson(JsonDocument &doc, String &out);
+
+// Conversions
+
+template <>
+inline bool JsonVariant::is<const char *>() const { return node && node->type == JSON_STRING; }
+template <>
+inline bool JsonVariant::is<String>() const { return is<const char *>(); }
+template <>
+inline bool JsonVariant::is<JsonArray>() const { return node && node->type == JSON_ARRAY; }
+template <>
+inline bool JsonVariant::is<JsonObject>() const { return node && node->type == JSON_OBJECT; }
+template <>
+inline bool JsonVariant::is<bool>() const { return node && node->type == JSON_BOOL; }
+template <>
+inline bool JsonVariant::is<long long>() const { return node && node->type == JSON_INTEGER; }
+template <>
+inline bool JsonVariant::is<int>() const { return is<long long>(); }
+template <>
+inline bool JsonVariant::is<long>() const { return is<long long>(); }
+template <>
+inline bool JsonVariant::is<unsigned int>() const { return is<long long>() && node->integer >= 0; }
+template <>
+inline bool JsonVariant::is<unsigned long>() const { return is<unsigned int>(); }
+
+template <>
+inline const char *JsonVariant::as<const char *>() const { return is<const char *>() ? node->text : nullptr; }
+template <>
+inline long long JsonVariant::as<long long>() const
+{
+    if (node == nullptr)
+    {
+        return 0;
+    }
+    switch (node->type)
+    {
+    case JSON_INTEGER:
+        return node->integer;
+    case JSON_FLOAT:
+        return (long long)node->real;
+    case JSON_BOOL:
+        return node->boolean;
+    case JSON_STRING:
+        return atoll(node->text);
+    default:
+        return 0;
+    }
+}
+template <>
+inline int JsonVariant::as<int>() const { return (int)as<long long>(); }
+template <>
+inline long JsonVariant::as<long>() const { return (long)as<long long>(); }
+template <>
+inline unsigned int JsonVariant::as<unsigned int>() const { return (unsigned int)as<long long>(); }
+template <>
+inline unsigned long JsonVariant::as<unsigned long>() const { return (unsigned long)as<long long>(); }
+template <>
+inline bool JsonVariant::as<bool>() const
+{
+    if (node == nullptr)
+    {
+        return false;
+    }
+    switch (node->type)
+    {
+    case JSON_NULL:
+        return false;
+    case JSON_BOOL:
+        return node->boolean;
+    case JSON_INTEGER:
+        return node->integer != 0;
+    case JSON_FLOAT:
+        return node->real != 0;
+    default:
+        return true; // strings, arrays and objects
+    }
+}
+template <>
+inline String JsonVariant::as<String>() const
+{
+    if (is<const char *>())
+    {
+        return String(node->text);
+    }
+    String out;
+    if (!isNull())
+    {
+        serializeJson(*this, out);
+    }
+    return out;
+}
+template <>
+inline JsonArray JsonVariant::as<JsonArray>() const { return JsonArray(doc, node); }
+template <>
+inline JsonObject JsonVariant::as<JsonObject>() const { return JsonObject(doc, node); }
+template <>
+inline JsonVariant JsonVariant::as<JsonVariant>() const { return *this; }
+
+template <>
+inline JsonArray JsonVariant::to<JsonArray>() const
+{
+    JsonNode *n = create();
+    if (n == nullptr)
+    {
+        return JsonArray();
+    }
+    n->type = JSON_ARRAY;
+    n->first = nullptr;
+    return JsonArray(doc, n);
+}
+template <>
+inline JsonObject JsonVariant::to<JsonObject>() const
+{
+    JsonNode *n = create();
+    if (n == nullptr)
+    {
+        return JsonObject();
+    }
+    n->type = JSON_OBJECT;
+    n->first = nullptr;
+    return JsonObject(doc, n);
+}
+
+template <>
+inline JsonObject JsonArray::add<JsonObject>() const { return JsonVariant(doc, nullptr, node).to<JsonObject>(); }
+template <>
+inline JsonArray JsonArray::add<JsonArray>() const { return JsonVariant(doc, nullptr, node).to<JsonArray>(); }
+
+// value | fallback: the value when it has the type of the fallback
+inline const char *operator|(const JsonVariant &value, const char *fallback)
+{
+    return value.is<const char *>() ? value.as<const char *>() : fallback;
+}
+template <typename T>
+inline T operator|(const JsonVariant &value, T fallback)
+{
+    return value.is<long long>() ? (T)value.as<long long>() : fallback;
+}
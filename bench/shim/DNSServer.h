@@ -0,0 +1,15 @@
+#pragma once
+#include <Arduino.h>
+
+class DNSServer
+{
+public:
+    bool start(uint16_t port, const char *domain, const IPAddress &ip)
+    {
+        (void)port;
+        (void)domain;
+        (void)ip;
+        return true;
+    }
+    void processNextRequest() {}
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <Arduino.h>
+#include <memory>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+// A file under the host directory that stands in for flash (see SPIFFS.h)
+class File : public Stream
+{
+public:
+    File() {}
+    File(FILE *handle);
+    int available() override;
+    int read() override;
+    int read(uint8_t *buffer, size_t size);
+    int peek() override;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    size_t size();
+    void close() { handle.reset(); }
+    time_t getLastWrite() { return 0; }
+    operator bool() const { return handle != nullptr; }
+
+private:
+    std::shared_ptr<FILE> handle; // Shared like the handle of an Arduino File
+};
+
+class FS
+{
+public:
+    FS(const char *root) : root(root) {}
+    bool begin(bool formatOnFail = false);
+    File open(const char *path, const char *mode = FILE_READ);
+    File open(const String &path, const char *mode = FILE_READ) { return open(path.c_str(), mode); }
+    bool exists(const char *path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+    bool remove(const char *path);
+    bool remove(const String &path) { return remove(path.c_str()); }
+    bool mkdir(const char *path);
+
+private:
+    std::string hostPath(const char *path);
+    std::string root;
+};
@@ -0,0 +1,5 @@
+#pragma once
+#include <FS.h>
+
+// Flash is a directory on the host, $FLIPPERHTTP_FS or ./spiffs
+extern FS SPIFFS;
@@ -0,0 +1,62 @@
+#pragma once
+#include <Arduino.h>
+#include <WiFiClient.h>
+
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+#define WIFI_STA 1
+#define WIFI_AP 2
+
+// The host network is always "connected" once begin() was called
+class WiFiClass
+{
+public:
+    void mode(int mode) { (void)mode; }
+    void begin(const char *ssid, const char *password)
+    {
+        (void)ssid;
+        (void)password;
+        joined = true;
+    }
+    void disconnect(bool off = false)
+    {
+        (void)off;
+        joined = false;
+    }
+    int status() { return joined ? WL_CONNECTED : WL_DISCONNECTED; }
+    bool softAP(const char *ssid)
+    {
+        (void)ssid;
+        return true;
+    }
+    IPAddress softAPIP() { return IPAddress(192, 168, 4, 1); }
+    IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+    int hostByName(const char *host, IPAddress &ip);
+    int scanNetworks() { return 0; }
+    void scanDelete() {}
+    String SSID(int index)
+    {
+        (void)index;
+        return String();
+    }
+    int RSSI(int index)
+    {
+        (void)index;
+        return 0;
+    }
+    int channel(int index)
+    {
+        (void)index;
+        return 0;
+    }
+
+private:
+    bool joined = false;
+};
+
+extern WiFiClass WiFi;
+
+// AP mode is not run on the host, only the type is needed
+class WiFiServer;
+
+void configTime(long gmtOffset, int daylightOffset, const char *server1, const char *server2);
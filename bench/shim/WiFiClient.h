@@ -0,0 +1,29 @@
+#pragma once
+#include <Client.h>
+
+// TCP connection over a host socket
+class WiFiClient : public Client
+{
+public:
+    WiFiClient() {}
+    WiFiClient(const WiFiClient &) = delete;
+    WiFiClient &operator=(const WiFiClient &) = delete;
+    ~WiFiClient() override { stop(); }
+    int connect(const char *host, uint16_t port) override;
+    uint8_t connected() override;
+    void stop() override;
+    int available() override;
+    int read() override;
+    int read(uint8_t *buffer, size_t size) override;
+    int peek() override;
+    size_t readBytes(uint8_t *buffer, size_t size) override;
+    using Stream::readBytes;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    operator bool() { return connected(); }
+
+protected:
+    int fd = -1;
+    bool peerClosed = false; // The server closed its side, what is buffered in the socket can still be read
+};
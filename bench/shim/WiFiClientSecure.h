@@ -0,0 +1,20 @@
+#pragma once
+#include <WiFiClient.h>
+
+#define MBEDTLS_ERR_X509_CERT_VERIFY_FAILED -0x2700
+
+// No TLS on the host: https:// URLs connect in plain TCP, so point the bench at http:// servers
+class WiFiClientSecure : public WiFiClient
+{
+public:
+    void setCACert(const char *rootCA) { (void)rootCA; }
+    void setInsecure() {}
+    int lastError(char *buffer, size_t size)
+    {
+        if (size > 0)
+        {
+            buffer[0] = '\0';
+        }
+        return 0;
+    }
+};
@@ -0,0 +1,253 @@
+#include <Arduino.h>
+#include <WiFi.h>
+#include <errno.h>
+#include <malloc.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+#define HOST_HEAP_SIZE (320 * 1024) // Heap of an ESP32 with WiFi up, the host figures are scaled into it
+
+HardwareSerial Serial;
+EspClass ESP;
+WiFiClass WiFi;
+
+static unsigned long long monotonicMicros()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000ULL + now.tv_nsec / 1000;
+}
+
+static const unsigned long long startMicros = monotonicMicros();
+
+unsigned long millis()
+{
+    return (unsigned long)((monotonicMicros() - startMicros) / 1000);
+}
+
+unsigned long micros()
+{
+    return (unsigned long)(monotonicMicros() - startMicros);
+}
+
+void delay(unsigned long ms)
+{
+    usleep(ms * 1000);
+}
+
+void yield()
+{
+}
+
+long random(long max)
+{
+    return max > 0 ? ::random() % max : 0;
+}
+
+void configTime(long gmtOffset, int daylightOffset, const char *server1, const char *server2)
+{
+    (void)gmtOffset;
+    (void)daylightOffset;
+    (void)server1;
+    (void)server2;
+}
+
+String operator+(const String &left, const String &right)
+{
+    String out(left);
+    out += right;
+    return out;
+}
+
+String operator+(const String &left, const char *right)
+{
+    String out(left);
+    out += right;
+    return out;
+}
+
+String operator+(const char *left, const String &right)
+{
+    String out(left);
+    out += right;
+    return out;
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    char stackBuffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(stackBuffer, sizeof(stackBuffer), format, args);
+    va_end(args);
+    if (length < 0)
+    {
+        return 0;
+    }
+    if ((size_t)length < sizeof(stackBuffer))
+    {
+        return write((const uint8_t *)stackBuffer, length);
+    }
+    char *heapBuffer = (char *)malloc(length + 1);
+    if (heapBuffer == nullptr)
+    {
+        return 0;
+    }
+    va_start(args, format);
+    vsnprintf(heapBuffer, length + 1, format, args);
+    va_end(args);
+    size_t n = write((const uint8_t *)heapBuffer, length);
+    free(heapBuffer);
+    return n;
+}
+
+int Stream::timedRead()
+{
+    unsigned long start = millis();
+    do
+    {
+        if (available() > 0)
+        {
+            return read();
+        }
+        usleep(100);
+    } while (millis() - start < timeout);
+    return -1;
+}
+
+size_t Stream::readBytes(uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (n < size)
+    {
+        int c = timedRead();
+        if (c < 0)
+        {
+            break;
+        }
+        buffer[n++] = (uint8_t)c;
+    }
+    return n;
+}
+
+String Stream::readString()
+{
+    String out;
+    int c;
+    while ((c = timedRead()) >= 0)
+    {
+        out += (char)c;
+    }
+    return out;
+}
+
+String Stream::readStringUntil(char terminator)
+{
+    String out;
+    int c;
+    while ((c = timedRead()) >= 0 && c != terminator)
+    {
+        out += (char)c;
+    }
+    return out;
+}
+
+void HardwareSerial::attach(int fd)
+{
+    this->fd = fd;
+}
+
+void HardwareSerial::fill()
+{
+    if (fd < 0)
+    {
+        return;
+    }
+    if (rxStart == rxEnd)
+    {
+        rxStart = rxEnd = 0;
+    }
+    if (rxEnd == sizeof(rx))
+    {
+        return;
+    }
+    struct pollfd p = {fd, POLLIN, 0};
+    if (poll(&p, 1, 0) <= 0)
+    {
+        return;
+    }
+    ssize_t n = ::read(fd, rx + rxEnd, sizeof(rx) - rxEnd);
+    if (n > 0)
+    {
+        rxEnd += n;
+    }
+    else if (n == 0 || (errno != EAGAIN && errno != EINTR))
+    {
+        exit(0); // the other end of the pty is gone, the bench is over
+    }
+}
+
+int HardwareSerial::available()
+{
+    fill();
+    return rxEnd - rxStart;
+}
+
+int HardwareSerial::read()
+{
+    return available() > 0 ? rx[rxStart++] : -1;
+}
+
+int HardwareSerial::peek()
+{
+    return available() > 0 ? rx[rxStart] : -1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    size_t sent = 0;
+    while (fd >= 0 && sent < size)
+    {
+        ssize_t n = ::write(fd, buffer + sent, size - sent);
+        if (n > 0)
+        {
+            sent += n;
+        }
+        else if (n < 0 && errno != EAGAIN && errno != EINTR)
+        {
+            break;
+        }
+        else
+        {
+            struct pollfd p = {fd, POLLOUT, 0};
+            poll(&p, 1, 10);
+        }
+    }
+    return sent;
+}
+
+static size_t heapInUse()
+{
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks;
+}
+
+static const size_t heapBaseline = heapInUse(); // what the host C++ runtime holds before the firmware runs
+
+uint32_t EspClass::getFreeHeap()
+{
+    size_t inUse = heapInUse();
+    size_t used = inUse > heapBaseline ? inUse - heapBaseline : 0;
+    return used < HOST_HEAP_SIZE ? HOST_HEAP_SIZE - used : 0;
+}
+
+uint32_t EspClass::getMaxAllocHeap()
+{
+    return getFreeHeap(); // the host heap does not fragment the way the ESP32 one does
+}
+
+void EspClass::restart()
+{
+    exit(0);
+}
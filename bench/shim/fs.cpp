@@ -0,0 +1,94 @@
+#include <SPIFFS.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+FS SPIFFS(getenv("FLIPPERHTTP_FS") ? getenv("FLIPPERHTTP_FS") : "spiffs");
+
+File::File(FILE *handle) : handle(handle, fclose)
+{
+}
+
+int File::available()
+{
+    if (!handle)
+    {
+        return 0;
+    }
+    long position = ftell(handle.get());
+    return position < 0 ? 0 : (int)(size() - (size_t)position);
+}
+
+int File::read()
+{
+    return handle ? fgetc(handle.get()) : -1;
+}
+
+int File::read(uint8_t *buffer, size_t size)
+{
+    return handle ? (int)fread(buffer, 1, size, handle.get()) : -1;
+}
+
+int File::peek()
+{
+    if (!handle)
+    {
+        return -1;
+    }
+    int c = fgetc(handle.get());
+    if (c >= 0)
+    {
+        ungetc(c, handle.get());
+    }
+    return c;
+}
+
+size_t File::write(const uint8_t *buffer, size_t size)
+{
+    return handle ? fwrite(buffer, 1, size, handle.get()) : 0;
+}
+
+size_t File::size()
+{
+    struct stat info;
+    if (!handle || fflush(handle.get()) != 0 || fstat(fileno(handle.get()), &info) != 0)
+    {
+        return 0;
+    }
+    return info.st_size;
+}
+
+std::string FS::hostPath(const char *path)
+{
+    return root + (path[0] == '/' ? "" : "/") + path;
+}
+
+bool FS::begin(bool formatOnFail)
+{
+    (void)formatOnFail;
+    ::mkdir(root.c_str(), 0755);
+    struct stat info;
+    return stat(root.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+File FS::open(const char *path, const char *mode)
+{
+    std::string full = hostPath(path);
+    FILE *handle = fopen(full.c_str(), mode[0] == 'w' ? "wb" : mode[0] == 'a' ? "ab" : "rb");
+    return handle ? File(handle) : File();
+}
+
+bool FS::exists(const char *path)
+{
+    struct stat info;
+    return stat(hostPath(path).c_str(), &info) == 0;
+}
+
+bool FS::remove(const char *path)
+{
+    return unlink(hostPath(path).c_str()) == 0;
+}
+
+bool FS::mkdir(const char *path)
+{
+    return ::mkdir(hostPath(path).c_str(), 0755) == 0;
+}
@@ -0,0 +1,771 @@
+#include <ArduinoJson.h>
+#include <math.h>
+
+#define JSON_NESTING_LIMIT 10 // Same default as ArduinoJson
+
+// Default allocator of a JsonDocument constructed without one
+class HeapAllocator : public ArduinoJson::Allocator
+{
+public:
+    void *allocate(size_t size) override { return malloc(size); }
+    void deallocate(void *pointer) override { free(pointer); }
+    void *reallocate(void *pointer, size_t size) override { return realloc(pointer, size); }
+};
+
+static HeapAllocator heapAllocator;
+
+const char *DeserializationError::c_str() const
+{
+    switch (code)
+    {
+    case Ok:
+        return "Ok";
+    case EmptyInput:
+        return "EmptyInput";
+    case IncompleteInput:
+        return "IncompleteInput";
+    case InvalidInput:
+        return "InvalidInput";
+    case NoMemory:
+        return "NoMemory";
+    default:
+        return "TooDeep";
+    }
+}
+
+// Document
+
+JsonDocument::JsonDocument(ArduinoJson::Allocator *allocator)
+    : rootNode(), allocator(allocator ? allocator : &heapAllocator)
+{
+}
+
+void *JsonDocument::allocate(size_t size)
+{
+    const size_t header = (sizeof(Block) + 7) & ~(size_t)7;
+    Block *block = (Block *)allocator->allocate(header + size);
+    if (block == nullptr)
+    {
+        return nullptr;
+    }
+    block->next = blocks;
+    blocks = block;
+    return (uint8_t *)block + header;
+}
+
+void JsonDocument::clear()
+{
+    // Newest first, so an arena can give back its most recent block each time
+    while (blocks != nullptr)
+    {
+        Block *next = blocks->next;
+        allocator->deallocate(blocks);
+        blocks = next;
+    }
+    rootNode = JsonNode();
+}
+
+JsonNode *JsonDocument::newNode(JsonType type)
+{
+    JsonNode *node = (JsonNode *)allocate(sizeof(JsonNode));
+    if (node != nullptr)
+    {
+        *node = JsonNode();
+        node->type = type;
+    }
+    return node;
+}
+
+char *JsonDocument::newString(const char *text, size_t length)
+{
+    char *copy = (char *)allocate(length + 1);
+    if (copy != nullptr)
+    {
+        memcpy(copy, text, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+// Variant
+
+JsonVariant JsonVariant::operator[](const char *name) const
+{
+    if (node == nullptr || name == nullptr)
+    {
+        return JsonVariant();
+    }
+    if (node->type == JSON_OBJECT)
+    {
+        for (JsonNode *child = node->first; child != nullptr; child = child->next)
+        {
+            if (strcmp(child->key, name) == 0)
+            {
+                return JsonVariant(doc, child, node, name);
+            }
+        }
+    }
+    if (node->type == JSON_OBJECT || node->type == JSON_NULL)
+    {
+        return JsonVariant(doc, nullptr, node, name);
+    }
+    return JsonVariant();
+}
+
+JsonVariant JsonVariant::operator[](int index) const
+{
+    if (node == nullptr || node->type != JSON_ARRAY || index < 0)
+    {
+        return JsonVariant();
+    }
+    JsonNode *child = node->first;
+    while (child != nullptr && index-- > 0)
+    {
+        child = child->next;
+    }
+    return JsonVariant(doc, child);
+}
+
+JsonNode *JsonVariant::create() const
+{
+    if (node != nullptr)
+    {
+        return node;
+    }
+    if (parent == nullptr || doc == nullptr)
+    {
+        return nullptr;
+    }
+    if (parent->type == JSON_NULL)
+    {
+        parent->type = key ? JSON_OBJECT : JSON_ARRAY;
+    }
+    if ((parent->type == JSON_OBJECT) != (key != nullptr) || (parent->type != JSON_OBJECT && parent->type != JSON_ARRAY))
+    {
+        return nullptr;
+    }
+    JsonNode *child = doc->newNode(JSON_NULL);
+    if (child == nullptr)
+    {
+        return nullptr;
+    }
+    if (key != nullptr && (child->key = doc->newString(key, strlen(key))) == nullptr)
+    {
+        return nullptr;
+    }
+    JsonNode **tail = &parent->first;
+    while (*tail != nullptr)
+    {
+        tail = &(*tail)->next;
+    }
+    *tail = child;
+    return child;
+}
+
+JsonVariant &JsonVariant::operator=(const char *value)
+{
+    node = create();
+    if (node != nullptr)
+    {
+        node->first = nullptr;
+        node->type = value ? JSON_STRING : JSON_NULL;
+        node->text = value ? doc->newString(value, strlen(value)) : nullptr;
+        if (value != nullptr && node->text == nullptr)
+        {
+            node->type = JSON_NULL;
+        }
+    }
+    return *this;
+}
+
+JsonVariant &JsonVariant::operator=(long long value)
+{
+    node = create();
+    if (node != nullptr)
+    {
+        node->first = nullptr;
+        node->type = JSON_INTEGER;
+        node->integer = value;
+    }
+    return *this;
+}
+
+JsonVariant &JsonVariant::operator=(bool value)
+{
+    node = create();
+    if (node != nullptr)
+    {
+        node->first = nullptr;
+        node->type = JSON_BOOL;
+        node->boolean = value;
+    }
+    return *this;
+}
+
+bool JsonVariant::operator==(const char *value) const
+{
+    return is<const char *>() && value != nullptr && strcmp(node->text, value) == 0;
+}
+
+size_t JsonVariant::size() const
+{
+    size_t count = 0;
+    if (node != nullptr && (node->type == JSON_ARRAY || node->type == JSON_OBJECT))
+    {
+        for (JsonNode *child = node->first; child != nullptr; child = child->next)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Parser
+
+namespace
+{
+    class Reader
+    {
+    public:
+        virtual ~Reader() {}
+        int peek()
+        {
+            if (lookahead == -2)
+            {
+                lookahead = next();
+            }
+            return lookahead;
+        }
+        int get()
+        {
+            int c = peek();
+            lookahead = -2;
+            return c;
+        }
+        int skipSpace()
+        {
+            while (peek() == ' ' || peek() == '\t' || peek() == '\r' || peek() == '\n')
+            {
+                get();
+            }
+            return peek();
+        }
+
+    protected:
+        virtual int next() = 0; // Next input byte, -1 at the end
+
+    private:
+        int lookahead = -2; // -2 when nothing has been peeked
+    };
+
+    class BufferReader : public Reader
+    {
+    public:
+        BufferReader(const char *input, size_t length) : input(input), end(input + length) {}
+
+    protected:
+        int next() override { return input < end && *input != '\0' ? (uint8_t)*input++ : -1; }
+
+    private:
+        const char *input;
+        const char *end;
+    };
+
+    class StreamReader : public Reader
+    {
+    public:
+        StreamReader(Stream &input) : input(input) {}
+
+    protected:
+        int next() override
+        {
+            uint8_t c;
+            return input.readBytes(&c, 1) == 1 ? c : -1;
+        }
+
+    private:
+        Stream &input;
+    };
+
+    class Parser
+    {
+    public:
+        Parser(JsonDocument &doc, Reader &in) : doc(doc), in(in) {}
+
+        DeserializationError parse()
+        {
+            if (in.skipSpace() < 0)
+            {
+                return DeserializationError::EmptyInput;
+            }
+            return value(&doc.rootNode, 0);
+        }
+
+    private:
+        DeserializationError value(JsonNode *node, int depth)
+        {
+            int c = in.skipSpace();
+            if (c < 0)
+            {
+                return DeserializationError::IncompleteInput;
+            }
+            if (c == '{' || c == '[')
+            {
+                if (depth >= JSON_NESTING_LIMIT)
+                {
+                    return DeserializationError::TooDeep;
+                }
+                return c == '{' ? object(node, depth + 1) : array(node, depth + 1);
+            }
+            if (c == '"')
+            {
+                std::string text;
+                DeserializationError error = string(text);
+                if (error)
+                {
+                    return error;
+                }
+                node->type = JSON_STRING;
+                node->text = doc.newString(text.c_str(), text.length());
+                return node->text ? DeserializationError::Ok : DeserializationError::NoMemory;
+            }
+            if (c == '-' || (c >= '0' && c <= '9'))
+            {
+                return number(node);
+            }
+            return literal(node);
+        }
+
+        DeserializationError object(JsonNode *node, int depth)
+        {
+            in.get();
+            node->type = JSON_OBJECT;
+            JsonNode **tail = &node->first;
+            if (in.skipSpace() == '}')
+            {
+                in.get();
+                return DeserializationError::Ok;
+            }
+            for (;;)
+            {
+                if (in.skipSpace() != '"')
+                {
+                    return in.peek() < 0 ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+                }
+                std::string key;
+                DeserializationError error = string(key);
+                if (error)
+                {
+                    return error;
+                }
+                if (in.skipSpace() != ':')
+                {
+                    return in.peek() < 0 ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+                }
+                in.get();
+                JsonNode *child = doc.newNode(JSON_NULL);
+                if (child == nullptr || (child->key = doc.newString(key.c_str(), key.length())) == nullptr)
+                {
+                    return DeserializationError::NoMemory;
+                }
+                *tail = child;
+                tail = &child->next;
+                error = value(child, depth);
+                if (error)
+                {
+                    return error;
+                }
+                int c = in.skipSpace();
+                in.get();
+                if (c == '}')
+                {
+                    return DeserializationError::Ok;
+                }
+                if (c != ',')
+                {
+                    return c < 0 ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+                }
+            }
+        }
+
+        DeserializationError array(JsonNode *node, int depth)
+        {
+            in.get();
+            node->type = JSON_ARRAY;
+            JsonNode **tail = &node->first;
+            if (in.skipSpace() == ']')
+            {
+                in.get();
+                return DeserializationError::Ok;
+            }
+            for (;;)
+            {
+                JsonNode *child = doc.newNode(JSON_NULL);
+                if (child == nullptr)
+                {
+                    return DeserializationError::NoMemory;
+                }
+                *tail = child;
+                tail = &child->next;
+                DeserializationError error = value(child, depth);
+                if (error)
+                {
+                    return error;
+                }
+                int c = in.skipSpace();
+                in.get();
+                if (c == ']')
+                {
+                    return DeserializationError::Ok;
+                }
+                if (c != ',')
+                {
+                    return c < 0 ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+                }
+            }
+        }
+
+        static void appendUTF8(std::string &out, uint32_t code)
+        {
+            if (code < 0x80)
+            {
+                out += (char)code;
+            }
+            else if (code < 0x800)
+            {
+                out += (char)(0xc0 | (code >> 6));
+                out += (char)(0x80 | (code & 0x3f));
+            }
+            else if (code < 0x10000)
+            {
+                out += (char)(0xe0 | (code >> 12));
+                out += (char)(0x80 | ((code >> 6) & 0x3f));
+                out += (char)(0x80 | (code & 0x3f));
+            }
+            else
+            {
+                out += (char)(0xf0 | (code >> 18));
+                out += (char)(0x80 | ((code >> 12) & 0x3f));
+                out += (char)(0x80 | ((code >> 6) & 0x3f));
+                out += (char)(0x80 | (code & 0x3f));
+            }
+        }
+
+        bool hex4(uint32_t &code)
+        {
+            code = 0;
+            for (int i = 0; i < 4; i++)
+            {
+                int c = in.get();
+                int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+                if (digit < 0)
+                {
+                    return false;
+                }
+                code = code * 16 + digit;
+            }
+            return true;
+        }
+
+        DeserializationError string(std::string &out)
+        {
+            in.get(); // opening quote
+            for (;;)
+            {
+                int c = in.get();
+                if (c < 0)
+                {
+                    return DeserializationError::IncompleteInput;
+                }
+                if (c == '"')
+                {
+                    return DeserializationError::Ok;
+                }
+                if (c != '\\')
+                {
+                    out += (char)c;
+                    continue;
+                }
+                c = in.get();
+                uint32_t code;
+                switch (c)
+                {
+                case 'b':
+                    out += '\b';
+                    break;
+                case 'f':
+                    out += '\f';
+                    break;
+                case 'n':
+                    out += '\n';
+                    break;
+                case 'r':
+                    out += '\r';
+                    break;
+                case 't':
+                    out += '\t';
+                    break;
+                case 'u':
+                    if (!hex4(code))
+                    {
+                        return DeserializationError::InvalidInput;
+                    }
+                    if (code >= 0xd800 && code < 0xdc00 && in.peek() == '\\')
+                    {
+                        uint32_t low;
+                        in.get();
+                        if (in.get() != 'u' || !hex4(low))
+                        {
+                            return DeserializationError::InvalidInput;
+                        }
+                        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                    }
+                    appendUTF8(out, code);
+                    break;
+                case -1:
+                    return DeserializationError::IncompleteInput;
+                default:
+                    out += (char)c; // \" \\ \/
+                    break;
+                }
+            }
+        }
+
+        DeserializationError number(JsonNode *node)
+        {
+            char text[32];
+            size_t length = 0;
+            bool real = false;
+            int c;
+            while ((c = in.peek()) >= 0 && (strchr("+-0123456789.eE", c) != nullptr))
+            {
+                if (length + 1 >= sizeof(text))
+                {
+                    return DeserializationError::InvalidInput;
+                }
+                real = real || c == '.' || c == 'e' || c == 'E';
+                text[length++] = (char)in.get();
+            }
+            text[length] = '\0';
+            char *end;
+            if (real)
+            {
+                node->type = JSON_FLOAT;
+                node->real = strtod(text, &end);
+            }
+            else
+            {
+                node->type = JSON_INTEGER;
+                node->integer = strtoll(text, &end, 10);
+            }
+            return *end == '\0' ? DeserializationError::Ok : DeserializationError::InvalidInput;
+        }
+
+        DeserializationError literal(JsonNode *node)
+        {
+            static const struct
+            {
+                const char *text;
+                JsonType type;
+                bool boolean;
+            } literals[] = {{"true", JSON_BOOL, true}, {"false", JSON_BOOL, false}, {"null", JSON_NULL, false}};
+            for (const auto &candidate : literals)
+            {
+                if (in.peek() != candidate.text[0])
+                {
+                    continue;
+                }
+                for (const char *p = candidate.text; *p; p++)
+                {
+                    int c = in.get();
+                    if (c != *p)
+                    {
+                        return c < 0 ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+                    }
+                }
+                node->type = candidate.type;
+                node->boolean = candidate.boolean;
+                return DeserializationError::Ok;
+            }
+            return DeserializationError::InvalidInput;
+        }
+
+        JsonDocument &doc;
+        Reader &in;
+    };
+}
+
+static DeserializationError deserialize(JsonDocument &doc, Reader &in)
+{
+    doc.clear();
+    DeserializationError error = Parser(doc, in).parse();
+    if (error)
+    {
+        doc.clear();
+    }
+    return error;
+}
+
+DeserializationError deserializeJson(JsonDocument &doc, const char *input)
+{
+    BufferReader in(input ? input : "", input ? strlen(input) : 0);
+    return deserialize(doc, in);
+}
+
+DeserializationError deserializeJson(JsonDocument &doc, const char *input, size_t length)
+{
+    BufferReader in(input, length);
+    return deserialize(doc, in);
+}
+
+DeserializationError deserializeJson(JsonDocument &doc, const String &input)
+{
+    return deserializeJson(doc, input.c_str(), input.length());
+}
+
+DeserializationError deserializeJson(JsonDocument &doc, Stream &input)
+{
+    StreamReader in(input);
+    return deserialize(doc, in);
+}
+
+// Serializer
+
+static void writeString(std::string &out, const char *text)
+{
+    out += '"';
+    for (const char *p = text; *p; p++)
+    {
+        switch (*p)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\b':
+            out += "\\b";
+            break;
+        case '\f':
+            out += "\\f";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if ((uint8_t)*p < 0x20)
+            {
+                char escape[8];
+                snprintf(escape, sizeof(escape), "\\u%04x", (uint8_t)*p);
+                out += escape;
+            }
+            else
+            {
+                out += *p;
+            }
+            break;
+        }
+    }
+    out += '"';
+}
+
+static void writeNode(std::string &out, const JsonNode *node)
+{
+    char number[32];
+    switch (node ? node->type : JSON_NULL)
+    {
+    case JSON_NULL:
+        out += "null";
+        break;
+    case JSON_BOOL:
+        out += node->boolean ? "true" : "false";
+        break;
+    case JSON_INTEGER:
+        snprintf(number, sizeof(number), "%lld", node->integer);
+        out += number;
+        break;
+    case JSON_FLOAT:
+        if (isfinite(node->real))
+        {
+            snprintf(number, sizeof(number), "%.9g", node->real);
+            out += number;
+        }
+        else
+        {
+            out += "null";
+        }
+        break;
+    case JSON_STRING:
+        writeString(out, node->text);
+        break;
+    case JSON_ARRAY:
+    case JSON_OBJECT:
+        out += node->type == JSON_ARRAY ? '[' : '{';
+        for (const JsonNode *child = node->first; child != nullptr; child = child->next)
+        {
+            if (child != node->first)
+            {
+                out += ',';
+            }
+            if (node->type == JSON_OBJECT)
+            {
+                writeString(out, child->key);
+                out += ':';
+            }
+            writeNode(out, child);
+        }
+        out += node->type == JSON_ARRAY ? ']' : '}';
+        break;
+    }
+}
+
+size_t serializeJson(const JsonVariant &value, Print &out)
+{
+    std::string text;
+    writeNode(text, value.data());
+    return out.write((const uint8_t *)text.data(), text.length());
+}
+
+size_t serializeJson(const JsonVariant &value, char *buffer, size_t size)
+{
+    std::string text;
+    writeNode(text, value.data());
+    if (size == 0)
+    {
+        return 0;
+    }
+    size_t n = text.length() < size - 1 ? text.length() : size - 1;
+    memcpy(buffer, text.data(), n);
+    buffer[n] = '\0';
+    return n;
+}
+
+size_t serializeJson(const JsonVariant &value, String &out)
+{
+    std::string text;
+    writeNode(text, value.data());
+    out = String(text.c_str(), text.length());
+    return text.length();
+}
+
+size_t serializeJson(JsonDocument &doc, Print &out)
+{
+    return serializeJson(doc.root(), out);
+}
+
+size_t serializeJson(JsonDocument &doc, char *buffer, size_t size)
+{
+    return serializeJson(doc.root(), buffer, size);
+}
+
+size_t serializeJson(JsonDocument &doc, String &out)
+{
+    return serializeJson(doc.root(), out);
+}
@@ -0,0 +1,321 @@
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+int WiFiClass::hostByName(const char *host, IPAddress &ip)
+{
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    struct addrinfo *result = nullptr;
+    if (getaddrinfo(host, nullptr, &hints, &result) != 0 || result == nullptr)
+    {
+        return 0;
+    }
+    const uint8_t *a = (const uint8_t *)&((struct sockaddr_in *)result->ai_addr)->sin_addr;
+    ip = IPAddress(a[0], a[1], a[2], a[3]);
+    freeaddrinfo(result);
+    return 1;
+}
+
+int WiFiClient::connect(const char *host, uint16_t port)
+{
+    stop();
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    struct addrinfo *result = nullptr;
+    if (getaddrinfo(host, service, &hints, &result) != 0 || result == nullptr)
+    {
+        return 0;
+    }
+    fd = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (fd >= 0 && ::connect(fd, result->ai_addr, result->ai_addrlen) != 0)
+    {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+    if (fd < 0)
+    {
+        return 0;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    peerClosed = false;
+    return 1;
+}
+
+uint8_t WiFiClient::connected()
+{
+    if (fd < 0)
+    {
+        return 0;
+    }
+    available(); // notices the server closing
+    return !peerClosed;
+}
+
+void WiFiClient::stop()
+{
+    if (fd >= 0)
+    {
+        close(fd);
+        fd = -1;
+    }
+    peerClosed = false;
+}
+
+int WiFiClient::available()
+{
+    if (fd < 0)
+    {
+        return 0;
+    }
+    uint8_t probe[4096];
+    ssize_t n = recv(fd, probe, sizeof(probe), MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0)
+    {
+        peerClosed = true;
+    }
+    else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+    {
+        peerClosed = true;
+    }
+    return n > 0 ? (int)n : 0;
+}
+
+int WiFiClient::read()
+{
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t *buffer, size_t size)
+{
+    if (fd < 0)
+    {
+        return -1;
+    }
+    ssize_t n = recv(fd, buffer, size, MSG_DONTWAIT);
+    if (n == 0)
+    {
+        peerClosed = true;
+        return -1;
+    }
+    if (n < 0)
+    {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+    }
+    return (int)n;
+}
+
+size_t WiFiClient::readBytes(uint8_t *buffer, size_t size)
+{
+    // Whole socket reads instead of a byte at a time, as the ESP32 client does
+    size_t n = 0;
+    unsigned long start = millis();
+    while (n < size && millis() - start < timeout)
+    {
+        int got = read(buffer + n, size - n);
+        if (got < 0)
+        {
+            break;
+        }
+        if (got == 0)
+        {
+            struct pollfd p = {fd, POLLIN, 0};
+            poll(&p, 1, 1);
+            continue;
+        }
+        n += got;
+    }
+    return n;
+}
+
+int WiFiClient::peek()
+{
+    uint8_t c;
+    return fd >= 0 && recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT) == 1 ? c : -1;
+}
+
+size_t WiFiClient::write(const uint8_t *buffer, size_t size)
+{
+    size_t sent = 0;
+    while (fd >= 0 && sent < size)
+    {
+        ssize_t n = send(fd, buffer + sent, size - sent, MSG_NOSIGNAL);
+        if (n > 0)
+        {
+            sent += n;
+        }
+        else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        {
+            struct pollfd p = {fd, POLLOUT, 0};
+            poll(&p, 1, 100);
+        }
+        else
+        {
+            break;
+        }
+    }
+    return sent;
+}
+
+bool HTTPClient::begin(WiFiClient &client, const String &url)
+{
+    // http[s]://host[:port]/path, https is sent in plain TCP (see WiFiClientSecure.h)
+    String rest = url;
+    port = 80;
+    if (rest.startsWith("https://"))
+    {
+        rest = rest.substring(8);
+        port = 443;
+    }
+    else if (rest.startsWith("http://"))
+    {
+        rest = rest.substring(7);
+    }
+    int slash = rest.indexOf('/');
+    String authority = slash < 0 ? rest : rest.substring(0, slash);
+    path = slash < 0 ? String("/") : rest.substring(slash);
+    int colon = authority.indexOf(':');
+    if (colon >= 0)
+    {
+        port = (uint16_t)authority.substring(colon + 1).toInt();
+        authority = authority.substring(0, colon);
+    }
+    host = authority;
+    headers = "";
+    size = -1;
+    this->client = &client;
+    return host.length() > 0;
+}
+
+void HTTPClient::addHeader(const String &name, const String &value)
+{
+    headers += name + ": " + value + "\r\n";
+}
+
+bool HTTPClient::readLine(String &line)
+{
+    line = "";
+    unsigned long start = millis();
+    while (millis() - start < 5000)
+    {
+        int c = client->read();
+        if (c < 0)
+        {
+            if (!client->connected())
+            {
+                return false;
+            }
+            usleep(100);
+            continue;
+        }
+        if (c == '\n')
+        {
+            line.trim();
+            return true;
+        }
+        line += (char)c;
+    }
+    return false;
+}
+
+int HTTPClient::sendRequest(const char *method, const String &payload)
+{
+    if (client == nullptr)
+    {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    if (!client->connected() && !client->connect(host.c_str(), port))
+    {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    String request = String(method) + " " + path + " HTTP/1.1\r\nHost: " + host + "\r\nConnection: close\r\n" + headers;
+    if (payload.length() > 0 || strcmp(method, "GET") != 0)
+    {
+        request += "Content-Length: " + String(payload.length()) + "\r\n";
+    }
+    request += "\r\n";
+    request += payload;
+    if (client->write((const uint8_t *)request.c_str(), request.length()) != request.length())
+    {
+        return HTTPC_ERROR_SEND_HEADER_FAILED;
+    }
+
+    String line;
+    if (!readLine(line))
+    {
+        return HTTPC_ERROR_READ_TIMEOUT;
+    }
+    int space = line.indexOf(' ');
+    int code = space < 0 ? 0 : (int)line.substring(space + 1).toInt();
+    while (readLine(line) && line.length() > 0)
+    {
+        if (strncasecmp(line.c_str(), "Content-Length:", 15) == 0)
+        {
+            size = (int)line.substring(15).toInt();
+        }
+    }
+    return code > 0 ? code : HTTPC_ERROR_READ_TIMEOUT;
+}
+
+String HTTPClient::getString()
+{
+    String body;
+    uint8_t buffer[512];
+    unsigned long last = millis();
+    while (size < 0 || (int)body.length() < size)
+    {
+        int n = client->read(buffer, sizeof(buffer));
+        if (n > 0)
+        {
+            body.concat((const char *)buffer, n);
+            last = millis();
+        }
+        else if (n < 0 || millis() - last > 5000)
+        {
+            break;
+        }
+        else
+        {
+            usleep(100);
+        }
+    }
+    return body;
+}
+
+void HTTPClient::end()
+{
+    if (client != nullptr)
+    {
+        client->stop();
+        client = nullptr;
+    }
+}
+
+String HTTPClient::errorToString(int code)
+{
+    switch (code)
+    {
+    case HTTPC_ERROR_CONNECTION_REFUSED:
+        return "connection refused";
+    case HTTPC_ERROR_SEND_HEADER_FAILED:
+        return "send header failed";
+    case HTTPC_ERROR_READ_TIMEOUT:
+        return "read Timeout";
+    default:
+        return String();
+    }
+}
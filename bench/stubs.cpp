@@ -0,0 +1,131 @@
+// Hardware the host build does not have: LEDs, AP mode, deauth and WebSocket
+// sessions. Commands that need them answer as they would after a failure.
+#include "../src/led.h"
+#include "../src/websocket.h"
+#include "../src/wifi_ap.h"
+#include "../src/wifi_deauth.h"
+
+void LED::blink(int timeout)
+{
+    (void)timeout;
+}
+
+void LED::start()
+{
+}
+
+void LED::on()
+{
+}
+
+void LED::off()
+{
+}
+
+WiFiAP::WiFiAP(UART *uartClass, WiFiUtils *wifiUtils, StorageManager *storageManager)
+    : uart(uartClass), wifi(wifiUtils), storage(storageManager), isRunning(false), clients(nullptr)
+{
+}
+
+bool WiFiAP::start(const char *ssid)
+{
+    (void)ssid;
+    return false;
+}
+
+void WiFiAP::run(bool (*pump)(void *context), void *context)
+{
+    (void)pump;
+    (void)context;
+}
+
+bool WiFiDeauth::start(const char *ssid)
+{
+    (void)ssid;
+    return false;
+}
+
+void WiFiDeauth::stop()
+{
+}
+
+void WiFiDeauth::update()
+{
+}
+
+WebSocket *WebSocket::uartOwner = nullptr;
+
+WebSocket::WebSocket(UART *uartClass, int sessionId)
+    : uart(uartClass), transport(nullptr), ws(nullptr), frameRemaining(0), frameBinary(false), frameFinal(true),
+      lastReceived(0), lastPing(0), queueHead(0), queueCount(0), wasIdle(true), sessionId(sessionId), reason("closed")
+{
+    host[0] = '\0';
+}
+
+WebSocket::~WebSocket()
+{
+}
+
+bool WebSocket::begin(const char *url, int port, const char *headerKeys[], const char *headerValues[], int headerSize, const char *rootCA, TLSPolicy *tlsPolicy)
+{
+    (void)url;
+    (void)port;
+    (void)headerKeys;
+    (void)headerValues;
+    (void)headerSize;
+    (void)rootCA;
+    (void)tlsPolicy;
+    return false;
+}
+
+const char *WebSocket::closeReason()
+{
+    return reason;
+}
+
+bool WebSocket::connected()
+{
+    return false;
+}
+
+bool WebSocket::inMessage()
+{
+    return false;
+}
+
+bool WebSocket::isIdle()
+{
+    return true;
+}
+
+bool WebSocket::loop()
+{
+    return false;
+}
+
+bool WebSocket::queueFull()
+{
+    return false;
+}
+
+bool WebSocket::queueText(const char *data, size_t size)
+{
+    (void)data;
+    (void)size;
+    return false;
+}
+
+bool WebSocket::sendBinaryFromUART(size_t size)
+{
+    (void)size;
+    return false;
+}
+
+void WebSocket::stop()
+{
+}
+
+bool WebSocket::uartBusy()
+{
+    return false;
+}
@@ -0,0 +1,235 @@
+// HTTPConnection against a local server: Content-Length, chunked, 100 Continue,
+// read-until-close and 204 responses, and a request that reuses the connection
+#include "http_connection.h"
+#include <WiFiClient.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                         \
+    do                                                                      \
+    {                                                                       \
+        if (!(cond))                                                        \
+        {                                                                   \
+            fprintf(stderr, "%s:%d: CHECK(%s)\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+// One canned response per path, the server closes after the ones marked so
+struct Route
+{
+    const char *path;
+    const char *response;
+    bool close;
+};
+
+static const Route routes[] = {
+    {"/length", "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: 11\r\n\r\nhello world", false},
+    {"/chunked", "HTTP/1.1 200 OK\r\nTransfer-Encoding: gzip, chunked\r\n\r\n"
+                 "5\r\nhello\r\n1;ext=1\r\n \r\n5\r\nworld\r\n0\r\nX-Trailer: 1\r\n\r\n",
+     false},
+    {"/continue", "HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 201 Created\r\nContent-Length: 2\r\n\r\nok", false},
+    {"/close", "HTTP/1.0 200 OK\r\n\r\nuntil the server closes", true},
+    {"/empty", "HTTP/1.1 204 No Content\r\nContent-Length: 5\r\n\r\n", false},
+};
+
+// Last request head and body the server received, set before it answers
+static char received[2048];
+static size_t receivedLength = 0;
+
+// Function to read one request (head and Content-Length body) from a socket into received, false when the client left
+static bool readRequest(int fd)
+{
+    static char request[sizeof(received)];
+    size_t length = 0;
+    const char *head = nullptr;
+    size_t want = 0;
+    while (head == nullptr || length < want)
+    {
+        ssize_t n = recv(fd, request + length, sizeof(request) - 1 - length, 0);
+        if (n <= 0)
+        {
+            return false;
+        }
+        length += n;
+        request[length] = '\0';
+        if (head == nullptr && (head = strstr(request, "\r\n\r\n")) != nullptr)
+        {
+            const char *contentLength = strcasestr(request, "\r\nContent-Length: ");
+            want = (head + 4 - request) + (contentLength != nullptr && contentLength < head ? atoi(contentLength + 18) : 0);
+        }
+    }
+    memcpy(received, request, length + 1);
+    receivedLength = length;
+    return true;
+}
+
+// Function to answer requests on each accepted connection until the client or a route closes it
+static void serve(int listener)
+{
+    while (true)
+    {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0)
+        {
+            return;
+        }
+        while (readRequest(fd))
+        {
+            const Route *route = nullptr;
+            for (const Route &r : routes)
+            {
+                size_t pathLength = strlen(r.path);
+                if (strncmp(strchr(received, ' ') + 1, r.path, pathLength) == 0 && received[strcspn(received, " ") + 1 + pathLength] == ' ')
+                {
+                    route = &r;
+                }
+            }
+            const char *response = route != nullptr ? route->response : "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+            send(fd, response, strlen(response), MSG_NOSIGNAL);
+            if (route != nullptr && route->close)
+            {
+                break;
+            }
+        }
+        close(fd);
+    }
+}
+
+// Function to read the whole body in pieces of at most pieceSize bytes, -1 on error
+static int readBody(HTTPConnection &connection, char *body, size_t size, size_t pieceSize)
+{
+    size_t length = 0;
+    while (true)
+    {
+        int n = connection.read((uint8_t *)body + length, pieceSize < size - 1 - length ? pieceSize : size - 1 - length);
+        if (n < 0)
+        {
+            return -1;
+        }
+        if (n == 0)
+        {
+            break;
+        }
+        length += n;
+    }
+    body[length] = '\0';
+    return (int)length;
+}
+
+static void testResponses(uint16_t port)
+{
+    WiFiClient client;
+    HTTPConnection connection;
+    char body[256];
+    CHECK(connection.connect(&client, "127.0.0.1", port));
+
+    // Content-Length, read a byte at a time
+    CHECK(connection.sendRequest("GET", "length", nullptr, nullptr, 0, nullptr, 0, true));
+    CHECK(connection.readResponseHead() == 200);
+    CHECK(connection.contentLength() == 11);
+    CHECK(connection.keepAlive());
+    CHECK(readBody(connection, body, sizeof(body), 1) == 11);
+    CHECK(strcmp(body, "hello world") == 0);
+    CHECK(strncmp(received, "GET /length HTTP/1.1\r\nHost: 127.0.0.1:", 38) == 0);
+
+    // Chunked over the same connection, with an extension and trailers
+    CHECK(connection.sendRequest("GET", "/chunked", nullptr, nullptr, 0, nullptr, 0, true));
+    CHECK(connection.readResponseHead() == 200);
+    CHECK(connection.contentLength() == -1);
+    CHECK(readBody(connection, body, sizeof(body), 3) == 11);
+    CHECK(strcmp(body, "hello world") == 0);
+
+    // 100 Continue before the real response, with a payload and headers (a NULL value is left out)
+    const char *keys[] = {"X-Key", "X-Null", "Content-Type"};
+    const char *values[] = {"value", nullptr, "text/plain"};
+    CHECK(connection.sendRequest("POST", "/continue", keys, values, 3, "{\"a\":1}", 7, true));
+    CHECK(connection.readResponseHead() == 201);
+    CHECK(readBody(connection, body, sizeof(body), sizeof(body)) == 2);
+    CHECK(strcmp(body, "ok") == 0);
+    CHECK(strstr(received, "\r\nX-Key: value\r\n") != nullptr);
+    CHECK(strstr(received, "X-Null") == nullptr);
+    CHECK(strstr(received, "\r\nContent-Type: text/plain\r\n") != nullptr);
+    CHECK(strstr(received, "application/json") == nullptr);
+    CHECK(strstr(received, "\r\nContent-Length: 7\r\n") != nullptr);
+    CHECK(strcmp(received + receivedLength - 11, "\r\n\r\n{\"a\":1}") == 0);
+
+    // 204 has no body, whatever Content-Length says
+    CHECK(connection.sendRequest("GET", "/empty", nullptr, nullptr, 0, nullptr, 0, true));
+    CHECK(connection.readResponseHead() == 204);
+    CHECK(readBody(connection, body, sizeof(body), sizeof(body)) == 0);
+
+    // No length: the body ends when the server closes
+    CHECK(connection.sendRequest("GET", "/close", nullptr, nullptr, 0, nullptr, 0, false));
+    CHECK(connection.readResponseHead() == 200);
+    CHECK(strstr(received, "\r\nConnection: close\r\n") != nullptr);
+    CHECK(!connection.keepAlive());
+    CHECK(readBody(connection, body, sizeof(body), 4) == 23);
+    CHECK(strcmp(body, "until the server closes") == 0);
+    connection.stop();
+}
+
+static void testLongRequest(uint16_t port)
+{
+    // A head longer than the transmit buffer goes out whole
+    WiFiClient client;
+    HTTPConnection connection;
+    char value[HTTP_CONNECTION_BUFFER * 2];
+    memset(value, 'v', sizeof(value) - 1);
+    value[sizeof(value) - 1] = '\0';
+    const char *keys[] = {"X-Long"};
+    const char *values[] = {value};
+    CHECK(connection.connect(&client, "127.0.0.1", port));
+    CHECK(connection.sendRequest("GET", "/length", keys, values, 1, nullptr, 0, false));
+    CHECK(connection.readResponseHead() == 200);
+    CHECK(strstr(received, value) != nullptr);
+    connection.stop();
+
+    // Nothing is written without a connection
+    HTTPConnection unconnected;
+    CHECK(!unconnected.sendRequest("GET", "/length", nullptr, nullptr, 0, nullptr, 0, false));
+}
+
+static void testParseURL()
+{
+    bool secure;
+    char host[HTTP_CONNECTION_HOST];
+    uint16_t port;
+    const char *path;
+    CHECK(HTTPConnection::parseURL("http://example.com:8080/a?b", &secure, host, sizeof(host), &port, &path));
+    CHECK(!secure && strcmp(host, "example.com") == 0 && port == 8080 && strcmp(path, "/a?b") == 0);
+    CHECK(HTTPConnection::parseURL("example.com?q", &secure, host, sizeof(host), &port, &path));
+    CHECK(secure && port == 443 && strcmp(path, "?q") == 0);
+    CHECK(!HTTPConnection::parseURL("http:///x", &secure, host, sizeof(host), &port, &path));
+}
+
+int main()
+{
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressLength = sizeof(address);
+    if (listener < 0 || bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listener, 4) != 0 ||
+        getsockname(listener, (struct sockaddr *)&address, &addressLength) != 0)
+    {
+        perror("test_http_connection: listen");
+        return 1;
+    }
+    std::thread(serve, listener).detach();
+    uint16_t port = ntohs(address.sin_port);
+
+    testResponses(port);
+    testLongRequest(port);
+    testParseURL();
+    if (failures > 0)
+    {
+        return 1;
+    }
+    printf("test_http_connection: passed\n");
+    return 0;
+}
@@ -51,68 +51,232 @@ bool FlipperHTTP::loadWiFi()
     return false;
 }
 
-#ifdef BOARD_BW16
-String FlipperHTTP::request(
-    const char *method,
-    String url,
-    String payload,
-    const char *headerKeys[],
-    const char *headerValues[],
-    int headerSize)
+// Send a list of requests to one origin over a single connection, keeping up to
+// BATCH_PIPELINE_DEPTH GETs in flight. Each response is framed as
+// [BATCH/ITEM]{"index":i,...} body [BATCH/ITEM/END], or [BATCH/ERROR]{"index":i}.
+// Requests that are not GET are never pipelined, so only GETs are sent again when
+// the server closes the connection early
+void FlipperHTTP::batchRequest(const char *origin, JsonArray requests, const char *headerKeys[], const char *headerValues[], int headerSize)
 {
-    String response = "";                             // Initialize response string
-    this->client.setRootCA((unsigned char *)root_ca); // Set root CA for SSL
-    int index = url.indexOf('/');                     // Find the first occurrence of '/'
-    String host = url.substring(0, index);            // Extract host
-    String path = url.substring(index);               // Extract path
-
-    char host_server[64];                                    // Buffer for host server
-    strncpy(host_server, host.c_str(), sizeof(host_server)); // Copy host to buffer
+    bool secure;
+    char host[HTTP_CONNECTION_HOST];
+    uint16_t port;
+    const char *basePath;
+    if (!HTTPConnection::parseURL(origin, &secure, host, sizeof(host), &port, &basePath))
+    {
+        this->uart.println(F("[ERROR] Invalid URL."));
+        return;
+    }
+    Client *transport = secure ? (Client *)&this->client : (Client *)&this->plainClient;
+#ifndef BOARD_BW16
+    strcpy(this->requestHost, host); // for retryInsecure
+    this->requestSecure = secure;
+#endif
 
-    if (this->client.connect(host_server, 443)) // Connect to the server
+    const int total = requests.size();
+    int answered = 0; // responses read (or given up on), in order
+    int failed = 0;
+    uint8_t buffer[HTTP_CONNECTION_BUFFER];
+    while (answered < total)
     {
-        // Make a HTTP request:
-        this->client.print(method);
-        this->client.print(" ");
-        this->client.print(path);
-        this->client.println(" HTTP/1.1");
-        this->client.print("Host: ");
-        this->client.println(host_server);
-
-        // Add custom headers if provided
-        for (int i = 0; i < headerSize; i++)
+        RequestTimer timer;
+#ifndef BOARD_BW16
+        if (secure)
         {
-            this->client.print(headerKeys[i]);
-            this->client.print(": ");
-            this->client.println(headerValues[i]);
+            this->applyTLSPolicy(host);
         }
-
-        // Add payload if provided
-        if (payload != "")
+        bool connected = this->connection.connect(transport, host, port);
+        if (!connected && this->retryInsecure())
         {
-            this->client.print("Content-Length: ");
-            this->client.println(payload.length());
-            this->client.println("Content-Type: application/json");
+            connected = this->connection.connect(transport, host, port);
         }
+#else
+        if (secure)
+        {
+            this->client.setRootCA((unsigned char *)root_ca);
+        }
+        bool connected = this->connection.connect(transport, host, port);
+#endif
+        if (!connected)
+        {
+            stats.addRequest(timer, false);
+            break;
+        }
+        timer.mark(secure ? STATS_TLS : STATS_CONNECT);
 
-        this->client.println("Connection: close");
-        this->client.println();
+        int first = answered;
+        int sent = answered;
+        bool waiting = false; // a request that is not a GET is in flight, send nothing after it
+        while (answered < total)
+        {
+            while (sent < total && !waiting && sent - answered < BATCH_PIPELINE_DEPTH)
+            {
+                JsonObject item = requests[sent];
+                const char *method = item["method"] | "GET";
+                const char *path = item["path"] | basePath;
+                const char *payload = item["payload"] | "";
+                bool idempotent = strcmp(method, "GET") == 0;
+                if (!idempotent && sent > answered)
+                {
+                    break; // wait for the responses in flight first
+                }
+                if (!this->connection.sendRequest(method, path, headerKeys, headerValues, headerSize, payload, strlen(payload), sent < total - 1))
+                {
+                    break;
+                }
+                stats.addWiFiOut(strlen(payload));
+                waiting = !idempotent;
+                sent++;
+            }
+            if (sent == answered)
+            {
+                break; // nothing could be sent on this connection
+            }
 
-        // Send the payload in the request body
-        if (payload != "")
+            int statusCode = this->connection.readResponseHead();
+            timer.mark(STATS_TTFB);
+            if (statusCode <= 0)
+            {
+                if (waiting)
+                {
+                    // The server may have acted on it, so it is not sent again
+                    this->uart.printf("[BATCH/ERROR]{\"index\":%d}\r\n", answered);
+                    stats.addRequest(timer, false);
+                    answered++;
+                    failed++;
+                }
+                break;
+            }
+            waiting = false;
+            this->uart.printf("[BATCH/ITEM]{\"index\":%d,\"Status-Code\":%d,\"Content-Length\":%ld}\r\n", answered, statusCode, this->connection.contentLength());
+            int n;
+            while ((n = this->connection.read(buffer, sizeof(buffer))) > 0)
+            {
+                this->uart.write(buffer, n);
+                stats.addWiFiIn(n);
+            }
+            timer.mark(STATS_TRANSFER);
+            stats.addRequest(timer, n == 0);
+            timer.start();
+            this->uart.println();
+            this->uart.println(F("[BATCH/ITEM/END]"));
+            answered++;
+            if (n < 0)
+            {
+                failed++; // body cut short, the connection is no longer usable
+                break;
+            }
+            if (!this->connection.keepAlive())
+            {
+                break; // anything still unanswered goes on a new connection
+            }
+        }
+        this->connection.stop();
+        if (answered == first)
         {
-            this->client.println(payload);
+            break; // a new connection got no response at all, give up on the rest
         }
+    }
 
-        // read everything that’s in the buffer, then stop
-        while (this->client.available())
-            response += this->client.readStringUntil('\n') + "\n";
-        this->client.stop();
+    for (int i = answered; i < total; i++)
+    {
+        this->uart.printf("[BATCH/ERROR]{\"index\":%d}\r\n", i);
+        failed++;
     }
-    else
+    stats.sampleHeap(storage.freeHeap());
+    this->uart.flush();
+    this->uart.printf("[BATCH/END]{\"ok\":%d,\"failed\":%d}\r\n", total - failed, failed);
+}
+
+// Print the [METHOD/SUCCESS] line, with the phase timings (us) when [TIMING/ON] is set
+void FlipperHTTP::printSuccess(const char *method, int statusCode, int contentLength, const RequestTimer &timer)
+{
+    if (!this->use_timing)
+    {
+        this->uart.printf("[%s/SUCCESS]{\"Status-Code\":%d,\"Content-Length\":%d}\r\n", method, statusCode, contentLength);
+        return;
+    }
+    this->uart.printf("[%s/SUCCESS]{\"Status-Code\":%d,\"Content-Length\":%d,\"Timing\":{\"dns\":%lu,\"connect\":%lu,\"tls\":%lu,\"ttfb\":%lu,\"transfer\":%lu}}\r\n",
+                      method, statusCode, contentLength,
+                      (unsigned long)timer.phase[STATS_DNS], (unsigned long)timer.phase[STATS_CONNECT], (unsigned long)timer.phase[STATS_TLS],
+                      (unsigned long)timer.phase[STATS_TTFB], (unsigned long)timer.phase[STATS_TRANSFER]);
+}
+
+#ifdef BOARD_BW16
+// Connect to the server in url (http or https, any port) and send the request, printing the error on failure
+bool FlipperHTTP::beginRequest(const char *method, const String &url, const String &payload, const char *headerKeys[], const char *headerValues[], int headerSize, RequestTimer &timer)
+{
+    bool secure;
+    char host[HTTP_CONNECTION_HOST];
+    uint16_t port;
+    const char *path;
+    timer.start();
+    if (!HTTPConnection::parseURL(url.c_str(), &secure, host, sizeof(host), &port, &path))
+    {
+        this->uart.println(F("[ERROR] Invalid URL."));
+        return false;
+    }
+    if (secure)
+    {
+        this->client.setRootCA((unsigned char *)root_ca);
+    }
+    Client *transport = secure ? (Client *)&this->client : (Client *)&this->plainClient;
+    if (!this->connection.connect(transport, host, port))
     {
+        this->connection.stop();
         this->uart.println(F("[ERROR] Unable to connect to the server."));
+        return false;
+    }
+    timer.mark(secure ? STATS_TLS : STATS_CONNECT);
+    if (!this->connection.sendRequest(method, path, headerKeys, headerValues, headerSize, payload.c_str(), payload.length(), false))
+    {
+        this->connection.stop();
+        this->uart.printf("[ERROR] %s Request Failed, error: send failed\r\n", method);
+        return false;
+    }
+    stats.addWiFiOut(payload.length());
+    return true;
+}
+
+String FlipperHTTP::request(
+    const char *method,
+    String url,
+    String payload,
+    const char *headerKeys[],
+    const char *headerValues[],
+    int headerSize)
+{
+    String response = "";
+    RequestTimer timer;
+    if (this->beginRequest(method, url, payload, headerKeys, headerValues, headerSize, timer))
+    {
+        int statusCode = this->connection.readResponseHead();
+        timer.mark(STATS_TTFB);
+        if (statusCode > 0)
+        {
+            long length = this->connection.contentLength();
+            if (length > 0)
+            {
+                response.reserve(length);
+            }
+            char buffer[HTTP_CONNECTION_BUFFER + 1];
+            int n;
+            while ((n = this->connection.read((uint8_t *)buffer, HTTP_CONNECTION_BUFFER)) > 0)
+            {
+                buffer[n] = '\0';
+                response += buffer;
+                stats.addWiFiIn(n);
+            }
+            this->connection.stop();
+            timer.mark(STATS_TRANSFER);
+            this->printSuccess(method, statusCode, length, timer);
+            stats.addRequest(timer, true);
+            return response;
+        }
+        this->connection.stop();
+        this->uart.printf("[ERROR] %s Request Failed, error: no response\r\n", method);
     }
+    stats.addRequest(timer, false);
 
     // Clear serial buffer to avoid any residual data
     this->uart.clearBuffer();
@@ -120,6 +284,94 @@ String FlipperHTTP::request(
     return response;
 }
 #else
+// On ESP32 open the TLS connection ahead of HTTPClient so it is timed on its own (HTTPClient
+// reuses a connected client). The name is resolved inside connect, so dns stays 0 and is
+// counted in tls; plain http and the Pico count connect and TLS as TTFB. Returns false when
+// the connection could not be opened, so HTTPClient does not try the same connect again
+bool FlipperHTTP::prepareConnection(const String &url, RequestTimer &timer)
+{
+    timer.start();
+    bool secure = url.startsWith("https://");
+    int hostStart = url.indexOf("://");
+    hostStart = hostStart < 0 ? 0 : hostStart + 3;
+    int hostEnd = hostStart;
+    while (hostEnd < (int)url.length() && url[hostEnd] != '/' && url[hostEnd] != ':' && url[hostEnd] != '?')
+    {
+        hostEnd++;
+    }
+    char *host = this->requestHost;
+    host[0] = '\0';
+    this->requestSecure = secure;
+    if (hostEnd == hostStart || hostEnd - hostStart >= (int)sizeof(this->requestHost))
+    {
+        return true; // HTTPClient reports the bad URL
+    }
+    memcpy(host, url.c_str() + hostStart, hostEnd - hostStart);
+    host[hostEnd - hostStart] = '\0';
+    uint16_t port = secure ? 443 : 80;
+    if (url[hostEnd] == ':')
+    {
+        port = atoi(url.c_str() + hostEnd + 1);
+    }
+    if (secure)
+    {
+        this->applyTLSPolicy(host);
+    }
+
+#if !defined(BOARD_PICO_W) && !defined(BOARD_PICO_2W) && !defined(BOARD_VGM)
+    if (!secure)
+    {
+        return true;
+    }
+    bool connected = this->client.connect(host, port);
+    if (!connected && this->retryInsecure())
+    {
+        connected = this->client.connect(host, port);
+    }
+    if (connected)
+    {
+        timer.mark(STATS_TLS);
+    }
+    return connected;
+#else
+    (void)port; // the Pico HTTPClient does not reuse a connection it did not open
+    return true;
+#endif
+}
+
+// Switch the client between verified and unverified mode for host, only when the mode changes
+void FlipperHTTP::applyTLSPolicy(const char *host)
+{
+    bool insecure = this->tlsPolicy.isInsecure(host);
+    if (insecure == this->clientInsecure)
+    {
+        return;
+    }
+    if (insecure)
+    {
+        this->client.setInsecure();
+    }
+    else
+    {
+        this->client.setCACert(root_ca);
+    }
+    this->clientInsecure = insecure;
+}
+
+// Called after a failed connect: only a failed certificate check is worth retrying without
+// verification, and the host is remembered so its next request skips the failing attempt
+bool FlipperHTTP::retryInsecure()
+{
+    if (!this->requestSecure || this->clientInsecure || !TLSPolicy::handshakeFailed(this->client, this->requestHost))
+    {
+        return false;
+    }
+    this->tlsPolicy.markInsecure(this->requestHost);
+    this->client.setInsecure();
+    this->clientInsecure = true;
+    return true;
+}
+
 String FlipperHTTP::request(
     const char *method,
     String url,
@@ -130,6 +382,14 @@ String FlipperHTTP::request(
 {
     HTTPClient http;
     String response = "";
+    RequestTimer timer;
+    if (!this->prepareConnection(url, timer))
+    {
+        this->uart.println(F("[ERROR] Unable to connect to the server."));
+        stats.addRequest(timer, false);
+        this->uart.clearBuffer();
+        return response;
+    }
 
     http.collectHeaders(headerKeys, headerSize);
 
@@ -146,28 +406,36 @@ String FlipperHTTP::request(
         }
 
         int statusCode = http.sendRequest(method, payload);
-        char headerResponse[512];
+        timer.mark(STATS_TTFB);
+        stats.addWiFiOut(payload.length());
 
         if (statusCode > 0)
         {
-            snprintf(headerResponse, sizeof(headerResponse), "[%s/SUCCESS]{\"Status-Code\":%d,\"Content-Length\":%d}", method, statusCode, http.getSize());
-            this->uart.println(headerResponse);
+            if (!this->use_timing)
+            {
+                this->printSuccess(method, statusCode, http.getSize(), timer); // before the body is read, as always
+            }
             response = http.getString();
+            timer.mark(STATS_TRANSFER);
+            if (this->use_timing)
+            {
+                this->printSuccess(method, statusCode, http.getSize(), timer); // the transfer phase is only known now
+            }
+            stats.addWiFiIn(response.length());
+            stats.addRequest(timer, true);
             http.end();
             return response;
         }
         else
         {
-            if (statusCode != -1) // HTTPC_ERROR_CONNECTION_FAILED
+            if (statusCode != -1 || !this->retryInsecure()) // connection failed in the TLS handshake?
             {
-                snprintf(headerResponse, sizeof(headerResponse), "[ERROR] %s Request Failed, error: %s", method, http.errorToString(statusCode).c_str());
-                this->uart.println(headerResponse);
+                this->uart.printf("[ERROR] %s Request Failed, error: %s\r\n", method, http.errorToString(statusCode).c_str());
             }
-            else // certification failed?
+            else
             {
-                // send request without SSL
+                // send the request again without verifying the server
                 http.end();
-                this->client.setInsecure();
                 if (http.begin(this->client, url))
                 {
                     for (int i = 0; i < headerSize; i++)
@@ -175,20 +443,27 @@ String FlipperHTTP::request(
                         http.addHeader(headerKeys[i], headerValues[i]);
                     }
                     int newCode = http.sendRequest(method, payload);
+                    timer.mark(STATS_TTFB);
                     if (newCode > 0)
                     {
-                        snprintf(headerResponse, sizeof(headerResponse), "[%s/SUCCESS]{\"Status-Code\":%d,\"Content-Length\":%d}", method, newCode, http.getSize());
-                        this->uart.println(headerResponse);
+                        if (!this->use_timing)
+                        {
+                            this->printSuccess(method, newCode, http.getSize(), timer); // before the body is read, as always
+                        }
                         response = http.getString();
+                        timer.mark(STATS_TRANSFER);
+                        if (this->use_timing)
+                        {
+                            this->printSuccess(method, newCode, http.getSize(), timer); // the transfer phase is only known now
+                        }
+                        stats.addWiFiIn(response.length());
+                        stats.addRequest(timer, true);
                         http.end();
-                        this->client.setCACert(root_ca);
                         return response;
                     }
                     else
                     {
-                        this->client.setCACert(root_ca);
-                        snprintf(headerResponse, sizeof(headerResponse), "[ERROR] %s Request Failed, error: %s", method, http.errorToString(newCode).c_str());
-                        this->uart.println(headerResponse);
+                        this->uart.printf("[ERROR] %s Request Failed, error: %s\r\n", method, http.errorToString(newCode).c_str());
                     }
                 }
             }
@@ -200,6 +475,8 @@ String FlipperHTTP::request(
         this->uart.println(F("[ERROR] Unable to connect to the server."));
     }
 
+    stats.addRequest(timer, false);
+
     // Clear serial buffer to avoid any residual data
     this->uart.clearBuffer();
 
@@ -272,12 +549,14 @@ void FlipperHTTP::setup()
 {
 #ifdef BOARD_VGM
     this->uart.set_pins(0, 1);
+    this->uart.begin(BAUD_RATE, VGM_BRIDGE_FIFO);
+#else
+    this->uart.begin(BAUD_RATE);
 #endif
-    this->uart.begin(115200);
     this->uart.setTimeout(5000);
 #if defined(BOARD_VGM)
     this->uart_2.set_pins(24, 21);
-    this->uart_2.begin(115200);
+    this->uart_2.begin(BAUD_RATE, VGM_BRIDGE_FIFO);
     this->uart_2.setTimeout(5000);
     this->uart_2.flush();
 #endif
@@ -298,28 +577,89 @@ void FlipperHTTP::setup()
 #endif
     this->uart.flush();
     this->led.off();
+#ifdef BOARD_VGM
+    this->bridgeReady = true;
+#endif
+}
+
+#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W)
+// Second core loop for flipper-http.ino that sends queued UART output
+void FlipperHTTP::loop1()
+{
+    this->uart.drainTx();
+}
+#elif defined(BOARD_VGM)
+// Second core loop for flipper-http.ino that relays the ESP32 back to the Flipper
+void FlipperHTTP::loop1()
+{
+    if (this->bridgeReady)
+    {
+        this->uart_2.relayTo(this->uart);
+    }
 }
+#endif
 
 #ifdef BOARD_BW16
-bool FlipperHTTP::streamBytes(const char *method, String url, String payload, const char *headerKeys[], const char *headerValues[], int headerSize)
+bool FlipperHTTP::streamBytes(const char *method, String url, String payload, const char *headerKeys[], const char *headerValues[], int headerSize, unsigned long idleTimeout)
 {
-    // Not implemented for BW16
-    this->uart.print(F("[ERROR] streamBytes not implemented for BW16."));
-    this->uart.print(method);
-    this->uart.print(url);
-    this->uart.print(payload);
-    for (int i = 0; i < headerSize; i++)
+    RequestTimer timer;
+    if (!this->beginRequest(method, url, payload, headerKeys, headerValues, headerSize, timer))
+    {
+        stats.addRequest(timer, false);
+        return false;
+    }
+    int statusCode = this->connection.readResponseHead();
+    timer.mark(STATS_TTFB);
+    if (statusCode <= 0)
+    {
+        this->connection.stop();
+        this->uart.printf("[ERROR] %s Request Failed, error: no response\r\n", method);
+        stats.addRequest(timer, false);
+        return false;
+    }
+    this->printSuccess(method, statusCode, this->connection.contentLength(), timer);
+    if (idleTimeout > 0)
+    {
+        this->connection.setTimeout(idleTimeout); // the body only, stop() restores the default
+    }
+
+    // Forward the body as it arrives, chunked encoding already removed
+    uint8_t buffer[HTTP_CONNECTION_BUFFER];
+    int n;
+    while ((n = this->connection.read(buffer, sizeof(buffer))) > 0)
     {
-        this->uart.print(headerKeys[i]);
-        this->uart.print(headerValues[i]);
+        this->uart.write(buffer, n);
+        stats.addWiFiIn(n);
     }
+    this->connection.stop();
+    timer.mark(STATS_TRANSFER);
+    stats.sampleHeap(storage.freeHeap());
+    stats.addRequest(timer, n == 0);
+
+    // Flush the serial buffer to ensure all data is sent
+    this->uart.flush();
     this->uart.println();
-    return false;
+    if (strcmp(method, "GET") == 0)
+    {
+        this->uart.println(F("[GET/END]"));
+    }
+    else
+    {
+        this->uart.println(F("[POST/END]"));
+    }
+    return true;
 }
 #else
-bool FlipperHTTP::streamBytes(const char *method, String url, String payload, const char *headerKeys[], const char *headerValues[], int headerSize)
+bool FlipperHTTP::streamBytes(const char *method, String url, String payload, const char *headerKeys[], const char *headerValues[], int headerSize, unsigned long idleTimeout)
 {
     HTTPClient http;
+    RequestTimer timer;
+    if (!this->prepareConnection(url, timer))
+    {
+        this->uart.println(F("[ERROR] Unable to connect to the server."));
+        stats.addRequest(timer, false);
+        return false;
+    }
 
     http.collectHeaders(headerKeys, headerSize);
 
@@ -337,11 +677,11 @@ bool FlipperHTTP::streamBytes(const char *method, String url, String payload, co
 
         int httpCode = http.sendRequest(method, payload);
         int len = http.getSize(); // Get the response content length
-        char headerResponse[256];
+        timer.mark(STATS_TTFB);
+        stats.addWiFiOut(payload.length());
         if (httpCode > 0)
         {
-            snprintf(headerResponse, sizeof(headerResponse), "[%s/SUCCESS]{\"Status-Code\":%d,\"Content-Length\":%d}", method, httpCode, len);
-            this->uart.println(headerResponse);
+            this->printSuccess(method, httpCode, len, timer);
             uint8_t buff[512] = {0}; // Buffer for reading data
 
             WiFiClient *stream = http.getStreamPtr();
@@ -357,7 +697,7 @@ bool FlipperHTTP::streamBytes(const char *method, String url, String payload, co
 
             // Start timeout timer
             unsigned long timeoutStart = millis();
-            const unsigned long timeoutInterval = 2000; // 2 seconds
+            const unsigned long timeoutInterval = idleTimeout > 0 ? idleTimeout : STREAM_IDLE_TIMEOUT;
 
             // Stream data while connected and available
             while (http.connected() && (len > 0 || len == -1))
@@ -370,6 +710,7 @@ bool FlipperHTTP::streamBytes(const char *method, String url, String payload, co
 
                     int c = stream->readBytes(buff, ((size > sizeof(buff)) ? sizeof(buff) : size));
                     this->uart.write(buff, c); // Write data to serial
+                    stats.addWiFiIn(c);
                     if (len > 0)
                     {
                         len -= c;
@@ -386,6 +727,7 @@ bool FlipperHTTP::streamBytes(const char *method, String url, String payload, co
                 delay(1); // Yield control to the system
             }
             freeHeap = storage.freeHeap(); // Check available heap memory after processing
+            stats.sampleHeap(freeHeap);
             if (freeHeap < minHeapThreshold)
             {
                 this->uart.println(F("[ERROR] Not enough memory to continue processing the response."));
@@ -394,6 +736,8 @@ bool FlipperHTTP::streamBytes(const char *method, String url, String payload, co
             }
 
             http.end();
+            timer.mark(STATS_TRANSFER);
+            stats.addRequest(timer, true);
             // Flush the serial buffer to ensure all data is sent
             this->uart.flush();
             this->uart.println();
@@ -409,16 +753,14 @@ bool FlipperHTTP::streamBytes(const char *method, String url, String payload, co
         }
         else
         {
-            if (httpCode != -1) // HTTPC_ERROR_CONNECTION_FAILED
+            if (httpCode != -1 || !this->retryInsecure()) // connection failed in the TLS handshake?
             {
-                snprintf(headerResponse, sizeof(headerResponse), "[ERROR] %s Request Failed, error: %s", method, http.errorToString(httpCode).c_str());
-                this->uart.println(headerResponse);
+                this->uart.printf("[ERROR] %s Request Failed, error: %s\r\n", method, http.errorToString(httpCode).c_str());
             }
-            else // certification failed?
+            else
             {
-                // Send request without SSL
+                // Send the request again without verifying the server
                 http.end();
-                this->client.setInsecure();
                 if (http.begin(this->client, url))
                 {
                     for (int i = 0; i < headerSize; i++)
@@ -427,10 +769,10 @@ bool FlipperHTTP::streamBytes(const char *method, String url, String payload, co
                     }
                     int newCode = http.sendRequest(method, payload);
                     int len = http.getSize(); // Get the response content length
+                    timer.mark(STATS_TTFB);
                     if (newCode > 0)
                     {
-                        snprintf(headerResponse, sizeof(headerResponse), "[%s/SUCCESS]{\"Status-Code\":%d,\"Content-Length\":%d}", method, newCode, len);
-                        this->uart.println(headerResponse);
+                        this->printSuccess(method, newCode, len, timer);
                         uint8_t buff[512] = {0}; // Buffer for reading data
 
                         WiFiClient *stream = http.getStreamPtr();
@@ -441,13 +783,12 @@ bool FlipperHTTP::streamBytes(const char *method, String url, String payload, co
                         {
                             this->uart.println(F("[ERROR] Not enough memory to start processing the response."));
                             http.end();
-                            this->client.setCACert(root_ca);
                             return false;
                         }
 
                         // Start timeout timer
                         unsigned long timeoutStart = millis();
-                        const unsigned long timeoutInterval = 2000; // 2 seconds
+                        const unsigned long timeoutInterval = idleTimeout > 0 ? idleTimeout : STREAM_IDLE_TIMEOUT;
 
                         // Stream data while connected and available
                         while (http.connected() && (len > 0 || len == -1))
@@ -460,6 +801,7 @@ bool FlipperHTTP::streamBytes(const char *method, String url, String payload, co
 
                                 int c = stream->readBytes(buff, ((size > sizeof(buff)) ? sizeof(buff) : size));
                                 this->uart.write(buff, c); // Write data to serial
+                                stats.addWiFiIn(c);
                                 if (len > 0)
                                 {
                                     len -= c;
@@ -477,15 +819,17 @@ bool FlipperHTTP::streamBytes(const char *method, String url, String payload, co
                         }
 
                         freeHeap = storage.freeHeap(); // Check available heap memory after processing
+                        stats.sampleHeap(freeHeap);
                         if (freeHeap < 1024)
                         {
                             this->uart.println(F("[ERROR] Not enough memory to continue processing the response."));
                             http.end();
-                            this->client.setCACert(root_ca);
                             return false;
                         }
 
                         http.end();
+                        timer.mark(STATS_TRANSFER);
+                        stats.addRequest(timer, true);
                         // Flush the serial buffer to ensure all data is sent
                         this->uart.flush();
                         this->uart.println();
@@ -497,17 +841,13 @@ bool FlipperHTTP::streamBytes(const char *method, String url, String payload, co
                         {
                             this->uart.println(F("[POST/END]"));
                         }
-                        this->client.setCACert(root_ca);
                         return true;
                     }
                     else
                     {
-                        this->client.setCACert(root_ca);
-                        snprintf(headerResponse, sizeof(headerResponse), "[ERROR] %s Request Failed, error: %s", method, http.errorToString(newCode).c_str());
-                        this->uart.println(headerResponse);
+                        this->uart.printf("[ERROR] %s Request Failed, error: %s\r\n", method, http.errorToString(newCode).c_str());
                     }
                 }
-                this->client.setCACert(root_ca);
             }
         }
         http.end();
@@ -516,6 +856,7 @@ bool FlipperHTTP::streamBytes(const char *method, String url, String payload, co
     {
         this->uart.println(F("[ERROR] Unable to connect to the server."));
     }
+    stats.addRequest(timer, false);
     return false;
 }
 #endif
@@ -560,42 +901,57 @@ bool FlipperHTTP::readSerialSettings(String receivedData, bool connectAfterSave)
     return true;
 }
 
+// Close a WebSocket session and free its slot
+void FlipperHTTP::closeSocket(int id)
+{
+    this->sockets[id]->stop();
+    const char *reason = this->sockets[id]->closeReason(); // a string literal, it outlives the session
+    delete this->sockets[id];
+    this->sockets[id] = nullptr;
+
+    this->uart.printf("[SOCKET/CLOSED]{\"id\":%d,\"reason\":\"%s\"}\r\n", id, reason);
+}
+
+// Move data for every open WebSocket session
+void FlipperHTTP::pumpSockets()
+{
+    for (int i = 0; i < WEBSOCKET_MAX_SESSIONS; i++)
+    {
+        if (this->sockets[i] == nullptr)
+        {
+            continue;
+        }
+
+        // One chunk per session and call; a session holds back new messages while another is part-way through one
+        if (!this->sockets[i]->loop())
+        {
+            this->closeSocket(i);
+        }
+    }
+}
+
 // Main loop for flipper-http.ino that handles all of the commands
 void FlipperHTTP::loop()
 {
 #ifdef BOARD_VGM
-    // Check if there's incoming serial data
-    if (this->uart.available() > 0)
+    // Flipper -> ESP32 on this core, ESP32 -> Flipper on the second core (loop1)
+    if (this->uart.relayTo(this->uart_2) > 0)
     {
         this->led.on();
-
-        // Read the incoming serial data until newline
-        String _data = this->uart.readSerialLine();
-
-        // send to ESP32
-        this->uart_2.println(_data);
-
-        // Wait for response from ESP32
-        String _response = this->uart_2.readSerialLine();
-
-        // Send response back to Flipper
-        this->uart.println(_response);
-
-        this->led.off();
     }
-    else if (this->uart_2.available() > 0)
+    else
     {
-        this->led.on();
-
-        // Read the incoming serial data until newline
-        String _data = this->uart_2.readSerialLine();
-
-        // send to Flipper
-        this->uart.println(_data);
-
         this->led.off();
     }
 #else
+    this->pumpSockets();
+    if (WebSocket::uartBusy())
+    {
+        // Command output would land in the middle of a server message, leave the command for the next loop
+        yield();
+        return;
+    }
+
     // Check if there's incoming serial data
     if (this->uart.available())
     {
@@ -610,16 +966,46 @@ void FlipperHTTP::loop()
 
         this->led.on();
 
+        // Nothing from the previous command is still in use
+        this->arena.reset();
+        stats.addCommand(_data.c_str());
+
         // print the available commands
         if (_data.startsWith("[LIST]"))
         {
-            this->uart.println(F("[LIST], [PING], [REBOOT], [WIFI/IP], [WIFI/SCAN], [WIFI/SAVE], [WIFI/CONNECT], [WIFI/DISCONNECT], [WIFI/LIST], [GET], [GET/HTTP], [POST/HTTP], [PUT/HTTP], [DELETE/HTTP], [GET/BYTES], [POST/BYTES], [PARSE], [PARSE/ARRAY], [LED/ON], [LED/OFF], [IP/ADDRESS], [WIFI/AP], [VERSION], [DEAUTH]"));
+            this->uart.println(F("[LIST], [PING], [REBOOT], [WIFI/IP], [WIFI/SCAN], [WIFI/SAVE], [WIFI/CONNECT], [WIFI/DISCONNECT], [WIFI/LIST], [GET], [GET/HTTP], [POST/HTTP], [PUT/HTTP], [DELETE/HTTP], [GET/BYTES], [POST/BYTES], [BATCH/HTTP], [PARSE], [PARSE/ARRAY], [LED/ON], [LED/OFF], [IP/ADDRESS], [WIFI/AP], [VERSION], [DEAUTH], [SOCKET/START], [SOCKET/OPEN], [SOCKET/CLOSE], [HEAP], [STATS], [STATS/RESET], [TIMING/ON], [TIMING/OFF]"));
+        }
+        // memory usage: free heap, largest free block and arena usage
+        else if (_data.startsWith("[HEAP]"))
+        {
+            this->uart.printf("{\"free\":%u,\"max_block\":%u,\"arena_peak\":%u,\"arena_overflows\":%u}\r\n",
+                              (unsigned)this->storage.freeHeap(), (unsigned)this->storage.maxFreeBlock(),
+                              (unsigned)this->arena.peak(), (unsigned)this->arena.overflows());
+        }
+        // counters since boot or the last [STATS/RESET]
+        else if (_data.startsWith("[STATS/RESET]"))
+        {
+            stats.reset();
+            this->uart.println(F("[STATS/RESET]"));
+        }
+        else if (_data.startsWith("[STATS]"))
+        {
+            stats.print(this->uart, this->storage.freeHeap(), this->storage.maxFreeBlock());
         }
         // handle [LED/ON] command
         else if (_data.startsWith("[LED/ON]"))
         {
             this->use_led = true;
         }
+        // [TIMING/ON] adds per-request phase timings to the SUCCESS line ([GET/HTTP] and the like send it once the body is read)
+        else if (_data.startsWith("[TIMING/ON]"))
+        {
+            this->use_timing = true;
+        }
+        else if (_data.startsWith("[TIMING/OFF]"))
+        {
+            this->use_timing = false;
+        }
         // handle [LED/OFF] command
         else if (_data.startsWith("[LED/OFF]"))
         {
@@ -651,7 +1037,7 @@ void FlipperHTTP::loop()
                 this->uart.println(F("[ERROR] GET request failed or returned empty data."));
                 return;
             }
-            JsonDocument doc;
+            JsonDocument doc(&this->arena);
             DeserializationError error = deserializeJson(doc, jsonData);
             if (error)
             {
@@ -786,10 +1172,9 @@ void FlipperHTTP::loop()
             }
 
             // Extract the JSON by removing the command part
-            String jsonData = _data.substring(strlen("[GET/HTTP]"));
-            jsonData.trim();
+            const char *jsonData = _data.c_str() + strlen("[GET/HTTP]");
 
-            JsonDocument doc;
+            JsonDocument doc(&this->arena);
             DeserializationError error = deserializeJson(doc, jsonData);
 
             if (error)
@@ -849,10 +1234,9 @@ void FlipperHTTP::loop()
             }
 
             // Extract the JSON by removing the command part
-            String jsonData = _data.substring(strlen("[POST/HTTP]"));
-            jsonData.trim();
+            const char *jsonData = _data.c_str() + strlen("[POST/HTTP]");
 
-            JsonDocument doc;
+            JsonDocument doc(&this->arena);
             DeserializationError error = deserializeJson(doc, jsonData);
 
             if (error)
@@ -913,10 +1297,9 @@ void FlipperHTTP::loop()
             }
 
             // Extract the JSON by removing the command part
-            String jsonData = _data.substring(strlen("[PUT/HTTP]"));
-            jsonData.trim();
+            const char *jsonData = _data.c_str() + strlen("[PUT/HTTP]");
 
-            JsonDocument doc;
+            JsonDocument doc(&this->arena);
             DeserializationError error = deserializeJson(doc, jsonData);
 
             if (error)
@@ -977,10 +1360,9 @@ void FlipperHTTP::loop()
             }
 
             // Extract the JSON by removing the command part
-            String jsonData = _data.substring(strlen("[DELETE/HTTP]"));
-            jsonData.trim();
+            const char *jsonData = _data.c_str() + strlen("[DELETE/HTTP]");
 
-            JsonDocument doc;
+            JsonDocument doc(&this->arena);
             DeserializationError error = deserializeJson(doc, jsonData);
 
             if (error)
@@ -1042,10 +1424,9 @@ void FlipperHTTP::loop()
             }
 
             // Extract the JSON by removing the command part
-            String jsonData = _data.substring(strlen("[GET/BYTES]"));
-            jsonData.trim();
+            const char *jsonData = _data.c_str() + strlen("[GET/BYTES]");
 
-            JsonDocument doc;
+            JsonDocument doc(&this->arena);
             DeserializationError error = deserializeJson(doc, jsonData);
 
             if (error)
@@ -1080,8 +1461,8 @@ void FlipperHTTP::loop()
                 }
             }
 
-            // GET request
-            if (!this->streamBytes("GET", url, "", headerKeys, headerValues, headerSize))
+            // GET request, "timeout" is how long to wait for more data from the server
+            if (!this->streamBytes("GET", url, "", headerKeys, headerValues, headerSize, doc["timeout"] | 0UL))
             {
                 this->uart.println(F("[ERROR] GET request failed or returned empty data."));
             }
@@ -1097,10 +1478,9 @@ void FlipperHTTP::loop()
             }
 
             // Extract the JSON by removing the command part
-            String jsonData = _data.substring(strlen("[POST/BYTES]"));
-            jsonData.trim();
+            const char *jsonData = _data.c_str() + strlen("[POST/BYTES]");
 
-            JsonDocument doc;
+            JsonDocument doc(&this->arena);
             DeserializationError error = deserializeJson(doc, jsonData);
 
             if (error)
@@ -1136,20 +1516,79 @@ void FlipperHTTP::loop()
                 }
             }
 
-            // POST request
-            if (!this->streamBytes("POST", url, payload, headerKeys, headerValues, headerSize))
+            // POST request, "timeout" is how long to wait for more data from the server
+            if (!this->streamBytes("POST", url, payload, headerKeys, headerValues, headerSize, doc["timeout"] | 0UL))
             {
                 this->uart.println(F("[ERROR] POST request failed or returned empty data."));
             }
         }
+        // Handle [BATCH/HTTP]: several requests to one origin, pipelined over one connection
+        else if (_data.startsWith("[BATCH/HTTP]"))
+        {
+            if (!this->wifi.isConnected() && !this->wifi.connect(loaded_ssid, loaded_pass))
+            {
+                this->uart.println(F("[ERROR] Not connected to Wifi. Failed to reconnect."));
+                this->led.off();
+                return;
+            }
+
+            // Extract the JSON by removing the command part
+            const char *jsonData = _data.c_str() + strlen("[BATCH/HTTP]");
+
+            JsonDocument doc(&this->arena);
+            DeserializationError error = deserializeJson(doc, jsonData);
+
+            if (error)
+            {
+                this->uart.print(F("[ERROR] Failed to parse JSON."));
+                this->led.off();
+                return;
+            }
+
+            // Extract values from JSON
+            if (!doc["url"] || !doc["requests"].is<JsonArray>())
+            {
+                this->uart.println(F("[ERROR] JSON does not contain url or requests."));
+                this->led.off();
+                return;
+            }
+            JsonArray requests = doc["requests"];
+            if (requests.size() == 0 || requests.size() > BATCH_MAX_REQUESTS)
+            {
+                this->uart.printf("[ERROR] requests must contain 1 to %d entries.\r\n", BATCH_MAX_REQUESTS);
+                this->led.off();
+                return;
+            }
+
+            // Extract headers if available (sent with every request)
+            const char *headerKeys[10];
+            const char *headerValues[10];
+            int headerSize = 0;
+
+            if (doc["headers"])
+            {
+                JsonObject headers = doc["headers"];
+                for (JsonPair header : headers)
+                {
+                    if (headerSize == 10)
+                    {
+                        break;
+                    }
+                    headerKeys[headerSize] = header.key().c_str();
+                    headerValues[headerSize] = header.value();
+                    headerSize++;
+                }
+            }
+
+            this->batchRequest(doc["url"].as<const char *>(), requests, headerKeys, headerValues, headerSize);
+        }
         // Handle [PARSE] command
         else if (_data.startsWith("[PARSE]"))
         {
             // Extract the JSON by removing the command part
-            String jsonData = _data.substring(strlen("[PARSE]"));
-            jsonData.trim();
+            const char *jsonData = _data.c_str() + strlen("[PARSE]");
 
-            JsonDocument doc;
+            JsonDocument doc(&this->arena);
             DeserializationError error = deserializeJson(doc, jsonData);
 
             if (error)
@@ -1182,10 +1621,9 @@ void FlipperHTTP::loop()
         else if (_data.startsWith("[PARSE/ARRAY]"))
         {
             // Extract the JSON by removing the command part
-            String jsonData = _data.substring(strlen("[PARSE/ARRAY]"));
-            jsonData.trim();
+            const char *jsonData = _data.c_str() + strlen("[PARSE/ARRAY]");
 
-            JsonDocument doc;
+            JsonDocument doc(&this->arena);
             DeserializationError error = deserializeJson(doc, jsonData);
 
             if (error)
@@ -1215,15 +1653,25 @@ void FlipperHTTP::loop()
                 this->uart.println(F("[ERROR] Key not found in JSON."));
             }
         }
-        // websocket
-        else if (_data.startsWith("[SOCKET/START]"))
+        // [SOCKET/OPEN]{"url":...} opens a WebSocket session that stays open alongside other commands
+        else if (_data.startsWith("[SOCKET/OPEN]"))
         {
+            int id = 0;
+            while (id < WEBSOCKET_MAX_SESSIONS && this->sockets[id] != nullptr)
+            {
+                id++;
+            }
+            if (id == WEBSOCKET_MAX_SESSIONS)
+            {
+                this->uart.println(F("[ERROR] No free WebSocket sessions."));
+                this->led.off();
+                return;
+            }
+
             // Remove the command prefix to isolate the JSON payload
-            String jsonData = _data.substring(strlen("[SOCKET/START]"));
-            jsonData.trim();
+            const char *jsonData = _data.c_str() + strlen("[SOCKET/OPEN]");
 
-            // Create a JsonDocument with an appropriate size
-            JsonDocument doc;
+            JsonDocument doc(&this->arena);
             DeserializationError error = deserializeJson(doc, jsonData);
 
             if (error)
@@ -1233,50 +1681,130 @@ void FlipperHTTP::loop()
                 return;
             }
 
-            // Ensure that the JSON contains a "url" and "port"
+            // Ensure that the JSON contains a "url"
             if (!doc["url"])
             {
                 this->uart.println(F("[ERROR] JSON does not contain url."));
                 this->led.off();
                 return;
             }
-            String fullUrl = doc["url"].as<String>();
+            const char *url = doc["url"];
+
+            // The port defaults to 80 for ws:// and 443 for wss://
+            int port = doc["port"] | 0;
 
-            if (!doc["port"])
+            // Extract headers if available
+            int headerSize = 0;
+            const char *headerKeys[10];
+            const char *headerValues[10];
+
+            if (doc["headers"])
             {
-                this->uart.println(F("[ERROR] JSON does not contain port."));
+                JsonObject headers = doc["headers"];
+                for (JsonPair kv : headers)
+                {
+                    if (headerSize >= 10)
+                    {
+                        break;
+                    }
+                    headerKeys[headerSize] = kv.key().c_str();
+                    headerValues[headerSize] = kv.value().as<const char *>();
+                    headerSize++;
+                }
+            }
+
+            WebSocket *socket = new WebSocket(&this->uart, id);
+            if (!socket->begin(url, port, headerKeys, headerValues, headerSize, root_ca, &this->tlsPolicy))
+            {
+                delete socket;
+                this->uart.println(F("[ERROR] WebSocket connection failed."));
                 this->led.off();
                 return;
             }
-            int port = doc["port"].as<int>();
+            this->sockets[id] = socket;
 
-            // Parse the fullUrl to extract server name and path.
-            // Expected format: "ws://www.jblanked.com/ws/game/new/"
-            String serverName;
-            String path = "/";
+            this->uart.printf("[SOCKET/OPENED]{\"id\":%d}\r\n", id);
+        }
+        // [SOCKET/CLOSE]{"id":<id>} closes a WebSocket session
+        else if (_data.startsWith("[SOCKET/CLOSE]"))
+        {
+            const char *jsonData = _data.c_str() + strlen("[SOCKET/CLOSE]");
+
+            JsonDocument doc(&this->arena);
+            DeserializationError error = deserializeJson(doc, jsonData);
+            int id = error ? -1 : (doc["id"] | -1);
 
-            // Remove protocol ("ws://" or "wss://")
-            if (fullUrl.startsWith("ws://"))
+            if (id < 0 || id >= WEBSOCKET_MAX_SESSIONS || this->sockets[id] == nullptr)
             {
-                fullUrl = fullUrl.substring(5);
+                this->uart.println(F("[ERROR] Invalid WebSocket session."));
+                this->led.off();
+                return;
             }
-            else if (fullUrl.startsWith("wss://"))
+            this->closeSocket(id);
+        }
+        // [SOCKET/<id>]<text> or [SOCKET/<id>/BINARY]<length> followed by <length> raw bytes
+        else if (_data.startsWith("[SOCKET/") && isDigit(_data[strlen("[SOCKET/")]))
+        {
+            int id = _data.substring(strlen("[SOCKET/")).toInt();
+            int end = _data.indexOf(']');
+
+            if (end < 0 || id >= WEBSOCKET_MAX_SESSIONS || this->sockets[id] == nullptr)
             {
-                fullUrl = fullUrl.substring(6);
+                this->uart.println(F("[ERROR] Invalid WebSocket session."));
+                this->led.off();
+                return;
             }
+            WebSocket *socket = this->sockets[id];
 
-            // Look for the first '/' that separates the server name from the path.
-            int slashIndex = fullUrl.indexOf('/');
-            if (slashIndex != -1)
+            if (_data.substring(0, end).endsWith("/BINARY"))
             {
-                serverName = fullUrl.substring(0, slashIndex);
-                path = fullUrl.substring(slashIndex);
+                long length = _data.substring(end + 1).toInt();
+                socket->sendBinaryFromUART(length > 0 ? (size_t)length : 0);
             }
             else
             {
-                serverName = fullUrl;
-                path = "/";
+                // The line has already been read, so make room by pumping this session
+                while (socket->queueFull() && socket->loop())
+                {
+                }
+                if (!socket->connected())
+                {
+                    this->closeSocket(id); // the message is dropped with the session, [SOCKET/CLOSED] says so
+                }
+                else if (!socket->queueText(_data.c_str() + end + 1, _data.length() - end - 1))
+                {
+                    this->uart.printf("[ERROR] WebSocket session %d could not send the message.\r\n", id);
+                }
             }
+        }
+        // websocket (takes over the UART until [SOCKET/STOP])
+        else if (_data.startsWith("[SOCKET/START]"))
+        {
+            // Remove the command prefix to isolate the JSON payload
+            const char *jsonData = _data.c_str() + strlen("[SOCKET/START]");
+
+            // Create a JsonDocument with an appropriate size
+            JsonDocument doc(&this->arena);
+            DeserializationError error = deserializeJson(doc, jsonData);
+
+            if (error)
+            {
+                this->uart.println(F("[ERROR] Failed to parse JSON."));
+                this->led.off();
+                return;
+            }
+
+            // Ensure that the JSON contains a "url"
+            if (!doc["url"])
+            {
+                this->uart.println(F("[ERROR] JSON does not contain url."));
+                this->led.off();
+                return;
+            }
+            const char *url = doc["url"];
+
+            // The port defaults to 80 for ws:// and 443 for wss://
+            int port = doc["port"] | 0;
 
             // Extract headers if available
             int headerSize = 0;
@@ -1294,27 +1822,10 @@ void FlipperHTTP::loop()
                 }
             }
 
-            /*
-              weirdly enough, using our client didn't work for all websites
-              in the future we should try to connect with our client first,
-              then if it fails, use the WiFiClient.
-            */
-            WiFiClient wifi_client;
-
-            // Create your WebSocketClient with the client, server name, and port
-            WebSocketClient ws = WebSocketClient(wifi_client, serverName.c_str(), port);
-
-            // Send headers, if any
-            for (int i = 0; i < headerSize; i++)
-            {
-                ws.sendHeader(headerKeys[i], headerValues[i]);
-            }
-
-            // Begin the WebSocket connection, passing in the extracted path
-            ws.begin(path.c_str());
-
-            if (!ws.connected())
+            WebSocket *socket = new WebSocket(&this->uart);
+            if (!socket->begin(url, port, headerKeys, headerValues, headerSize, root_ca, &this->tlsPolicy))
             {
+                delete socket;
                 this->uart.println(F("[ERROR] WebSocket connection failed."));
                 this->led.off();
                 return;
@@ -1322,50 +1833,47 @@ void FlipperHTTP::loop()
 
             this->uart.println(F("[SOCKET/CONNECTED]"));
 
-            // Check if a message is available from the server:
-            if (ws.parseMessage() > 0)
+            // Pump both directions until [SOCKET/STOP] or the server goes away, the other sessions keep running
+            while (socket->loop())
             {
-                // Read the message from the server
-                String message = ws.readString();
-                this->uart.println(message);
-            }
-
-            // Wait for incoming serial/client data, and send back-n-forth
-            String uartMessage = "";
-            String wsMessage = "";
-            while (ws.connected() && !uartMessage.startsWith("[SOCKET/STOP]"))
-            {
-                // Check if there's incoming serial data
-                if (this->uart.available() > 0)
+                this->pumpSockets();
+                // Leave lines in the UART buffer while the outgoing queue is full
+                if (this->uart.available() > 0 && !socket->queueFull())
                 {
-                    // Read the incoming serial data until newline
-                    uartMessage = this->uart.readSerialLine();
-                    ws.beginMessage(TYPE_TEXT);
-                    ws.print(uartMessage);
-                    ws.endMessage();
+                    String uartMessage = this->uart.readSerialLine();
+                    if (uartMessage.startsWith("[SOCKET/STOP]"))
+                    {
+                        break;
+                    }
+                    else if (uartMessage.startsWith(WEBSOCKET_BINARY))
+                    {
+                        // [SOCKET/BINARY]<length> followed by <length> raw bytes
+                        long length = uartMessage.substring(strlen(WEBSOCKET_BINARY)).toInt();
+                        socket->sendBinaryFromUART(length > 0 ? (size_t)length : 0);
+                    }
+                    else if (uartMessage.length() > 0)
+                    {
+                        socket->queueText(uartMessage.c_str(), uartMessage.length());
+                    }
                 }
-
-                // Check if there's incoming websocket data
-                if (ws.parseMessage() > 0)
+                else if (socket->isIdle())
                 {
-                    // Read the message from the server
-                    wsMessage = ws.readString();
-                    this->uart.println(wsMessage);
+                    delay(1);
                 }
             }
 
             // Close the WebSocket connection
-            ws.stop();
+            socket->stop();
+            delete socket;
             this->uart.println(F("[SOCKET/STOPPED]"));
         }
         // [WIFI/AP] AP Mode
         else if (_data.startsWith("[WIFI/AP]"))
         {
             // Extract the JSON by removing the command part
-            String jsonData = _data.substring(strlen("[WIFI/AP]"));
-            jsonData.trim();
+            const char *jsonData = _data.c_str() + strlen("[WIFI/AP]");
 
-            JsonDocument doc;
+            JsonDocument doc(&this->arena);
             DeserializationError error = deserializeJson(doc, jsonData);
 
             if (error)
@@ -1385,7 +1893,7 @@ void FlipperHTTP::loop()
 
             String ssid = doc["ssid"];
 
-            WiFiAP ap(&this->uart, &this->wifi);
+            WiFiAP ap(&this->uart, &this->wifi, &this->storage);
 
             if (!ap.start(ssid.c_str()))
             {
@@ -1394,17 +1902,23 @@ void FlipperHTTP::loop()
             }
 
             this->uart.println(F("[AP/CONNECTED]"));
-            ap.run();
+            // WebSocket sessions keep running while AP mode has the UART
+            ap.run([](void *context) -> bool
+                   {
+                       FlipperHTTP *self = (FlipperHTTP *)context;
+                       self->pumpSockets();
+                       return WebSocket::uartBusy();
+                   },
+                   this);
             this->uart.println(F("[AP/DISCONNECTED]"));
         }
         // [DEAUTH] Deauth command
         else if (_data.startsWith("[DEAUTH]"))
         {
             // Extract the JSON by removing the command part
-            String jsonData = _data.substring(strlen("[DEAUTH]"));
-            jsonData.trim();
+            const char *jsonData = _data.c_str() + strlen("[DEAUTH]");
 
-            JsonDocument doc;
+            JsonDocument doc(&this->arena);
             DeserializationError error = deserializeJson(doc, jsonData);
 
             if (error)
@@ -1450,6 +1964,7 @@ void FlipperHTTP::loop()
             this->uart.println(F("[DEAUTH/STOPPED]"));
         }
 
+        stats.sampleHeap(this->storage.freeHeap());
         this->led.off();
     }
 #endif
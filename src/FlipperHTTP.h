@@ -3,7 +3,7 @@ Author: JBlanked
 Github: https://github.com/jblanked/FlipperHTTP
 Info: This library is a wrapper around the HTTPClient library and is used to communicate with the FlipperZero over serial.
 Created: 2024-09-30
-Updated: 2025-05-03
+Updated: 2026-10-18
 
 Change Log:
 - 2024-09-30: Initial commit
@@ -43,10 +43,32 @@ Change Log:
 - 2025-04-26: Updated AP mode to redirect clients to the captive portal
 - 2025-04-30: Added support for the ESP32-C5 board
 - 2025-05-03: Added deauth support for ESP32 and BW16 boards
+- 2026-10-18:
+    - Rewrote AP mode as a non-blocking server that handles multiple clients with keep-alive
+    - AP mode serves static assets from storage ([WIFI/AP/UPLOAD], [WIFI/AP/DELETE]) and [WIFI/AP/UPDATE] streams to flash (cleared when AP mode starts, as before)
+    - AP mode reports GET query and POST form submissions as one [AP/INPUT]{...} JSON line each
+    - Moved the WebSocket bridge into a WebSocket class (websocket.h/cpp) with wss, binary frames ([SOCKET/BINARY]), fragmentation, keepalive pings and a bounded send queue
+    - Added [SOCKET/OPEN] and [SOCKET/CLOSE] for WebSocket sessions that stay open alongside other commands, multiplexed over UART as [SOCKET/<id>]
+    - [SOCKET/OPEN] sessions keep running during [SOCKET/START] and AP mode; a message a session cannot send is answered with [ERROR] (or [SOCKET/CLOSED] when the session is gone)
+    - The VGM bridge relays bytes in both directions at once (one direction per core) instead of one line at a time
+    - UART output is queued in a 4 KB transmit ring buffer and sent in the background (ESP32 driver ISR, second core on Pico W/2W)
+    - UART print/println take const char*, F() strings, String references and (pointer, length) without copying into a String; printf works on every board
+    - Command JSON documents are allocated from a per-command arena instead of the heap; [HEAP] reports free heap, largest free block and arena usage
+    - Added performance counters (stats.h/cpp): [STATS] prints command counts, request phase histograms, UART/WiFi bytes, heap low-water and reconnects as JSON; [STATS/RESET] clears them
+    - [TIMING/ON] adds a "Timing" object (dns, connect, tls, ttfb, transfer in microseconds) to the [METHOD/SUCCESS] line; with timing on, request() reads the body before printing SUCCESS; the name lookup is not done separately, so dns is 0 and counted in connect or tls
+    - HTTP and WebSocket connections only retry without certificate checks after the certificate was rejected (not after a connect or other TLS failure), and hosts that needed it go straight to unverified mode afterwards (tls_policy.h/cpp)
+    - BW16 requests use a small HTTP/1.1 client (http_connection.h/cpp): http or https on any port, status and headers parsed, chunked bodies decoded, [GET/BYTES] and [POST/BYTES] supported
+    - Added [BATCH/HTTP] to pipeline up to 16 requests to one origin over a single connection, each response framed as [BATCH/ITEM]{...} body [BATCH/ITEM/END]
+    - [GET/BYTES] and [POST/BYTES] take an optional "timeout" (ms) for how long the stream waits for more data from the server (default 2 seconds)
+    - The UART is started at BAUD_RATE instead of a literal 115200, so a faster rate is changed in one place
 */
 #pragma once
+#include "arena.h"
 #include "certs.h"
+#include "http_connection.h"
 #include "led.h"
+#include "stats.h"
+#include "tls_policy.h"
 #include "uart.h"
 #include "wifi_utils.h"
 #include <ArduinoJson.h>
@@ -55,9 +77,16 @@ Change Log:
 #include <stdint.h>
 #include <string.h>
 #include "storage.h"
+#include "websocket.h"
 
-#define BAUD_RATE 115200
+#define BAUD_RATE 115200 // UART rate to the Flipper, must match BAUDRATE in the Flipper app
 #define FLIPPER_HTTP_VERSION "2.0"
+#define BATCH_MAX_REQUESTS 16    // Requests accepted in one [BATCH/HTTP] command
+#define BATCH_PIPELINE_DEPTH 4   // GET requests sent ahead of their responses in [BATCH/HTTP]
+#define STREAM_IDLE_TIMEOUT 2000 // Time (ms) [GET/BYTES] and [POST/BYTES] wait for more data unless the request sets "timeout"
+#ifdef BOARD_VGM
+#define VGM_BRIDGE_FIFO 4096 // Receive ring buffer (bytes) on each side of the VGM bridge
+#endif
 
 class FlipperHTTP
 {
@@ -78,30 +107,56 @@ public:
         int headerSize = 0                    // Number of headers
     );
     //
-    bool saveWiFi(String data);                                                                                                             // Save and Load settings to and from storage
-    void setup();                                                                                                                           // Arduino setup function
-    bool streamBytes(const char *method, String url, String payload, const char *headerKeys[], const char *headerValues[], int headerSize); // Stream bytes from server
-    bool readSerialSettings(String receivedData, bool connectAfterSave);                                                                    // Read the serial data and save the settings
-    void loop();                                                                                                                            // Main loop for flipper-http.ino that handles all of the commands
+    bool saveWiFi(String data);                                                                                                                                            // Save and Load settings to and from storage
+    void setup();                                                                                                                                                          // Arduino setup function
+    bool streamBytes(const char *method, String url, String payload, const char *headerKeys[], const char *headerValues[], int headerSize, unsigned long idleTimeout = 0); // Stream bytes from server (idleTimeout 0 for the default)
+    bool readSerialSettings(String receivedData, bool connectAfterSave);                                                                                                   // Read the serial data and save the settings
+    void loop();                                                                                                                                                           // Main loop for flipper-http.ino that handles all of the commands
+#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
+    void loop1(); // Second core loop for flipper-http.ino (UART output on Pico W/2W, ESP32 -> Flipper on VGM)
+#endif
 private:
+    void batchRequest(const char *origin, JsonArray requests, const char *headerKeys[], const char *headerValues[], int headerSize); // Pipeline requests to one origin ([BATCH/HTTP])
+    void closeSocket(int id); // Close a WebSocket session and free its slot
+    void pumpSockets();       // Move data for every open WebSocket session
+#ifndef BOARD_BW16
+    void applyTLSPolicy(const char *host); // Set the client to verified or unverified mode for host
+    bool retryInsecure();                  // After a rejected certificate, switch to unverified mode and remember the host
+    bool prepareConnection(const String &url, RequestTimer &timer); // On ESP32 open and time the TLS connection HTTPClient reuses, false when it failed
+#else
+    bool beginRequest(const char *method, const String &url, const String &payload, const char *headerKeys[], const char *headerValues[], int headerSize, RequestTimer &timer); // Connect and send a request with connection
+#endif
+    void printSuccess(const char *method, int statusCode, int contentLength, const RequestTimer &timer); // Print the [METHOD/SUCCESS] line
     char loaded_ssid[64] = {0}; // Variable to store SSID
     char loaded_pass[64] = {0}; // Variable to store password
     bool use_led = true;        // Variable to control LED usage
+    bool use_timing = false;    // Add phase timings to the SUCCESS line ([TIMING/ON])
 #ifndef BOARD_BW16
-    WiFiClientSecure client; // WiFiClientSecure object for secure connections
+    WiFiClientSecure client;     // WiFiClientSecure object for secure connections
+    bool clientInsecure = false; // client is set to skip certificate checks
+    char requestHost[128];       // Host of the request in progress
+    bool requestSecure = false;  // Request in progress uses https
 #else
     WiFiSSLClient client; // WiFiClient object for secure connections
 #endif
+    WiFiClient plainClient;    // WiFiClient object for http:// requests made with connection
+    HTTPConnection connection; // HTTP/1.1 client for [BATCH/HTTP] (and every request on BW16)
     LED led; // EasyLED object to control the LED
 
 #ifdef BOARD_VGM
     UART uart;   // UART object to handle serial communication
     UART uart_2; // UART object to handle serial communication
+    volatile bool bridgeReady = false; // Both UARTs are started and the second core may relay
 #else
     UART uart; // UART object to handle serial communication
 #endif
     WiFiUtils wifi;         // WiFiUtils object to handle WiFi connections
     StorageManager storage; // StorageManager object to handle storage operations
+#ifndef BOARD_VGM
+    Arena arena; // Per-command allocations (JSON documents), reset before each command
+#endif
+    TLSPolicy tlsPolicy;                                    // Hosts known to need an unverified connection
+    WebSocket *sockets[WEBSOCKET_MAX_SESSIONS] = {nullptr}; // Open WebSocket sessions, indexed by session ID
 };
 
 const PROGMEM char settingsFilePath[] = "/flipper-http.json"; // Path to the settings file in the SPIFFS file system
@@ -0,0 +1,85 @@
+#include "arena.h"
+
+Arena::Arena()
+    : used(0), lastOffset(0), overflowCount(0), peakUsed(0)
+{
+}
+
+void *Arena::allocate(size_t size)
+{
+    size_t aligned = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (aligned > ARENA_SIZE - used)
+    {
+        overflowCount++;
+        return malloc(size);
+    }
+    lastOffset = used;
+    used += aligned;
+    if (used > peakUsed)
+    {
+        peakUsed = used;
+    }
+    return &buffer[lastOffset];
+}
+
+void Arena::deallocate(void *pointer)
+{
+    if (pointer == nullptr)
+    {
+        return;
+    }
+    if (!owns(pointer))
+    {
+        free(pointer);
+        return;
+    }
+    // Only the most recent block can be given back, the rest goes at reset()
+    if ((uint8_t *)pointer == &buffer[lastOffset])
+    {
+        used = lastOffset;
+    }
+}
+
+bool Arena::owns(const void *pointer) const
+{
+    return (const uint8_t *)pointer >= buffer && (const uint8_t *)pointer < buffer + ARENA_SIZE;
+}
+
+void *Arena::reallocate(void *pointer, size_t size)
+{
+    if (pointer == nullptr)
+    {
+        return allocate(size);
+    }
+    if (!owns(pointer))
+    {
+        return realloc(pointer, size);
+    }
+
+    size_t offset = (uint8_t *)pointer - buffer;
+    size_t aligned = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (offset == lastOffset && aligned <= ARENA_SIZE - offset)
+    {
+        used = offset + aligned;
+        if (used > peakUsed)
+        {
+            peakUsed = used;
+        }
+        return pointer;
+    }
+
+    // Not the last block: the old size is unknown, but it cannot extend past used
+    size_t available = used - offset;
+    void *moved = allocate(size);
+    if (moved != nullptr)
+    {
+        memcpy(moved, pointer, size < available ? size : available);
+    }
+    return moved;
+}
+
+void Arena::reset()
+{
+    used = 0;
+    lastOffset = 0;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#define ARENA_SIZE 16384 // Bytes reserved for per-command allocations
+#define ARENA_ALIGN 8    // Alignment of every allocation
+
+// Bump allocator for everything a single command needs. It is reset before
+// each command, so transient JSON documents never fragment the heap.
+// Requests that do not fit fall back to malloc.
+class Arena : public ArduinoJson::Allocator
+{
+public:
+    Arena();
+    void *allocate(size_t size) override;                  // Reserve size bytes from the arena (or the heap when full)
+    void deallocate(void *pointer) override;               // Release the last block, or free a heap fallback
+    void *reallocate(void *pointer, size_t size) override; // Grow or shrink a block, in place when it is the last one
+    size_t overflows() const { return overflowCount; }     // Number of allocations that fell back to the heap
+    size_t peak() const { return peakUsed; }               // Highest number of bytes in use since boot
+    void reset();                                          // Release everything allocated since the last reset
+
+private:
+    bool owns(const void *pointer) const; // Check if a pointer is inside the arena
+    alignas(ARENA_ALIGN) uint8_t buffer[ARENA_SIZE]; // Storage for the allocations
+    size_t used;                                     // Bytes handed out since the last reset
+    size_t lastOffset;                               // Offset of the most recent block
+    size_t overflowCount;                            // Allocations that did not fit
+    size_t peakUsed;                                 // Highest value of used
+};
@@ -18,4 +18,11 @@ void setup()
 void loop()
 {
   fhttp.loop();
-}
\ No newline at end of file
+}
+
+#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
+void loop1()
+{
+  fhttp.loop1();
+}
+#endif
@@ -0,0 +1,361 @@
+#include "http_connection.h"
+
+HTTPConnection::HTTPConnection()
+    : transport(nullptr), port(0), rxStart(0), rxEnd(0), txLength(0), length(-1), remaining(0), chunked(false),
+      bodyDone(true), serverKeepAlive(false), timeout(HTTP_CONNECTION_TIMEOUT)
+{
+    host[0] = '\0';
+}
+
+bool HTTPConnection::connect(Client *transport, const char *host, uint16_t port)
+{
+    this->stop();
+    if (strlen(host) >= sizeof(this->host))
+    {
+        return false;
+    }
+    strcpy(this->host, host);
+    this->port = port;
+    this->transport = transport;
+    return transport->connect(host, port) == 1;
+}
+
+bool HTTPConnection::connected()
+{
+    return this->transport != nullptr && (this->transport->connected() || this->rxStart < this->rxEnd);
+}
+
+int HTTPConnection::fill()
+{
+    unsigned long start = millis();
+    while (true)
+    {
+        int n = this->transport->read(this->rxBuffer, sizeof(this->rxBuffer));
+        if (n > 0)
+        {
+            this->rxStart = 0;
+            this->rxEnd = n;
+            return n;
+        }
+        if (!this->transport->connected() && this->transport->available() == 0)
+        {
+            return -1; // closed by the server
+        }
+        if (millis() - start > this->timeout)
+        {
+            return -1;
+        }
+        delay(1);
+    }
+}
+
+bool HTTPConnection::parseURL(const char *url, bool *secure, char *host, size_t hostSize, uint16_t *port, const char **path)
+{
+    *secure = true;
+    if (strncmp(url, "https://", 8) == 0)
+    {
+        url += 8;
+    }
+    else if (strncmp(url, "http://", 7) == 0)
+    {
+        url += 7;
+        *secure = false;
+    }
+    size_t hostLength = strcspn(url, ":/?");
+    if (hostLength == 0 || hostLength >= hostSize)
+    {
+        return false;
+    }
+    memcpy(host, url, hostLength);
+    host[hostLength] = '\0';
+    url += hostLength;
+
+    *port = *secure ? 443 : 80;
+    if (*url == ':')
+    {
+        *port = atoi(url + 1);
+        url += strspn(url + 1, "0123456789") + 1;
+    }
+    *path = url; // may be empty or start with '?', sendRequest adds the leading slash
+    return true;
+}
+
+int HTTPConnection::read(uint8_t *buffer, size_t size)
+{
+    if (this->bodyDone)
+    {
+        return 0;
+    }
+    char line[32];
+    if (this->chunked && this->remaining == 0)
+    {
+        // Chunk size in hex, extensions after ';' are ignored
+        if (!this->readLine(line, sizeof(line)))
+        {
+            return -1;
+        }
+        this->remaining = strtol(line, nullptr, 16);
+        if (this->remaining <= 0)
+        {
+            // Last chunk: skip the trailer headers up to the blank line
+            do
+            {
+                if (!this->readLine(line, sizeof(line)))
+                {
+                    return -1;
+                }
+            } while (line[0] != '\0');
+            this->bodyDone = true;
+            return 0;
+        }
+    }
+
+    if (this->rxStart == this->rxEnd && this->fill() < 0)
+    {
+        if (this->remaining < 0)
+        {
+            // No length given: the body ends when the server closes the connection
+            this->bodyDone = true;
+            return 0;
+        }
+        return -1;
+    }
+    size_t n = this->rxEnd - this->rxStart;
+    if (n > size)
+    {
+        n = size;
+    }
+    if (this->remaining >= 0 && n > (size_t)this->remaining)
+    {
+        n = this->remaining;
+    }
+    memcpy(buffer, &this->rxBuffer[this->rxStart], n);
+    this->rxStart += n;
+
+    if (this->remaining > 0)
+    {
+        this->remaining -= n;
+        if (this->remaining == 0)
+        {
+            if (!this->chunked)
+            {
+                this->bodyDone = true;
+            }
+            else if (!this->readLine(line, sizeof(line))) // CRLF after the chunk data
+            {
+                return -1;
+            }
+        }
+    }
+    return n;
+}
+
+bool HTTPConnection::readLine(char *line, size_t size)
+{
+    size_t length = 0;
+    while (true)
+    {
+        if (this->rxStart == this->rxEnd && this->fill() < 0)
+        {
+            return false;
+        }
+        char c = this->rxBuffer[this->rxStart++];
+        if (c == '\n')
+        {
+            break;
+        }
+        if (c != '\r' && length < size - 1)
+        {
+            line[length++] = c; // the rest of an over-long line is dropped
+        }
+    }
+    line[length] = '\0';
+    return true;
+}
+
+int HTTPConnection::readResponseHead()
+{
+    char line[HTTP_CONNECTION_LINE];
+    int statusCode;
+    do
+    {
+        // "HTTP/1.1 200 OK", 1xx responses (100 Continue) are followed by the real one
+        if (!this->readLine(line, sizeof(line)) || strncmp(line, "HTTP/1.", 7) != 0 || strlen(line) < 12)
+        {
+            return -1;
+        }
+        statusCode = atoi(line + 9);
+        this->serverKeepAlive = line[7] == '1'; // HTTP/1.0 closes unless it says otherwise
+        this->length = -1;
+        this->chunked = false;
+
+        while (true)
+        {
+            if (!this->readLine(line, sizeof(line)))
+            {
+                return -1;
+            }
+            if (line[0] == '\0')
+            {
+                break; // end of the headers
+            }
+            char *value = strchr(line, ':');
+            if (value == nullptr)
+            {
+                continue;
+            }
+            *value++ = '\0';
+            while (*value == ' ' || *value == '\t')
+            {
+                value++;
+            }
+            if (strcasecmp(line, "Content-Length") == 0)
+            {
+                this->length = atol(value);
+            }
+            else if (strcasecmp(line, "Transfer-Encoding") == 0)
+            {
+                // chunked is always the last coding listed
+                size_t valueLength = strlen(value);
+                this->chunked = valueLength >= 7 && strcasecmp(value + valueLength - 7, "chunked") == 0;
+            }
+            else if (strcasecmp(line, "Connection") == 0)
+            {
+                if (strcasecmp(value, "close") == 0)
+                {
+                    this->serverKeepAlive = false;
+                }
+                else if (strcasecmp(value, "keep-alive") == 0)
+                {
+                    this->serverKeepAlive = true;
+                }
+            }
+        }
+    } while (statusCode >= 100 && statusCode < 200);
+
+    if (statusCode == 204 || statusCode == 304)
+    {
+        this->remaining = 0;
+        this->bodyDone = true;
+    }
+    else if (this->chunked)
+    {
+        this->length = -1; // Content-Length is ignored with chunked encoding
+        this->remaining = 0;
+        this->bodyDone = false;
+    }
+    else if (this->length >= 0)
+    {
+        this->remaining = this->length;
+        this->bodyDone = this->length == 0;
+    }
+    else
+    {
+        this->remaining = -1;
+        this->bodyDone = false;
+        this->serverKeepAlive = false; // the body only ends when the connection does
+    }
+    return statusCode;
+}
+
+bool HTTPConnection::send()
+{
+    if (this->txLength == 0)
+    {
+        return true;
+    }
+    size_t sent = this->transport->write((const uint8_t *)this->txBuffer, this->txLength);
+    bool ok = sent == this->txLength;
+    this->txLength = 0;
+    return ok;
+}
+
+bool HTTPConnection::put(const char *data, size_t size)
+{
+    while (size > 0)
+    {
+        if (this->txLength == sizeof(this->txBuffer) && !this->send())
+        {
+            return false;
+        }
+        size_t n = sizeof(this->txBuffer) - this->txLength;
+        if (n > size)
+        {
+            n = size;
+        }
+        memcpy(&this->txBuffer[this->txLength], data, n);
+        this->txLength += n;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool HTTPConnection::put(const char *text)
+{
+    return this->put(text, strlen(text));
+}
+
+bool HTTPConnection::sendRequest(const char *method, const char *path, const char *headerKeys[], const char *headerValues[], int headerSize, const char *payload, size_t payloadLength, bool keepOpen)
+{
+    if (this->transport == nullptr)
+    {
+        return false;
+    }
+    // The whole head is written at once, so it goes out in as few packets (TLS records) as possible
+    char number[12];
+    bool ok = this->put(method) && this->put(" ");
+    if (*path != '/')
+    {
+        ok = ok && this->put("/");
+    }
+    ok = ok && this->put(path) && this->put(" HTTP/1.1\r\nHost: ") && this->put(this->host);
+    if (this->port != 80 && this->port != 443)
+    {
+        snprintf(number, sizeof(number), ":%u", (unsigned)this->port);
+        ok = ok && this->put(number);
+    }
+    ok = ok && this->put("\r\n");
+
+    bool hasContentType = false;
+    for (int i = 0; i < headerSize && ok; i++)
+    {
+        if (headerKeys[i] == nullptr || headerValues[i] == nullptr)
+        {
+            continue; // a header without a key or value is left out
+        }
+        hasContentType = hasContentType || strcasecmp(headerKeys[i], "Content-Type") == 0;
+        ok = this->put(headerKeys[i]) && this->put(": ") && this->put(headerValues[i]) && this->put("\r\n");
+    }
+    if (ok && payloadLength > 0)
+    {
+        if (!hasContentType)
+        {
+            ok = this->put("Content-Type: application/json\r\n");
+        }
+        snprintf(number, sizeof(number), "%u", (unsigned)payloadLength);
+        ok = ok && this->put("Content-Length: ") && this->put(number) && this->put("\r\n");
+    }
+    ok = ok && this->put("Accept-Encoding: identity\r\n");
+    ok = ok && this->put(keepOpen ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n");
+    if (!ok)
+    {
+        this->txLength = 0; // nothing more of a request that could not be written
+        return false;
+    }
+    return this->put(payload, payloadLength) && this->send();
+}
+
+void HTTPConnection::stop()
+{
+    if (this->transport != nullptr)
+    {
+        this->transport->stop();
+        this->transport = nullptr;
+    }
+    this->rxStart = 0;
+    this->rxEnd = 0;
+    this->txLength = 0;
+    this->bodyDone = true;
+    this->timeout = HTTP_CONNECTION_TIMEOUT;
+}
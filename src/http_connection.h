@@ -0,0 +1,49 @@
+#pragma once
+#include <Arduino.h>
+#include <Client.h>
+#include "boards.h"
+
+#define HTTP_CONNECTION_BUFFER 512   // Bytes buffered in each direction
+#define HTTP_CONNECTION_LINE 256     // Longest status or header line kept (longer lines are cut)
+#define HTTP_CONNECTION_HOST 128     // Maximum length of a server name
+#define HTTP_CONNECTION_TIMEOUT 5000 // Time (ms) without data from the server before giving up
+
+// Minimal HTTP/1.1 client over any Client (plain or TLS). It parses the status line
+// and the headers it needs, decodes chunked bodies and hands the body out in pieces,
+// so a response never has to fit in RAM.
+class HTTPConnection
+{
+public:
+    HTTPConnection();
+    static bool parseURL(const char *url, bool *secure, char *host, size_t hostSize, uint16_t *port, const char **path); // Split [http[s]://]host[:port][/path], https when no scheme is given
+    bool connect(Client *transport, const char *host, uint16_t port); // Open a connection to the server
+    bool connected();                                                 // Check if the connection is still open
+    long contentLength() { return length; }                           // Content-Length of the current response, -1 when not sent
+    bool keepAlive() { return serverKeepAlive; }                      // Check if the server will keep the connection open after this response
+    int read(uint8_t *buffer, size_t size);                           // Read body bytes, returns 0 at the end of the body and -1 on error
+    int readResponseHead();                                           // Read the status line and headers, returns the status code or -1
+    void setTimeout(unsigned long ms) { timeout = ms; }               // Time (ms) without data from the server before giving up, until stop()
+    bool sendRequest(const char *method, const char *path, const char *headerKeys[], const char *headerValues[], int headerSize, const char *payload, size_t payloadLength, bool keepOpen); // Write one request (keepOpen asks the server not to close afterwards)
+    void stop();                                                      // Close the connection
+
+private:
+    int fill();                                  // Wait for more bytes from the server, returns the number buffered or -1
+    bool readLine(char *line, size_t size);      // Read one CRLF terminated line (without the CRLF)
+    bool put(const char *data, size_t size);     // Add bytes to the request, sending when the buffer is full
+    bool put(const char *text);                  // Add a string to the request
+    bool send();                                 // Send what is buffered
+    Client *transport;                           // Connection to the server
+    char host[HTTP_CONNECTION_HOST];             // Server name for the Host header
+    uint16_t port;                               // Server port for the Host header
+    uint8_t rxBuffer[HTTP_CONNECTION_BUFFER];    // Bytes received but not yet handed out
+    size_t rxStart;                              // Index of the first unread byte in rxBuffer
+    size_t rxEnd;                                // Index after the last received byte in rxBuffer
+    char txBuffer[HTTP_CONNECTION_BUFFER];       // Request bytes not yet sent
+    size_t txLength;                             // Number of bytes in txBuffer
+    long length;                                 // Content-Length of the response, -1 when not sent
+    long remaining;                              // Bytes left in the body (or the current chunk), -1 until the server closes
+    bool chunked;                                // Response uses chunked transfer encoding
+    bool bodyDone;                               // Every body byte of the response has been read
+    bool serverKeepAlive;                        // Server keeps the connection open after the response
+    unsigned long timeout;                       // Time (ms) without data from the server before giving up
+};
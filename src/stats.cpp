@@ -0,0 +1,166 @@
+#include "stats.h"
+
+Stats stats;
+
+static const uint32_t bucketLimits[STATS_BUCKETS - 1] = {STATS_BUCKET_LIMITS_MS};
+static const char *const phaseNames[STATS_PHASES] = {"dns", "connect", "tls", "ttfb", "transfer"};
+
+RequestTimer::RequestTimer()
+{
+    this->start();
+}
+
+void RequestTimer::mark(StatsPhase phase)
+{
+    unsigned long now = micros();
+    this->phase[phase] += now - this->last;
+    this->last = now;
+}
+
+void RequestTimer::start()
+{
+    memset(this->phase, 0, sizeof(this->phase));
+    this->last = micros();
+}
+
+Stats::Stats()
+{
+    this->reset();
+}
+
+void Stats::addCommand(const char *line)
+{
+    // "[GET/HTTP]{...}" is counted as "GET/HTTP"
+    if (line[0] != '[')
+    {
+        return;
+    }
+    const char *name = line + 1;
+    const char *end = strchr(name, ']');
+    if (end == nullptr)
+    {
+        return;
+    }
+    size_t length = end - name;
+
+    // Session traffic ([SOCKET/<id>]...) is one command, whatever the ID
+    if (strncmp(name, "SOCKET/", 7) == 0 && isDigit(name[7]))
+    {
+        name = "SOCKET/SEND";
+        length = strlen(name);
+    }
+    if (length >= STATS_COMMAND_NAME)
+    {
+        this->commandOther++;
+        return;
+    }
+
+    for (uint8_t i = 0; i < this->commandTotal; i++)
+    {
+        if (strncmp(this->commandNames[i], name, length) == 0 && this->commandNames[i][length] == '\0')
+        {
+            this->commandCounts[i]++;
+            return;
+        }
+    }
+    if (this->commandTotal == STATS_MAX_COMMANDS)
+    {
+        this->commandOther++;
+        return;
+    }
+    memcpy(this->commandNames[this->commandTotal], name, length);
+    this->commandNames[this->commandTotal][length] = '\0';
+    this->commandCounts[this->commandTotal] = 1;
+    this->commandTotal++;
+}
+
+void Stats::addRequest(const RequestTimer &timer, bool ok)
+{
+    if (ok)
+    {
+        this->requestsOk++;
+    }
+    else
+    {
+        this->requestsFailed++;
+    }
+
+    for (int p = 0; p < STATS_PHASES; p++)
+    {
+        uint32_t us = timer.phase[p];
+        if (us == 0)
+        {
+            continue; // phase did not happen (e.g. no TLS on a plain connection)
+        }
+        this->phaseTotal[p] += us;
+        uint8_t bucket = 0;
+        while (bucket < STATS_BUCKETS - 1 && us >= bucketLimits[bucket] * 1000)
+        {
+            bucket++;
+        }
+        this->histogram[p][bucket]++;
+    }
+}
+
+void Stats::print(UART &uart, size_t freeHeap, size_t maxBlock)
+{
+    this->sampleHeap(freeHeap);
+
+    uart.printf("{\"uptime\":%lu,\"commands\":{", millis() - this->since);
+    for (uint8_t i = 0; i < this->commandTotal; i++)
+    {
+        uart.printf("%s\"%s\":%lu", i > 0 ? "," : "", this->commandNames[i], (unsigned long)this->commandCounts[i]);
+    }
+    if (this->commandOther > 0)
+    {
+        uart.printf("%s\"other\":%lu", this->commandTotal > 0 ? "," : "", (unsigned long)this->commandOther);
+    }
+
+    uart.printf("},\"requests\":{\"ok\":%lu,\"failed\":%lu},\"latency\":{\"buckets_ms\":[",
+                (unsigned long)this->requestsOk, (unsigned long)this->requestsFailed);
+    for (int b = 0; b < STATS_BUCKETS - 1; b++)
+    {
+        uart.printf("%s%lu", b > 0 ? "," : "", (unsigned long)bucketLimits[b]);
+    }
+    uart.print(F("]"));
+    for (int p = 0; p < STATS_PHASES; p++)
+    {
+        uart.printf(",\"%s\":{\"total_ms\":%lu,\"hist\":[", phaseNames[p], (unsigned long)(this->phaseTotal[p] / 1000));
+        for (int b = 0; b < STATS_BUCKETS; b++)
+        {
+            uart.printf("%s%lu", b > 0 ? "," : "", (unsigned long)this->histogram[p][b]);
+        }
+        uart.print(F("]}"));
+    }
+
+    uart.printf("},\"bytes\":{\"uart_in\":%lu,\"uart_out\":%lu,\"wifi_in\":%lu,\"wifi_out\":%lu}",
+                (unsigned long)__atomic_load_n(&this->uartIn, __ATOMIC_RELAXED), (unsigned long)__atomic_load_n(&this->uartOut, __ATOMIC_RELAXED),
+                (unsigned long)this->wifiIn, (unsigned long)this->wifiOut);
+    uart.printf(",\"heap\":{\"free\":%u,\"low\":%u,\"max_block\":%u},\"reconnects\":%lu}\r\n",
+                (unsigned)freeHeap, (unsigned)this->heapLow, (unsigned)maxBlock, (unsigned long)this->reconnects);
+}
+
+void Stats::reset()
+{
+    this->commandTotal = 0;
+    this->commandOther = 0;
+    this->requestsOk = 0;
+    this->requestsFailed = 0;
+    memset(this->histogram, 0, sizeof(this->histogram));
+    memset(this->phaseTotal, 0, sizeof(this->phaseTotal));
+    __atomic_store_n(&this->uartIn, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&this->uartOut, 0, __ATOMIC_RELAXED);
+    this->wifiIn = 0;
+    this->wifiOut = 0;
+    this->heapLow = SIZE_MAX;
+    this->reconnects = 0;
+    this->since = millis();
+}
+
+void Stats::sampleHeap(size_t freeHeap)
+{
+    if (freeHeap < this->heapLow)
+    {
+        this->heapLow = freeHeap;
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <Arduino.h>
+#include "uart.h"
+
+#define STATS_MAX_COMMANDS 24 // Distinct command names that are counted separately
+#define STATS_COMMAND_NAME 20 // Maximum length of a counted command name
+#define STATS_BUCKETS 9       // Latency histogram buckets (see STATS_BUCKET_LIMITS_MS)
+#define STATS_BUCKET_LIMITS_MS 1, 10, 50, 100, 250, 500, 1000, 2500 // Upper bound of each bucket but the last
+
+typedef enum
+{
+    STATS_DNS,      // Host name lookup (0 when the client resolves the name inside connect)
+    STATS_CONNECT,  // TCP connect (plain connections)
+    STATS_TLS,      // TCP connect and TLS handshake (secure connections)
+    STATS_TTFB,     // Sending the request until the response headers arrive
+    STATS_TRANSFER, // Receiving the response body
+    STATS_PHASES,   // Number of phases
+} StatsPhase;
+
+// Microsecond timings of the phases of one request
+class RequestTimer
+{
+public:
+    RequestTimer();
+    void mark(StatsPhase phase);  // Charge the time since the previous mark to phase
+    void start();                 // Reset all phases and start timing
+    uint32_t phase[STATS_PHASES]; // Time (us) spent in each phase
+private:
+    unsigned long last; // micros() at the previous mark
+};
+
+class Stats
+{
+public:
+    Stats();
+    void addCommand(const char *line);                                                       // Count a command by its [NAME] prefix
+    void addReconnect() { reconnects++; }                                                    // Count a WiFi reconnect
+    void addRequest(const RequestTimer &timer, bool ok);                                     // Count a request and add its phases to the histograms
+    void addUARTIn(size_t bytes) { __atomic_fetch_add(&uartIn, bytes, __ATOMIC_RELAXED); }   // Count bytes received from the Flipper (either core)
+    void addUARTOut(size_t bytes) { __atomic_fetch_add(&uartOut, bytes, __ATOMIC_RELAXED); } // Count bytes sent to the Flipper (either core)
+    void addWiFiIn(size_t bytes) { wifiIn += bytes; }                                        // Count bytes received from the network
+    void addWiFiOut(size_t bytes) { wifiOut += bytes; }                                      // Count bytes sent to the network
+    void print(UART &uart, size_t freeHeap, size_t maxBlock);                                // Print the counters as one JSON line
+    void reset();                                                                            // Clear every counter
+    void sampleHeap(size_t freeHeap);                                                        // Track the heap low-water mark
+private:
+    char commandNames[STATS_MAX_COMMANDS][STATS_COMMAND_NAME]; // Names of the counted commands
+    uint32_t commandCounts[STATS_MAX_COMMANDS];                // Count for each name
+    uint8_t commandTotal;                                      // Number of names in use
+    uint32_t commandOther;                                     // Commands that did not fit in the table
+    uint32_t requestsOk;                                       // Requests that got a response
+    uint32_t requestsFailed;                                   // Requests that did not
+    uint32_t histogram[STATS_PHASES][STATS_BUCKETS];           // Latency histogram for each phase
+    uint64_t phaseTotal[STATS_PHASES];                         // Total time (us) for each phase
+    uint32_t uartIn;                                           // Bytes received from the Flipper, updated atomically (the VGM relays on both cores)
+    uint32_t uartOut;                                          // Bytes sent to the Flipper, updated atomically
+    uint32_t wifiIn;                                           // Bytes received from the network
+    uint32_t wifiOut;                                          // Bytes sent to the network
+    size_t heapLow;                                            // Lowest free heap seen
+    uint32_t reconnects;                                       // WiFi reconnects
+    unsigned long since;                                       // millis() at the last reset
+};
+
+extern Stats stats;
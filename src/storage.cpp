@@ -51,6 +51,35 @@ bool StorageManager::deserialize(JsonDocument &doc, const char *filename)
 #endif
 }
 
+#ifndef BOARD_BW16
+bool StorageManager::exists(const char *filename)
+{
+#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
+    return LittleFS.exists(filename);
+#else
+    return SPIFFS.exists(filename);
+#endif
+}
+
+File StorageManager::openFile(const char *filename, const char *mode)
+{
+#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
+    return LittleFS.open(filename, mode);
+#else
+    return SPIFFS.open(filename, mode);
+#endif
+}
+
+bool StorageManager::remove(const char *filename)
+{
+#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
+    return LittleFS.remove(filename);
+#else
+    return SPIFFS.remove(filename);
+#endif
+}
+#endif
+
 size_t StorageManager::freeHeap()
 {
 #if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
@@ -62,6 +91,34 @@ size_t StorageManager::freeHeap()
 #endif
 }
 
+size_t StorageManager::maxFreeBlock()
+{
+#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
+    // No allocator query on RP2040: binary search for the largest malloc that succeeds
+    size_t low = 0;
+    size_t high = rp2040.getFreeHeap();
+    while (low < high)
+    {
+        size_t mid = low + (high - low + 1) / 2;
+        void *probe = malloc(mid);
+        if (probe != nullptr)
+        {
+            free(probe);
+            low = mid;
+        }
+        else
+        {
+            high = mid - 1;
+        }
+    }
+    return low;
+#elif defined(BOARD_BW16)
+    return os_get_free_heap_size_arduino(); // not exposed by the SDK, report the total instead
+#else
+    return ESP.getMaxAllocHeap();
+#endif
+}
+
 String StorageManager::read(const char *filename)
 {
     String fileContent = "";
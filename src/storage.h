@@ -14,7 +14,13 @@ class StorageManager
 public:
     bool begin();
     bool deserialize(JsonDocument &doc, const char *filename);
+#ifndef BOARD_BW16
+    bool exists(const char *filename);                     // Check if a file exists
+    File openFile(const char *filename, const char *mode); // Open a file for streaming reads ("r") or writes ("w")
+    bool remove(const char *filename);                     // Delete a file
+#endif
     size_t freeHeap();
+    size_t maxFreeBlock(); // Largest single block that can be allocated (fragmentation check)
     String read(const char *filename);
     bool serialize(JsonDocument &doc, const char *filename);
     bool write(const char *filename, const char *data);
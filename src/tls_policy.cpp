@@ -0,0 +1,54 @@
+#include "tls_policy.h"
+
+TLSPolicy::TLSPolicy()
+    : next(0)
+{
+    memset(hosts, 0, sizeof(hosts));
+}
+
+#ifndef BOARD_BW16
+bool TLSPolicy::handshakeFailed(WiFiClientSecure &client, const char *host)
+{
+#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
+    // BearSSL keeps its own error, which stays 0 when the TCP connect itself failed;
+    // only its X.509 errors (BR_ERR_X509_OK + 1 to + 31) mean the certificate was rejected
+    (void)host;
+    int error = client.getLastSSLError();
+    return error > BR_ERR_X509_OK && error < BR_ERR_X509_OK + 32;
+#else
+    // Only a failed certificate check is worth retrying without one: other mbedTLS errors
+    // (protocol, memory) and TCP failures (-1) would fail the same way unverified
+    char error[8];
+    if (client.lastError(error, sizeof(error)) != MBEDTLS_ERR_X509_CERT_VERIFY_FAILED)
+    {
+        return false;
+    }
+    // A failed name lookup returns before the handshake and leaves the error of an
+    // earlier connect in place, so make sure this connect got that far
+    IPAddress ip;
+    return WiFi.hostByName(host, ip) == 1;
+#endif
+}
+#endif
+
+bool TLSPolicy::isInsecure(const char *host)
+{
+    for (int i = 0; i < TLS_POLICY_HOSTS; i++)
+    {
+        if (hosts[i][0] != '\0' && strcasecmp(hosts[i], host) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TLSPolicy::markInsecure(const char *host)
+{
+    if (strlen(host) >= TLS_POLICY_HOST_SIZE || isInsecure(host))
+    {
+        return;
+    }
+    strcpy(hosts[next], host);
+    next = (next + 1) % TLS_POLICY_HOSTS;
+}
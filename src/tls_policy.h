@@ -0,0 +1,23 @@
+#pragma once
+#include <Arduino.h>
+#include "boards.h"
+#include "wifi_utils.h"
+
+#define TLS_POLICY_HOSTS 8      // Hosts remembered as needing an unverified connection
+#define TLS_POLICY_HOST_SIZE 64 // Maximum length of a remembered host name
+
+// Remembers which hosts failed certificate verification, so later connections
+// go straight to insecure mode instead of failing and retrying every time
+class TLSPolicy
+{
+public:
+    TLSPolicy();
+    bool isInsecure(const char *host);   // Check if host is known to need an unverified connection
+    void markInsecure(const char *host); // Remember that host needs an unverified connection
+#ifndef BOARD_BW16
+    static bool handshakeFailed(WiFiClientSecure &client, const char *host); // Check if the last connect to host failed certificate verification
+#endif
+private:
+    char hosts[TLS_POLICY_HOSTS][TLS_POLICY_HOST_SIZE]; // Remembered hosts (empty string for a free slot)
+    uint8_t next;                                       // Slot replaced when the table is full
+};
@@ -1,4 +1,5 @@
 #include "uart.h"
+#include "stats.h"
 
 size_t UART::available()
 {
@@ -11,17 +12,20 @@ size_t UART::available()
 #endif
 }
 
-void UART::begin(uint32_t baudrate)
+void UART::begin(uint32_t baudrate, size_t fifoSize)
 {
 #if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W)
-    this->serial = new SerialPIO(0, 1);
+    this->serial = new SerialPIO(0, 1, fifoSize);
     this->serial->begin(baudrate);
 #elif defined(BOARD_VGM)
-    this->serial = new SerialPIO(this->tx_pin, this->rx_pin);
+    this->serial = new SerialPIO(this->tx_pin, this->rx_pin, fifoSize);
     this->serial->begin(baudrate);
 #elif defined(BOARD_BW16)
+    (void)fifoSize;
     Serial1.begin(baudrate);
 #else
+    (void)fifoSize;
+    Serial.setTxBufferSize(UART_TX_BUFFER); // writes return once queued, the driver ISR sends them
     Serial.begin(baudrate);
 #endif
 }
@@ -34,9 +38,35 @@ void UART::clearBuffer()
     }
 }
 
+#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W)
+void UART::drainTx()
+{
+    if (this->serial == nullptr)
+    {
+        return;
+    }
+    size_t head = this->txHead;
+    __sync_synchronize(); // see the bytes before the index that published them
+    while (this->txTail != head)
+    {
+        size_t tail = this->txTail;
+        size_t end = head > tail ? head : UART_TX_BUFFER;
+        this->serial->write(&this->txBuffer[tail], end - tail);
+        __sync_synchronize();
+        this->txTail = end % UART_TX_BUFFER;
+    }
+}
+#endif
+
 void UART::flush()
 {
-#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
+#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W)
+    while (this->txTail != this->txHead)
+    {
+        // wait for the second core to empty the ring buffer
+    }
+    this->serial->flush();
+#elif defined(BOARD_VGM)
     this->serial->flush();
 #elif defined(BOARD_BW16)
     Serial1.flush();
@@ -45,44 +75,68 @@ void UART::flush()
 #endif
 }
 
-void UART::print(String str)
+// Every print and println goes through write(), so nothing is copied into a String first
+void UART::print(const char *str)
 {
-#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
-    this->serial->print(str);
-#elif defined(BOARD_BW16)
-    Serial1.print(str);
-#else
-    Serial.print(str);
-#endif
+    this->write((const uint8_t *)str, strlen(str));
+}
+
+void UART::print(const char *str, size_t length)
+{
+    this->write((const uint8_t *)str, length);
+}
+
+void UART::print(const __FlashStringHelper *str)
+{
+    // flash is memory mapped on every supported board
+    this->print(reinterpret_cast<const char *>(str));
+}
+
+void UART::print(const String &str)
+{
+    this->write((const uint8_t *)str.c_str(), str.length());
 }
 
 void UART::printf(const char *format, ...)
 {
     va_list args;
     va_start(args, format);
-#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
-    this->serial->printf(format, args);
-#elif defined(BOARD_BW16)
-    // not supported yet
-#else
-    Serial.printf(format, args);
-#endif
+    this->vprintf(format, args);
     va_end(args);
 }
 
-void UART::println(String str)
+void UART::println()
 {
-#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
-    this->serial->println(str);
-#elif defined(BOARD_BW16)
-    Serial1.println(str);
-#else
-    Serial.println(str);
-#endif
+    this->write((const uint8_t *)"\r\n", 2);
+}
+
+void UART::println(const char *str)
+{
+    this->print(str);
+    this->println();
+}
+
+void UART::println(const char *str, size_t length)
+{
+    this->print(str, length);
+    this->println();
+}
+
+void UART::println(const __FlashStringHelper *str)
+{
+    this->print(str);
+    this->println();
+}
+
+void UART::println(const String &str)
+{
+    this->print(str);
+    this->println();
 }
 
 uint8_t UART::read()
 {
+    stats.addUARTIn(1);
 #if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
     return this->serial->read();
 #elif defined(BOARD_BW16)
@@ -92,15 +146,85 @@ uint8_t UART::read()
 #endif
 }
 
-uint8_t UART::readBytes(uint8_t *buffer, size_t size)
+size_t UART::readBytes(uint8_t *buffer, size_t size)
 {
 #if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
-    return this->serial->readBytes(buffer, size);
+    size_t n = this->serial->readBytes(buffer, size);
 #elif defined(BOARD_BW16)
-    return Serial1.readBytes(buffer, size);
+    size_t n = Serial1.readBytes(buffer, size);
 #else
-    return Serial.readBytes(buffer, size);
+    size_t n = Serial.readBytes(buffer, size);
 #endif
+    stats.addUARTIn(n);
+    return n;
+}
+
+size_t UART::relayTo(UART &out)
+{
+    size_t n = this->available();
+    if (n == 0)
+    {
+        return 0;
+    }
+    uint8_t buffer[UART_RELAY_CHUNK];
+    n = this->readBytes(buffer, n < sizeof(buffer) ? n : sizeof(buffer));
+    out.write(buffer, n);
+    return n;
+}
+
+#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W)
+void UART::queueTx(const uint8_t *buffer, size_t size)
+{
+    while (size > 0)
+    {
+        size_t head = this->txHead;
+        size_t tail = this->txTail;
+        size_t space = (tail + UART_TX_BUFFER - head - 1) % UART_TX_BUFFER;
+        if (space == 0)
+        {
+            continue; // full, the second core is sending
+        }
+        size_t n = size < space ? size : space;
+        if (n > UART_TX_BUFFER - head)
+        {
+            n = UART_TX_BUFFER - head; // copy up to the end of the buffer, the rest goes on the next pass
+        }
+        memcpy(&this->txBuffer[head], buffer, n);
+        __sync_synchronize(); // publish the bytes before the index
+        this->txHead = (head + n) % UART_TX_BUFFER;
+        buffer += n;
+        size -= n;
+    }
+}
+#endif
+
+void UART::vprintf(const char *format, va_list args)
+{
+    char buffer[UART_PRINTF_BUFFER];
+    va_list copy;
+    va_copy(copy, args);
+    int length = vsnprintf(buffer, sizeof(buffer), format, copy);
+    va_end(copy);
+    if (length <= 0)
+    {
+        return;
+    }
+    if ((size_t)length < sizeof(buffer))
+    {
+        this->write((const uint8_t *)buffer, length);
+        return;
+    }
+
+    // Rare: longer than the stack buffer, format again into a temporary block
+    char *large = (char *)malloc(length + 1);
+    if (large == nullptr)
+    {
+        this->write((const uint8_t *)buffer, sizeof(buffer) - 1);
+        return;
+    }
+    vsnprintf(large, length + 1, format, args);
+    this->write((const uint8_t *)large, length);
+    free(large);
 }
 
 String UART::readStringUntilString(const String &terminator, uint32_t timeout)
@@ -130,6 +254,75 @@ String UART::readStringUntilString(const String &terminator, uint32_t timeout)
     return receivedData;
 }
 
+size_t UART::readUntilStringTo(const String &terminator, Print &out, uint32_t timeout)
+{
+    const char *term = terminator.c_str();
+    const size_t termLength = terminator.length();
+    uint8_t buffer[256];
+    size_t buffered = 0;
+    size_t total = 0;
+    size_t matched = 0; // number of terminator bytes held back
+    unsigned long startTime = millis();
+
+    auto emit = [&](uint8_t c)
+    {
+        buffer[buffered++] = c;
+        if (buffered == sizeof(buffer))
+        {
+            total += out.write(buffer, buffered);
+            buffered = 0;
+        }
+    };
+
+    while (matched < termLength && millis() - startTime < timeout)
+    {
+        if (this->available() == 0)
+        {
+            delay(1);
+            continue;
+        }
+        startTime = millis(); // reset the timeout on data received
+        uint8_t c = this->read();
+
+        while (true)
+        {
+            if (c == (uint8_t)term[matched])
+            {
+                matched++;
+                break;
+            }
+            if (matched == 0)
+            {
+                emit(c);
+                break;
+            }
+            // Release held-back bytes until the rest is again a prefix of the terminator
+            size_t shift = 1;
+            emit(term[0]);
+            while (shift < matched && memcmp(term + shift, term, matched - shift) != 0)
+            {
+                emit(term[shift]);
+                shift++;
+            }
+            matched -= shift;
+        }
+    }
+
+    if (matched < termLength)
+    {
+        // Timed out: the held-back bytes were data after all
+        for (size_t i = 0; i < matched; i++)
+        {
+            emit(term[i]);
+        }
+    }
+    if (buffered > 0)
+    {
+        total += out.write(buffer, buffered);
+    }
+    return total;
+}
+
 String UART::readSerialLine()
 {
     String receivedData = "";
@@ -159,6 +352,7 @@ String UART::readSerialLine()
         delay(1); // Minimal delay to allow buffer to fill
     }
 #endif
+    stats.addUARTIn(receivedData.length() + 1);
     receivedData.trim();
     return receivedData;
 }
@@ -184,7 +378,10 @@ void UART::setTimeout(uint32_t timeout)
 
 void UART::write(const uint8_t *buffer, size_t size)
 {
-#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
+    stats.addUARTOut(size);
+#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W)
+    this->queueTx(buffer, size);
+#elif defined(BOARD_VGM)
     this->serial->write(buffer, size);
 #elif defined(BOARD_BW16)
     Serial1.write(buffer, size);
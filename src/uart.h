@@ -2,6 +2,11 @@
 #include <Arduino.h>
 #include "boards.h"
 
+#define UART_FIFO_SIZE 32      // Default receive FIFO (bytes) for SerialPIO
+#define UART_RELAY_CHUNK 64    // Bytes moved per call to relayTo
+#define UART_TX_BUFFER 4096    // Transmit ring buffer (bytes), drained in the background (ESP32, Pico W, Pico 2W)
+#define UART_PRINTF_BUFFER 256 // Stack buffer for printf, longer output is formatted into a temporary block
+
 class UART
 {
 public:
@@ -9,24 +14,41 @@ public:
     {
     }
     size_t available();
-    void begin(uint32_t baudrate);
-    void flush();
+    void begin(uint32_t baudrate, size_t fifoSize = UART_FIFO_SIZE); // fifoSize sets the SerialPIO receive ring buffer (RP2040 boards only)
+    void flush(); // Wait until everything written has been sent
     void clearBuffer();
-    void print(String str);
-    void printf(const char *format, ...);
-    void println(String str = "");
+#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W)
+    void drainTx(); // Send queued bytes, called from the second core (loop1)
+#endif
+    void print(const char *str);
+    void print(const char *str, size_t length);
+    void print(const __FlashStringHelper *str);
+    void print(const String &str);
+    void printf(const char *format, ...) __attribute__((format(printf, 2, 3))); // Formatted output without heap allocation
+    void println();
+    void println(const char *str);
+    void println(const char *str, size_t length);
+    void println(const __FlashStringHelper *str);
+    void println(const String &str);
     uint8_t read();
-    uint8_t readBytes(uint8_t *buffer, size_t size);
+    size_t readBytes(uint8_t *buffer, size_t size);
     String readSerialLine();
+    size_t relayTo(UART &out); // Forward whatever has been received to out without waiting, returns the number of bytes moved
     String readStringUntilString(const String &terminator, uint32_t timeout = 5000);
+    size_t readUntilStringTo(const String &terminator, Print &out, uint32_t timeout = 5000); // Stream data to out until terminator, without buffering it in RAM
     void setTimeout(uint32_t timeout);
+    void vprintf(const char *format, va_list args);
     void write(const uint8_t *buffer, size_t size);
 #ifdef BOARD_VGM
     void set_pins(uint8_t tx_pin, uint8_t rx_pin);
 #endif
 private:
 #if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W)
+    void queueTx(const uint8_t *buffer, size_t size); // Copy bytes into txBuffer, waiting only while it is full
     SerialPIO *serial;
+    uint8_t txBuffer[UART_TX_BUFFER]; // Bytes waiting for drainTx
+    volatile size_t txHead;           // Next free slot in txBuffer (advanced by the writer)
+    volatile size_t txTail;           // Next byte to send from txBuffer (advanced by drainTx)
 #elif defined(BOARD_VGM)
     SerialPIO *serial;
     uint8_t rx_pin;
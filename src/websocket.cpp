@@ -0,0 +1,395 @@
+#include "websocket.h"
+
+WebSocket *WebSocket::uartOwner = nullptr;
+
+WebSocket::WebSocket(UART *uartClass, int sessionId)
+    : uart(uartClass), transport(nullptr), ws(nullptr), frameRemaining(0), frameBinary(false), frameFinal(true),
+      lastReceived(0), lastPing(0), queueHead(0), queueCount(0), wasIdle(true), sessionId(sessionId), reason("closed")
+{
+    host[0] = '\0';
+}
+
+WebSocket::~WebSocket()
+{
+    stop();
+}
+
+bool WebSocket::begin(const char *url, int port, const char *headerKeys[], const char *headerValues[], int headerSize, const char *rootCA, TLSPolicy *tlsPolicy)
+{
+    // Expected format: "ws://www.jblanked.com/ws/game/new/" or "wss://..."
+    bool secure = false;
+    if (strncmp(url, "ws://", 5) == 0)
+    {
+        url += 5;
+    }
+    else if (strncmp(url, "wss://", 6) == 0)
+    {
+        url += 6;
+        secure = true;
+    }
+    if (port <= 0)
+    {
+        port = secure ? 443 : 80;
+    }
+
+    // Split the server name from the path (the name must outlive the WebSocketClient)
+    const char *path = strchr(url, '/');
+    size_t hostLength = path ? (size_t)(path - url) : strlen(url);
+    if (hostLength == 0 || hostLength >= sizeof(host))
+    {
+        return false;
+    }
+    memcpy(host, url, hostLength);
+    host[hostLength] = '\0';
+    if (path == nullptr)
+    {
+        path = "/";
+    }
+
+    if (secure)
+    {
+#ifndef BOARD_BW16
+        if (tlsPolicy->isInsecure(host))
+        {
+            secureClient.setInsecure();
+        }
+        else
+        {
+            secureClient.setCACert(rootCA);
+        }
+#else
+        secureClient.setRootCA((unsigned char *)rootCA);
+#endif
+        transport = &secureClient;
+    }
+    else
+    {
+        transport = &plainClient;
+    }
+
+    ws = new WebSocketClient(*transport, host, port);
+    for (int i = 0; i < headerSize; i++)
+    {
+        ws->sendHeader(headerKeys[i], headerValues[i]);
+    }
+    ws->begin(path);
+
+#ifndef BOARD_BW16
+    if (!ws->connected() && secure && !tlsPolicy->isInsecure(host) && TLSPolicy::handshakeFailed(secureClient, host))
+    {
+        // the certificate was rejected, try again without checking it and remember the host
+        tlsPolicy->markInsecure(host);
+        delete ws;
+        secureClient.setInsecure();
+        ws = new WebSocketClient(*transport, host, port);
+        for (int i = 0; i < headerSize; i++)
+        {
+            ws->sendHeader(headerKeys[i], headerValues[i]);
+        }
+        ws->begin(path);
+    }
+#endif
+
+    lastReceived = millis();
+    lastPing = lastReceived;
+    return ws->connected();
+}
+
+const char *WebSocket::closeReason()
+{
+    return reason;
+}
+
+bool WebSocket::connected()
+{
+    return ws != nullptr && ws->connected();
+}
+
+bool WebSocket::forwardIncoming()
+{
+    if (frameRemaining == 0)
+    {
+        if (transport->available() == 0)
+        {
+            return false;
+        }
+        lastReceived = millis();
+        if (uartOwner != nullptr && uartOwner != this)
+        {
+            return false; // another session is part-way through a message, its bytes would interleave with ours
+        }
+
+        // Pings are answered inside parseMessage
+        int size = ws->parseMessage();
+        if (size <= 0)
+        {
+            return true;
+        }
+
+        int type = ws->messageType();
+        if (type == TYPE_TEXT || type == TYPE_BINARY)
+        {
+            frameBinary = type == TYPE_BINARY;
+        }
+        else if (type != TYPE_CONTINUATION)
+        {
+            // Control frame payload (pong, close reason), nothing to forward
+            uint8_t discard[16];
+            while (ws->available() > 0 && ws->read(discard, sizeof(discard)) > 0)
+            {
+            }
+            return true;
+        }
+        bool messageStart = frameFinal; // the previous frame ended a message
+        frameFinal = ws->isFinal();
+        frameRemaining = size;
+        uartOwner = this; // until the message ends
+
+        if (frameBinary)
+        {
+            if (sessionId >= 0)
+            {
+                uart->printf("[SOCKET/%d/BINARY]%u\r\n", sessionId, (unsigned)size);
+            }
+            else
+            {
+                uart->printf(WEBSOCKET_BINARY "%u\r\n", (unsigned)size);
+            }
+        }
+        else if (messageStart && sessionId >= 0)
+        {
+            uart->printf("[SOCKET/%d]", sessionId);
+        }
+    }
+
+    // Only one chunk per call so the other direction is never starved
+    uint8_t buffer[WEBSOCKET_CHUNK_SIZE];
+    int n = ws->read(buffer, frameRemaining < sizeof(buffer) ? frameRemaining : sizeof(buffer));
+    if (n <= 0)
+    {
+        return false;
+    }
+    lastReceived = millis();
+    uart->write(buffer, n); // blocks while the UART TX buffer is full, which stops us reading the socket
+    frameRemaining -= n;
+
+    if (frameRemaining == 0 && frameFinal)
+    {
+        if (!frameBinary)
+        {
+            uart->println();
+        }
+        uartOwner = nullptr;
+    }
+    return true;
+}
+
+bool WebSocket::inMessage()
+{
+    return frameRemaining > 0 || !frameFinal;
+}
+
+bool WebSocket::uartBusy()
+{
+    return uartOwner != nullptr;
+}
+
+bool WebSocket::isIdle()
+{
+    return wasIdle;
+}
+
+bool WebSocket::loop()
+{
+    if (!connected())
+    {
+        return false;
+    }
+
+    bool busy = forwardIncoming();
+
+    if (queueCount > 0)
+    {
+        sendFrame(TYPE_TEXT, true, (const uint8_t *)queue[queueHead], queueLength[queueHead]);
+        queueHead = (queueHead + 1) % WEBSOCKET_QUEUE_SLOTS;
+        queueCount--;
+        busy = true;
+    }
+
+    unsigned long now = millis();
+    if (inMessage() && now - lastReceived > WEBSOCKET_STALL_TIMEOUT)
+    {
+        // The other sessions and the commands wait for this message, do not hold them up any longer
+        reason = "stalled";
+        stop();
+        return false;
+    }
+    if (now - lastReceived > WEBSOCKET_TIMEOUT)
+    {
+        if (sessionId < 0)
+        {
+            uart->println(F("[ERROR] WebSocket timed out."));
+        }
+        reason = "timeout"; // sessions report it in [SOCKET/CLOSED]
+        stop();
+        return false;
+    }
+    if (now - lastReceived > WEBSOCKET_PING_INTERVAL && now - lastPing > WEBSOCKET_PING_INTERVAL)
+    {
+        sendFrame(TYPE_PING, true, nullptr, 0);
+        lastPing = now;
+    }
+
+    wasIdle = !busy;
+    return connected();
+}
+
+bool WebSocket::queueFull()
+{
+    return queueCount >= WEBSOCKET_QUEUE_SLOTS;
+}
+
+bool WebSocket::queueText(const char *data, size_t size)
+{
+    if (size > WEBSOCKET_QUEUE_LINE)
+    {
+        // Too long for a slot: send what is queued, then this one directly to keep the order
+        while (queueCount > 0)
+        {
+            sendFrame(TYPE_TEXT, true, (const uint8_t *)queue[queueHead], queueLength[queueHead]);
+            queueHead = (queueHead + 1) % WEBSOCKET_QUEUE_SLOTS;
+            queueCount--;
+        }
+        return sendFrame(TYPE_TEXT, true, (const uint8_t *)data, size);
+    }
+    if (queueFull())
+    {
+        return false;
+    }
+    uint8_t slot = (queueHead + queueCount) % WEBSOCKET_QUEUE_SLOTS;
+    memcpy(queue[slot], data, size);
+    queueLength[slot] = size;
+    queueCount++;
+    return true;
+}
+
+bool WebSocket::sendBinaryFromUART(size_t size)
+{
+    // Each UART chunk becomes one fragment, so the message is never held in RAM
+    uint8_t buffer[WEBSOCKET_CHUNK_SIZE];
+    uint8_t opcode = TYPE_BINARY;
+    bool ok = true;
+    do
+    {
+        size_t n = 0;
+        if (size > 0)
+        {
+            n = uart->readBytes(buffer, size < sizeof(buffer) ? size : sizeof(buffer));
+            if (n == 0)
+            {
+                // UART timed out, end the message with what was sent so far
+                ok = false;
+                size = 0;
+            }
+            else
+            {
+                size -= n;
+            }
+        }
+        if (!sendFrame(opcode, size == 0, buffer, n))
+        {
+            return false;
+        }
+        opcode = TYPE_CONTINUATION;
+        forwardIncoming();
+    } while (size > 0);
+    return ok;
+}
+
+bool WebSocket::sendFrame(uint8_t opcode, bool fin, const uint8_t *payload, size_t size)
+{
+    if (!connected())
+    {
+        return false;
+    }
+
+    // Client frames are always masked (RFC 6455 section 5.3)
+    uint8_t header[14];
+    size_t headerLength = 0;
+    header[headerLength++] = (fin ? 0x80 : 0x00) | (opcode & 0x0f);
+    if (size < 126)
+    {
+        header[headerLength++] = 0x80 | size;
+    }
+    else if (size <= 0xffff)
+    {
+        header[headerLength++] = 0x80 | 126;
+        header[headerLength++] = (size >> 8) & 0xff;
+        header[headerLength++] = size & 0xff;
+    }
+    else
+    {
+        header[headerLength++] = 0x80 | 127;
+        for (int i = 7; i >= 0; i--)
+        {
+            header[headerLength++] = ((uint64_t)size >> (8 * i)) & 0xff;
+        }
+    }
+    uint32_t key = (uint32_t)random(0x7fffffff) ^ micros();
+    uint8_t *mask = &header[headerLength];
+    memcpy(mask, &key, 4);
+    headerLength += 4;
+
+    if (transport->write(header, headerLength) != headerLength)
+    {
+        return false;
+    }
+
+    uint8_t masked[WEBSOCKET_CHUNK_SIZE];
+    for (size_t offset = 0; offset < size;)
+    {
+        size_t n = size - offset < sizeof(masked) ? size - offset : sizeof(masked);
+        for (size_t i = 0; i < n; i++)
+        {
+            masked[i] = payload[offset + i] ^ mask[(offset + i) & 3];
+        }
+        if (transport->write(masked, n) != n)
+        {
+            return false;
+        }
+        offset += n;
+    }
+    return true;
+}
+
+void WebSocket::stop()
+{
+    if (inMessage() && !frameBinary)
+    {
+        uart->println(); // end the text line that was cut short
+    }
+    else if (frameRemaining > 0)
+    {
+        // The length of the binary frame was announced, pad it so the Flipper stays in step
+        uint8_t zeros[WEBSOCKET_CHUNK_SIZE] = {0};
+        while (frameRemaining > 0)
+        {
+            size_t n = frameRemaining < sizeof(zeros) ? frameRemaining : sizeof(zeros);
+            uart->write(zeros, n);
+            frameRemaining -= n;
+        }
+    }
+    if (uartOwner == this)
+    {
+        uartOwner = nullptr;
+    }
+    if (ws != nullptr)
+    {
+        ws->stop();
+        delete ws;
+        ws = nullptr;
+    }
+    frameRemaining = 0;
+    frameFinal = true;
+    queueCount = 0;
+}
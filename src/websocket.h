@@ -0,0 +1,61 @@
+#pragma once
+#include <Arduino.h>
+#include "boards.h"
+#include "tls_policy.h"
+#include "uart.h"
+#include "wifi_utils.h"
+#include <ArduinoHttpClient.h>
+
+#define WEBSOCKET_CHUNK_SIZE 256           // Bytes moved per read/write in either direction
+#define WEBSOCKET_QUEUE_SLOTS 4            // Text messages waiting to be sent to the server
+#define WEBSOCKET_QUEUE_LINE 256           // Maximum length of a queued text message
+#define WEBSOCKET_PING_INTERVAL 15000      // Time (ms) without server traffic before sending a ping
+#define WEBSOCKET_TIMEOUT 40000            // Time (ms) without server traffic before giving up
+#define WEBSOCKET_STALL_TIMEOUT 2000       // Time (ms) a server may stall in the middle of a message before the session is closed
+#define WEBSOCKET_BINARY "[SOCKET/BINARY]" // Prefix announcing raw binary bytes in either direction
+#define WEBSOCKET_MAX_SESSIONS 4           // Sessions that can be open at once with [SOCKET/OPEN]
+
+class WebSocket
+{
+public:
+    WebSocket(UART *uartClass, int sessionId = -1); // sessionId >= 0 tags everything sent to UART with [SOCKET/<id>]
+    ~WebSocket();
+    bool begin(const char *url, int port, const char *headerKeys[], const char *headerValues[], int headerSize, const char *rootCA, TLSPolicy *tlsPolicy); // Connect and perform the handshake
+    const char *closeReason();                     // Why loop() returned false: "timeout", "stalled" or "closed"
+    bool connected();                              // Check if the connection is still open
+    bool inMessage();                              // Check if a server message is part-way through being forwarded
+    bool isIdle();                                 // Check if the last loop moved no data
+    bool loop();                                   // Move at most one chunk in each direction, returns false once the connection is gone
+    bool queueFull();                              // Check if the outgoing queue is full
+    bool queueText(const char *data, size_t size); // Queue a text message, returns false when the queue is full
+    bool sendBinaryFromUART(size_t size);          // Forward size raw bytes from UART as a fragmented binary message
+    void stop();                                   // Close the connection
+    static bool uartBusy();                        // Check if any session is part-way through forwarding a message to UART
+
+private:
+    bool forwardIncoming();                                                        // Stream at most one chunk of the current server frame to UART
+    bool sendFrame(uint8_t opcode, bool fin, const uint8_t *payload, size_t size); // Write a masked frame to the server
+    UART *uart;                                                                    // UART object for serial communication
+    WiFiClient plainClient;                                                        // Transport for ws://
+#ifndef BOARD_BW16
+    WiFiClientSecure secureClient; // Transport for wss://
+#else
+    WiFiSSLClient secureClient; // Transport for wss://
+#endif
+    Client *transport;                                       // Transport in use
+    WebSocketClient *ws;                                     // Handshake and frame parsing
+    size_t frameRemaining;                                   // Bytes of the current server frame still to forward
+    bool frameBinary;                                        // Current server message is binary
+    bool frameFinal;                                         // Current server frame ends the message
+    unsigned long lastReceived;                              // Time (ms) of the last byte from the server
+    unsigned long lastPing;                                  // Time (ms) of the last ping sent
+    char queue[WEBSOCKET_QUEUE_SLOTS][WEBSOCKET_QUEUE_LINE]; // Outgoing text messages
+    size_t queueLength[WEBSOCKET_QUEUE_SLOTS];               // Length of each queued message
+    uint8_t queueHead;                                       // Index of the oldest queued message
+    uint8_t queueCount;                                      // Number of queued messages
+    bool wasIdle;                                            // The last loop moved no data
+    int sessionId;                                           // Session ID for multiplexed output, -1 for the [SOCKET/START] bridge
+    char host[128];                                          // Server name (referenced by the WebSocketClient)
+    const char *reason;                                      // Why the connection ended, see closeReason()
+    static WebSocket *uartOwner;                             // Session forwarding a message to UART, the others wait for it
+};
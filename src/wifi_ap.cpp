@@ -5,49 +5,531 @@ static const char *DNS_HOST = "*";
 static const byte DNS_PORT = 53;
 #endif
 
-static const PROGMEM String wifiAPHeader =
-    "HTTP/1.1 200 OK\r\n"
-    "Content-type:text/html\r\n"
-    "\r\n";
+// Page served until an index page is uploaded with [WIFI/AP/UPDATE]
+static const char defaultPage[] PROGMEM =
+    "<!DOCTYPE html><html>\r\n"
+    "<head><title>FlipperHTTP</title></head>\r\n"
+    "<body><h1>Welcome to FlipperHTTP AP Mode</h1></body>\r\n"
+    "</html>";
+
+// Find a request header by name (case-insensitive), returns the start of its value or nullptr
+static const char *findHeader(const char *request, const char *name, size_t *valueLength)
+{
+    size_t nameLength = strlen(name);
+    const char *line = strstr(request, "\r\n");
+    while (line != nullptr)
+    {
+        line += 2;
+        if (line[0] == '\r' || line[0] == '\0')
+        {
+            break; // end of headers
+        }
+        const char *lineEnd = strstr(line, "\r\n");
+        if (lineEnd == nullptr)
+        {
+            break;
+        }
+        if (strncasecmp(line, name, nameLength) == 0 && line[nameLength] == ':')
+        {
+            const char *value = line + nameLength + 1;
+            while (*value == ' ')
+            {
+                value++;
+            }
+            *valueLength = lineEnd - value;
+            return value;
+        }
+        line = lineEnd;
+    }
+    return nullptr;
+}
+
+// Check if a request header contains the given token
+static bool headerContains(const char *request, const char *name, const char *token)
+{
+    size_t valueLength = 0;
+    const char *value = findHeader(request, name, &valueLength);
+    size_t tokenLength = strlen(token);
+    if (value == nullptr || valueLength < tokenLength)
+    {
+        return false;
+    }
+    for (size_t i = 0; i + tokenLength <= valueLength; i++)
+    {
+        if (strncasecmp(value + i, token, tokenLength) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
 
-WiFiAP::WiFiAP(UART *uartClass, WiFiUtils *wifiUtils)
 #ifndef BOARD_BW16
-    : uart(uartClass), wifi(wifiUtils), dnsServer(), isRunning(false)
+// Content-Type based on the file extension
+static const char *contentTypeFor(const char *path)
+{
+    const char *ext = strrchr(path, '.');
+    if (ext == nullptr)
+        return "application/octet-stream";
+    if (strcmp(ext, ".html") == 0 || strcmp(ext, ".htm") == 0)
+        return "text/html";
+    if (strcmp(ext, ".css") == 0)
+        return "text/css";
+    if (strcmp(ext, ".js") == 0)
+        return "application/javascript";
+    if (strcmp(ext, ".json") == 0)
+        return "application/json";
+    if (strcmp(ext, ".png") == 0)
+        return "image/png";
+    if (strcmp(ext, ".jpg") == 0 || strcmp(ext, ".jpeg") == 0)
+        return "image/jpeg";
+    if (strcmp(ext, ".gif") == 0)
+        return "image/gif";
+    if (strcmp(ext, ".svg") == 0)
+        return "image/svg+xml";
+    if (strcmp(ext, ".ico") == 0)
+        return "image/x-icon";
+    if (strcmp(ext, ".txt") == 0)
+        return "text/plain";
+    return "application/octet-stream";
+}
+
+// Build the flash path for a request path, rejecting anything outside WIFI_AP_ASSET_DIR
+static bool assetPath(const char *path, char *out, size_t outSize)
+{
+    if (path[0] != '/' || strstr(path, "..") != nullptr)
+    {
+        return false;
+    }
+    int len = snprintf(out, outSize, "%s%s", WIFI_AP_ASSET_DIR, path);
+    return len > 0 && (size_t)len < outSize;
+}
+#endif
+
+// Builds a UART line in a small fixed buffer, flushing as it fills
+class UARTRecord
+{
+public:
+    UARTRecord(UART *uart) : uart(uart), length(0) {}
+    void append(const char *str)
+    {
+        while (*str)
+        {
+            put(*str++);
+        }
+    }
+    void appendNumber(unsigned long value)
+    {
+        char digits[12];
+        snprintf(digits, sizeof(digits), "%lu", value);
+        append(digits);
+    }
+    // Append JSON-escaped data, optionally decoding '+' and %XX first
+    void appendEscaped(const char *data, size_t size, bool urlDecode)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            uint8_t c = data[i];
+            if (urlDecode && c == '+')
+            {
+                c = ' ';
+            }
+            else if (urlDecode && c == '%' && i + 2 < size && isxdigit((uint8_t)data[i + 1]) && isxdigit((uint8_t)data[i + 2]))
+            {
+                c = (hexValue(data[i + 1]) << 4) | hexValue(data[i + 2]);
+                i += 2;
+            }
+            if (c == '"' || c == '\\')
+            {
+                put('\\');
+                put(c);
+            }
+            else if (c < 0x20)
+            {
+                char escaped[7];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                append(escaped);
+            }
+            else
+            {
+                put(c);
+            }
+        }
+    }
+    void flush()
+    {
+        if (length > 0)
+        {
+            uart->write(buffer, length);
+            length = 0;
+        }
+    }
+
+private:
+    static uint8_t hexValue(char c)
+    {
+        return (c <= '9') ? c - '0' : (c | 0x20) - 'a' + 10;
+    }
+    void put(uint8_t c)
+    {
+        buffer[length++] = c;
+        if (length == sizeof(buffer))
+        {
+            flush();
+        }
+    }
+    UART *uart;
+    uint8_t buffer[128];
+    size_t length;
+};
+
+WiFiAP::WiFiAP(UART *uartClass, WiFiUtils *wifiUtils, StorageManager *storageManager)
+#ifndef BOARD_BW16
+    : uart(uartClass), wifi(wifiUtils), storage(storageManager), isRunning(false), clients(nullptr), dnsServer()
 #else
-    : uart(uartClass), wifi(wifiUtils), isRunning(false)
+    : uart(uartClass), wifi(wifiUtils), storage(storageManager), isRunning(false), clients(nullptr), html(defaultPage)
 #endif
 {
-    html = wifiAPHeader;
-    html += "<!DOCTYPE html><html>\r\n";
-    html += "<head><title>FlipperHTTP</title></head>\r\n";
-    html += "<body><h1>Welcome to FlipperHTTP AP Mode</h1></body>\r\n";
-    html += "</html>";
 }
 
-void WiFiAP::printInputs(const String &request)
+void WiFiAP::acceptClient(WiFiServer &server)
 {
-    auto getIdx = request.indexOf("get?");
-    if (getIdx != -1 && request.startsWith("GET"))
+#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
+    WiFiClient client = server.accept();
+#else
+    WiFiClient client = server.available();
+#endif
+    if (!client)
     {
-        int startPos = getIdx;
-        int endPos = request.indexOf("HTTP/1.1", startPos);
+        return;
+    }
 
-        if (startPos > 0 && endPos > startPos)
+    for (int i = 0; i < WIFI_AP_MAX_CLIENTS; i++)
+    {
+        APClient &c = clients[i];
+        if (c.state == AP_CLIENT_FREE)
         {
-            String path = request.substring(startPos, endPos);
-            int start = getIdx - 1;
-            int end = path.indexOf('&', start);
-            while (end != -1)
+            c.client = client;
+            c.state = AP_CLIENT_READING;
+            c.requestLength = 0;
+            c.requestEnd = 0;
+            c.request[0] = '\0';
+            c.headerLength = 0;
+            c.sent = 0;
+            c.body = nullptr;
+            c.bodyLength = 0;
+            c.keepAlive = false;
+            c.served = 0;
+            c.lastActivity = millis();
+            IPAddress ip = client.remoteIP();
+            snprintf(c.ip, sizeof(c.ip), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+            return;
+        }
+    }
+
+    // All slots are busy, tell the client to retry instead of letting it time out
+    static const char busy[] =
+        "HTTP/1.1 503 Service Unavailable\r\n"
+        "Retry-After: 1\r\n"
+        "Content-Length: 0\r\n"
+        "Connection: close\r\n"
+        "\r\n";
+    client.write((const uint8_t *)busy, sizeof(busy) - 1);
+    client.stop();
+}
+
+void WiFiAP::closeClient(APClient &c)
+{
+#ifndef BOARD_BW16
+    if (c.file)
+    {
+        c.file.close();
+    }
+#endif
+    c.client.stop();
+    c.state = AP_CLIENT_FREE;
+    c.requestLength = 0;
+}
+
+void WiFiAP::closeSending()
+{
+    for (int i = 0; i < WIFI_AP_MAX_CLIENTS; i++)
+    {
+        if (clients[i].state == AP_CLIENT_SENDING)
+        {
+            closeClient(clients[i]);
+        }
+    }
+}
+
+#ifndef BOARD_BW16
+bool WiFiAP::deleteAsset(const String &jsonData)
+{
+    JsonDocument doc;
+    if (deserializeJson(doc, jsonData) || !doc["path"])
+    {
+        uart->println(F("[ERROR] JSON does not contain path."));
+        return false;
+    }
+    char filename[WIFI_AP_PATH_SIZE];
+    if (!assetPath(doc["path"].as<const char *>(), filename, sizeof(filename)))
+    {
+        uart->println(F("[ERROR] Invalid asset path."));
+        return false;
+    }
+    closeSending();
+    if (!storage->remove(filename))
+    {
+        uart->println(F("[ERROR] Failed to delete asset."));
+        return false;
+    }
+    uart->println(F("[INFO] Asset deleted."));
+    return true;
+}
+#endif
+
+bool WiFiAP::handleCommand()
+{
+    String cmd = uart->readSerialLine();
+    if (cmd.startsWith("[WIFI/AP/STOP]"))
+    {
+        uart->println(F("[INFO] Stopping AP mode."));
+        uart->flush();
+        return false;
+    }
+    else if (cmd.startsWith("[WIFI/AP/UPDATE]"))
+    {
+        // Connections part-way through a response still reference the old page
+        closeSending();
+        updateHTML();
+    }
+#ifndef BOARD_BW16
+    else if (cmd.startsWith("[WIFI/AP/UPLOAD]"))
+    {
+        closeSending();
+        uploadAsset(cmd.substring(strlen("[WIFI/AP/UPLOAD]")));
+    }
+    else if (cmd.startsWith("[WIFI/AP/DELETE]"))
+    {
+        deleteAsset(cmd.substring(strlen("[WIFI/AP/DELETE]")));
+    }
+#endif
+    return true;
+}
+
+void WiFiAP::handleRequest(APClient &c)
+{
+    if (c.served == 0)
+    {
+        uart->println(F("[INFO] Client Connected."));
+    }
+    // Request line: METHOD SP target SP version
+    bool isHead = strncmp(c.request, "HEAD ", 5) == 0;
+    size_t methodLength = strcspn(c.request, " \r\n");
+    const char *target = c.request + methodLength;
+    target += (*target == ' ') ? 1 : 0;
+    size_t pathLength = strcspn(target, "? \r\n");
+    char path[WIFI_AP_PATH_SIZE] = "/";
+    if (pathLength > 0 && pathLength < sizeof(path))
+    {
+        memcpy(path, target, pathLength);
+        path[pathLength] = '\0';
+    }
+
+    // Form fields come from the query string, or from the body of a urlencoded POST
+    if (target[pathLength] == '?')
+    {
+        const char *query = target + pathLength + 1;
+        printInputs(c, c.request, methodLength, target, pathLength, query, strcspn(query, " \r\n"));
+    }
+    else if (strncmp(c.request, "POST ", 5) == 0 && headerContains(c.request, "Content-Type", "application/x-www-form-urlencoded"))
+    {
+        const char *body = strstr(c.request, "\r\n\r\n") + 4;
+        printInputs(c, c.request, methodLength, target, pathLength, body, c.requestEnd - (body - c.request));
+    }
+
+    // HTTP/1.1 defaults to keep-alive, HTTP/1.0 and "Connection: close" do not
+    const char *lineEnd = strstr(c.request, "\r\n");
+    bool http11 = lineEnd != nullptr && lineEnd - c.request >= 8 && strncmp(lineEnd - 8, "HTTP/1.1", 8) == 0;
+    bool wantsClose = headerContains(c.request, "Connection", "close");
+
+    c.served++;
+    c.keepAlive = http11 && !wantsClose && c.served < WIFI_AP_KEEPALIVE_MAX;
+
+    const char *contentType = "text/html";
+    const char *encoding = "";
+    const char *status = "200 OK";
+    bool notModified = false;
+    char etag[32] = {0};
+    c.body = nullptr;
+    c.bodyLength = 0;
+
+#ifndef BOARD_BW16
+    bool gzipped = false;
+    if (openAsset(c, path, headerContains(c.request, "Accept-Encoding", "gzip"), &contentType, &gzipped))
+    {
+        c.bodyLength = c.file.size();
+        snprintf(etag, sizeof(etag), "\"%x-%lx%s\"", (unsigned)c.bodyLength, (unsigned long)c.file.getLastWrite(), gzipped ? "-gz" : "");
+        encoding = gzipped ? "Content-Encoding: gzip\r\n" : "";
+
+        size_t matchLength = 0;
+        const char *ifNoneMatch = findHeader(c.request, "If-None-Match", &matchLength);
+        if (ifNoneMatch != nullptr && matchLength == strlen(etag) && strncmp(ifNoneMatch, etag, matchLength) == 0)
+        {
+            status = "304 Not Modified";
+            notModified = true;
+            c.file.close();
+            c.bodyLength = 0;
+            isHead = true; // no body
+        }
+    }
+    else
+    {
+        c.body = (const uint8_t *)defaultPage;
+        c.bodyLength = sizeof(defaultPage) - 1;
+    }
+#else
+    c.body = (const uint8_t *)html.c_str();
+    c.bodyLength = html.length();
+#endif
+
+    // A 304 has no body to describe, a client would otherwise take Content-Length: 0 for the cached page
+    char content[96] = {0};
+    if (!notModified)
+    {
+        snprintf(content, sizeof(content), "Content-Type: %s\r\nContent-Length: %u\r\n", contentType, (unsigned)c.bodyLength);
+    }
+    int len = snprintf(c.header, sizeof(c.header),
+                       "HTTP/1.1 %s\r\n"
+                       "%s"
+                       "%s"
+                       "%s%s%s"
+                       "Cache-Control: no-cache\r\n"
+                       "Connection: %s\r\n"
+                       "\r\n",
+                       status,
+                       content,
+                       encoding,
+                       etag[0] ? "ETag: " : "", etag, etag[0] ? "\r\n" : "",
+                       c.keepAlive ? "keep-alive" : "close");
+    c.headerLength = (len > 0 && (size_t)len < sizeof(c.header)) ? (size_t)len : 0;
+    if (isHead)
+    {
+        // Content-Length describes the body we are not sending
+#ifndef BOARD_BW16
+        if (c.file)
+        {
+            c.file.close();
+        }
+#endif
+        c.body = nullptr;
+        c.bodyLength = 0;
+    }
+    c.sent = 0;
+    c.state = AP_CLIENT_SENDING;
+    c.lastActivity = millis();
+}
+
+#ifndef BOARD_BW16
+bool WiFiAP::openAsset(APClient &c, const char *path, bool acceptsGzip, const char **contentType, bool *gzipped)
+{
+    char filename[WIFI_AP_PATH_SIZE + 3];
+    const char *candidates[2] = {strcmp(path, "/") == 0 ? "/index.html" : path, "/index.html"};
+
+    // Unknown paths fall back to the index page so captive portal probes land on it
+    for (int i = 0; i < 2; i++)
+    {
+        if (!assetPath(candidates[i], filename, WIFI_AP_PATH_SIZE))
+        {
+            continue;
+        }
+        size_t length = strlen(filename);
+        if (acceptsGzip)
+        {
+            strcpy(&filename[length], ".gz");
+            if (storage->exists(filename))
             {
-                String part = path.substring(start, end);
-                uart->println(part);
-                start = end + 1;
-                end = path.indexOf('&', start);
+                c.file = storage->openFile(filename, "r");
+                if (c.file)
+                {
+                    *contentType = contentTypeFor(candidates[i]);
+                    *gzipped = true;
+                    return true;
+                }
             }
-            String part = path.substring(start, end);
-            uart->println(part);
+            filename[length] = '\0';
         }
+        if (storage->exists(filename))
+        {
+            c.file = storage->openFile(filename, "r");
+            if (c.file)
+            {
+                *contentType = contentTypeFor(candidates[i]);
+                *gzipped = false;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+#endif
+
+void WiFiAP::printInputs(const APClient &c, const char *method, size_t methodLength, const char *path, size_t pathLength, const char *data, size_t dataLength)
+{
+    if (dataLength == 0)
+    {
+        return;
+    }
+
+    // [AP/INPUT]{"uptime":<ms>,"ip":"<ip>","method":"GET","path":"/get","fields":{"key":"value",...}}
+    UARTRecord record(uart);
+    record.append("[AP/INPUT]{\"uptime\":");
+    record.appendNumber(millis());
+#ifndef BOARD_BW16
+    time_t now = time(nullptr);
+    if (now > 1600000000) // only once the clock has been set
+    {
+        record.append(",\"time\":");
+        record.appendNumber((unsigned long)now);
+    }
+#endif
+    record.append(",\"ip\":\"");
+    record.append(c.ip);
+    record.append("\",\"method\":\"");
+    record.appendEscaped(method, methodLength, false);
+    record.append("\",\"path\":\"");
+    record.appendEscaped(path, pathLength, true);
+    record.append("\",\"fields\":{");
+
+    // Walk key=value pairs in place, decoding straight into the record
+    const char *end = data + dataLength;
+    const char *pair = data;
+    bool first = true;
+    while (pair < end)
+    {
+        const char *pairEnd = (const char *)memchr(pair, '&', end - pair);
+        if (pairEnd == nullptr)
+        {
+            pairEnd = end;
+        }
+        if (pairEnd > pair)
+        {
+            const char *equals = (const char *)memchr(pair, '=', pairEnd - pair);
+            const char *keyEnd = equals ? equals : pairEnd;
+            record.append(first ? "\"" : ",\"");
+            record.appendEscaped(pair, keyEnd - pair, true);
+            record.append("\":\"");
+            if (equals)
+            {
+                record.appendEscaped(equals + 1, pairEnd - equals - 1, true);
+            }
+            record.append("\"");
+            first = false;
+        }
+        pair = pairEnd + 1;
     }
+    record.append("}}\r\n");
+    record.flush();
 }
 
 bool WiFiAP::start(const char *ssid)
@@ -66,18 +548,30 @@ bool WiFiAP::start(const char *ssid)
 
 #ifndef BOARD_BW16
     dnsServer.start(DNS_PORT, DNS_HOST, apIP);
+
+    // [WIFI/AP/UPDATE] pages last for one AP session, like the in-memory page did; uploaded assets stay
+    char filename[WIFI_AP_PATH_SIZE + 3];
+    if (assetPath("/index.html", filename, WIFI_AP_PATH_SIZE))
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            if (storage->exists(filename))
+            {
+                storage->remove(filename);
+            }
+            strcat(filename, ".gz"); // then the pre-compressed copy
+        }
+    }
 #endif
 
-    char buffer[64];
-    snprintf(buffer, sizeof(buffer), "[SUCCESS]{\"IP\":\"%s\"}", ipStr.c_str());
-    uart->println(buffer);
+    uart->printf("[SUCCESS]{\"IP\":\"%s\"}\r\n", ipStr.c_str());
     uart->flush();
 
     isRunning = true;
     return true;
 }
 
-void WiFiAP::run()
+void WiFiAP::run(bool (*pump)(void *context), void *context)
 {
     if (!isRunning)
     {
@@ -85,6 +579,12 @@ void WiFiAP::run()
         return;
     }
 
+    clients = new APClient[WIFI_AP_MAX_CLIENTS];
+    for (int i = 0; i < WIFI_AP_MAX_CLIENTS; i++)
+    {
+        clients[i].state = AP_CLIENT_FREE;
+    }
+
     WiFiServer server(80);
     server.begin();
 
@@ -93,68 +593,338 @@ void WiFiAP::run()
 #ifndef BOARD_BW16
         dnsServer.processNextRequest();
 #endif
-        if (uart->available())
+        if (pump != nullptr && pump(context))
         {
-            String cmd = uart->readSerialLine();
-            if (cmd.startsWith("[WIFI/AP/STOP]"))
-            {
-                uart->println(F("[INFO] Stopping AP mode."));
-                uart->flush();
-                break;
-            }
-            else if (cmd.startsWith("[WIFI/AP/UPDATE]"))
+            // Part-way through a WebSocket message, AP output would land in the middle of it
+            yield();
+            continue;
+        }
+        if (uart->available() && !handleCommand())
+        {
+            break;
+        }
+
+        acceptClient(server);
+
+        bool busy = false;
+        for (int i = 0; i < WIFI_AP_MAX_CLIENTS; i++)
+        {
+            if (clients[i].state != AP_CLIENT_FREE)
             {
-                String newHtml = uart->readStringUntilString("[WIFI/AP/UPDATE/END]");
-                newHtml.trim();
-                updateHTML(newHtml);
-                uart->println(F("[INFO] HTML updated."));
+                serviceClient(clients[i]);
+                busy = true;
             }
         }
 
-#if defined(BOARD_PICO_W) || defined(BOARD_PICO_2W) || defined(BOARD_VGM)
-        WiFiClient client = server.accept();
-#else
-        WiFiClient client = server.available();
+        // Only sleep when there is nothing to serve
+        if (busy)
+        {
+            yield();
+        }
+        else
+        {
+            delay(1);
+        }
+    }
+
+    for (int i = 0; i < WIFI_AP_MAX_CLIENTS; i++)
+    {
+        if (clients[i].state != AP_CLIENT_FREE)
+        {
+            closeClient(clients[i]);
+        }
+    }
+    delete[] clients;
+    clients = nullptr;
+
+    server.end();
+    wifi->disconnect();
+#ifndef BOARD_BW16
+    dnsServer.stop();
 #endif
-        if (client)
+    isRunning = false;
+}
+
+void WiFiAP::serviceClient(APClient &c)
+{
+    if (!c.client.connected() && !c.client.available())
+    {
+        closeClient(c);
+        return;
+    }
+
+    if (c.state == AP_CLIENT_READING)
+    {
+        // Read whatever is available without waiting for more
+        int available = c.client.available();
+        if (available > 0)
         {
-            uart->println(F("[INFO] Client Connected."));
-            String request = "";
-            unsigned long timeout = millis() + 5000;
-            while (client.connected() && millis() < timeout)
+            size_t space = sizeof(c.request) - 1 - c.requestLength;
+            size_t toRead = (size_t)available < space ? (size_t)available : space;
+            if (toRead > 0)
             {
-                if (request.indexOf("\r\n\r\n") > 0)
+                int n = c.client.read((uint8_t *)&c.request[c.requestLength], toRead);
+                if (n > 0)
                 {
-                    break;
+                    c.requestLength += n;
+                    c.request[c.requestLength] = '\0';
+                    c.lastActivity = millis();
                 }
+            }
+        }
 
-                // Read available data
-                while (client.available() && millis() < timeout)
-                {
-                    char c = client.read();
-                    request += c;
-                    timeout = millis() + 1000; // Reset timeout on data received
-                }
-                delay(1);
+        const char *headerEnd = strstr(c.request, "\r\n\r\n");
+        if (headerEnd != nullptr)
+        {
+            size_t contentLength = 0;
+            size_t valueLength = 0;
+            const char *value = findHeader(c.request, "Content-Length", &valueLength);
+            if (value != nullptr)
+            {
+                contentLength = strtoul(value, nullptr, 10);
+            }
+            c.requestEnd = (headerEnd - c.request) + 4 + contentLength;
+            if (c.requestEnd > sizeof(c.request) - 1)
+            {
+                // Body does not fit in the buffer
+                static const char tooLarge[] =
+                    "HTTP/1.1 413 Payload Too Large\r\n"
+                    "Content-Length: 0\r\n"
+                    "Connection: close\r\n"
+                    "\r\n";
+                c.client.write((const uint8_t *)tooLarge, sizeof(tooLarge) - 1);
+                closeClient(c);
+                return;
             }
-            printInputs(request);
-            client.println(html);
-            delay(10);
-            client.stop();
+            if (c.requestLength >= c.requestEnd)
+            {
+                handleRequest(c);
+                return;
+            }
+        }
+        if (c.requestLength >= sizeof(c.request) - 1)
+        {
+            // Header does not fit in the buffer
+            static const char tooLarge[] =
+                "HTTP/1.1 431 Request Header Fields Too Large\r\n"
+                "Content-Length: 0\r\n"
+                "Connection: close\r\n"
+                "\r\n";
+            c.client.write((const uint8_t *)tooLarge, sizeof(tooLarge) - 1);
+            closeClient(c);
+        }
+        else if (millis() - c.lastActivity > (c.served > 0 ? WIFI_AP_KEEPALIVE_TIMEOUT : WIFI_AP_HEADER_TIMEOUT))
+        {
+            closeClient(c);
         }
-        delay(10);
+        return;
     }
 
-    server.end();
-    wifi->disconnect();
+    // AP_CLIENT_SENDING: write at most one chunk so other clients get a turn
+    size_t total = c.headerLength + c.bodyLength;
+    size_t remaining = total - c.sent;
+    size_t chunk = remaining < WIFI_AP_CHUNK_SIZE ? remaining : WIFI_AP_CHUNK_SIZE;
+    size_t written = 0;
+    if (c.sent < c.headerLength)
+    {
+        size_t headerPart = c.headerLength - c.sent;
+        if (headerPart > chunk)
+        {
+            headerPart = chunk;
+        }
+        written = c.client.write((const uint8_t *)&c.header[c.sent], headerPart);
+    }
+    else if (c.body != nullptr)
+    {
+        written = c.client.write(c.body + (c.sent - c.headerLength), chunk);
+    }
 #ifndef BOARD_BW16
-    dnsServer.stop();
+    else if (c.file)
+    {
+        uint8_t buffer[WIFI_AP_CHUNK_SIZE];
+        size_t n = c.file.read(buffer, chunk);
+        written = n > 0 ? c.client.write(buffer, n) : 0;
+        if (written < n)
+        {
+            // Re-read the unsent part on the next pass
+            c.file.seek(c.file.position() - (n - written));
+        }
+    }
 #endif
-    isRunning = false;
+
+    if (written > 0)
+    {
+        c.sent += written;
+        c.lastActivity = millis();
+    }
+    else if (millis() - c.lastActivity > WIFI_AP_HEADER_TIMEOUT)
+    {
+        closeClient(c);
+        return;
+    }
+
+    if (c.sent >= total)
+    {
+#ifndef BOARD_BW16
+        if (c.file)
+        {
+            c.file.close();
+        }
+#endif
+        if (!c.keepAlive)
+        {
+            c.client.flush();
+            closeClient(c);
+            return;
+        }
+        // Keep any pipelined bytes that followed this request and wait for the next one
+        size_t consumed = c.requestEnd < c.requestLength ? c.requestEnd : c.requestLength;
+        c.requestLength -= consumed;
+        memmove(c.request, &c.request[consumed], c.requestLength);
+        c.request[c.requestLength] = '\0';
+        c.state = AP_CLIENT_READING;
+    }
+}
+
+#ifndef BOARD_BW16
+// Writes to a file without leading and trailing whitespace, like String::trim() on the whole page
+class TrimmedWriter : public Print
+{
+public:
+    TrimmedWriter(File &file) : file(file), started(false), pendingLength(0), pendingLineBreak(false) {}
+    size_t write(uint8_t c) override
+    {
+        if (isspace(c))
+        {
+            if (started)
+            {
+                // Only counted, and written once something other than whitespace follows
+                pendingLength++;
+                pendingLineBreak = pendingLineBreak || c == '\n';
+            }
+            return 1;
+        }
+        if (pendingLength > 0)
+        {
+            writePending();
+        }
+        started = true;
+        return file.write(c);
+    }
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            this->write(buffer[i]);
+        }
+        return size;
+    }
+
+private:
+    // Write the whitespace run as a line break (if it had one, which script needs) and spaces for the rest of its length
+    void writePending()
+    {
+        static const uint8_t spaces[16] = {' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' '};
+        if (pendingLineBreak)
+        {
+            file.write('\n');
+            pendingLength--;
+        }
+        while (pendingLength > 0)
+        {
+            size_t n = pendingLength < sizeof(spaces) ? pendingLength : sizeof(spaces);
+            file.write(spaces, n);
+            pendingLength -= n;
+        }
+        pendingLineBreak = false;
+    }
+    File &file;
+    bool started;          // A byte other than whitespace was written
+    size_t pendingLength;  // Whitespace bytes not yet written, dropped if the page ends here
+    bool pendingLineBreak; // The pending whitespace has a line break
+};
+#endif
+
+void WiFiAP::updateHTML()
+{
+#ifndef BOARD_BW16
+    char filename[WIFI_AP_PATH_SIZE];
+    assetPath("/index.html", filename, sizeof(filename));
+    File file = storage->openFile(filename, "w");
+    if (!file)
+    {
+        // Drain the content so it is not treated as commands
+        uart->readStringUntilString("[WIFI/AP/UPDATE/END]");
+        uart->println(F("[ERROR] Failed to open index page for writing."));
+        return;
+    }
+    TrimmedWriter writer(file);
+    uart->readUntilStringTo("[WIFI/AP/UPDATE/END]", writer);
+    file.close();
+
+    // A stale pre-compressed copy would otherwise take precedence
+    strcat(filename, ".gz");
+    if (storage->exists(filename))
+    {
+        storage->remove(filename);
+    }
+#else
+    html = uart->readStringUntilString("[WIFI/AP/UPDATE/END]");
+    html.trim(); // Remove any leading/trailing whitespace
+#endif
+    uart->println(F("[INFO] HTML updated."));
 }
 
-void WiFiAP::updateHTML(const String &htmlContent)
+#ifndef BOARD_BW16
+bool WiFiAP::uploadAsset(const String &jsonData)
 {
-    html = wifiAPHeader;
-    html += htmlContent;
+    JsonDocument doc;
+    if (deserializeJson(doc, jsonData) || !doc["path"] || !doc["size"].is<size_t>())
+    {
+        uart->println(F("[ERROR] JSON does not contain path and size."));
+        return false;
+    }
+    char filename[WIFI_AP_PATH_SIZE];
+    size_t remaining = doc["size"].as<size_t>();
+    bool valid = assetPath(doc["path"].as<const char *>(), filename, sizeof(filename));
+    File file;
+    if (valid)
+    {
+        file = storage->openFile(filename, "w");
+    }
+
+    // Always consume the announced bytes so they are not treated as commands
+    uint8_t buffer[256];
+    bool ok = valid && file;
+    while (remaining > 0)
+    {
+        size_t n = uart->readBytes(buffer, remaining < sizeof(buffer) ? remaining : sizeof(buffer));
+        if (n == 0)
+        {
+            ok = false; // timed out
+            break;
+        }
+        if (ok && file.write(buffer, n) != n)
+        {
+            ok = false;
+        }
+        remaining -= n;
+    }
+    if (file)
+    {
+        file.close();
+    }
+
+    if (!ok)
+    {
+        if (valid)
+        {
+            storage->remove(filename);
+        }
+        uart->println(valid ? F("[ERROR] Failed to save asset.") : F("[ERROR] Invalid asset path."));
+        return false;
+    }
+    uart->println(F("[INFO] Asset saved."));
+    return true;
 }
+#endif
@@ -6,23 +6,77 @@
 #endif
 #include "wifi_utils.h"
 #include "uart.h"
+#include "storage.h"
+
+#define WIFI_AP_MAX_CLIENTS 8          // Maximum number of simultaneous client connections
+#define WIFI_AP_REQUEST_BUFFER 1024    // Per-client buffer for the request line and headers
+#define WIFI_AP_RESPONSE_HEADER 256    // Per-client buffer for the response header
+#define WIFI_AP_CHUNK_SIZE 512         // Maximum bytes written to a single client per pass
+#define WIFI_AP_HEADER_TIMEOUT 3000    // Time (ms) allowed to receive a full request header
+#define WIFI_AP_KEEPALIVE_TIMEOUT 5000 // Time (ms) an idle keep-alive connection is kept open
+#define WIFI_AP_KEEPALIVE_MAX 100      // Maximum requests served on one keep-alive connection
+#define WIFI_AP_ASSET_DIR "/ap"        // Directory in flash that holds the AP mode assets
+#define WIFI_AP_PATH_SIZE 64           // Maximum length of an asset path (including WIFI_AP_ASSET_DIR)
+
+typedef enum
+{
+    AP_CLIENT_FREE,    // Slot is unused
+    AP_CLIENT_READING, // Receiving the request header
+    AP_CLIENT_SENDING, // Sending the response
+} APClientState;
+
+typedef struct
+{
+    WiFiClient client;                    // Connection to the client
+    APClientState state;                  // Current state of the connection
+    char request[WIFI_AP_REQUEST_BUFFER]; // Request header received so far
+    size_t requestLength;                 // Number of bytes in request
+    size_t requestEnd;                    // Length of the complete request (header + body) being answered
+    char ip[16];                          // Client IP address
+    char header[WIFI_AP_RESPONSE_HEADER]; // Response header to send
+    size_t headerLength;                  // Number of bytes in header
+    size_t sent;                          // Number of response bytes (header + body) sent
+    const uint8_t *body;                  // Response body when served from memory
+    size_t bodyLength;                    // Number of bytes in the response body
+#ifndef BOARD_BW16
+    File file; // Response body when served from flash
+#endif
+    bool keepAlive;             // Keep the connection open after the response
+    uint8_t served;             // Number of requests served on this connection
+    unsigned long lastActivity; // Time (ms) of the last read or write
+} APClient;
 
 class WiFiAP
 {
 public:
-    WiFiAP(UART *uartClass, WiFiUtils *wifiUtils);
+    WiFiAP(UART *uartClass, WiFiUtils *wifiUtils, StorageManager *storageManager);
     bool start(const char *ssid);
-    void run();
+    void run(bool (*pump)(void *context) = nullptr, void *context = nullptr); // Serve until [WIFI/AP/STOP], pump moves other work each pass and returns true while it holds the UART
 
 private:
-    void printInputs(const String &request);    // Print inputs from the request
-    void updateHTML(const String &htmlContent); // Update the HTML content to be served
-    UART *uart;                                 // UART object for serial communication
-    WiFiUtils *wifi;                            // WiFiUtils object for WiFi operations
-    bool isRunning;                             // Flag to indicate if the AP mode is running
-    String html;                                // HTML content to be served
+    void acceptClient(WiFiServer &server);   // Accept a new client into a free slot
+    void closeClient(APClient &c);           // Close a client connection and free its slot
+    void closeSending();                     // Close connections that are part-way through a response
+    bool handleCommand();                    // Handle UART commands, returns false when AP mode should stop
+    void handleRequest(APClient &c);         // Parse a complete request header and prepare the response
+    void printInputs(const APClient &c, const char *method, size_t methodLength, const char *path, size_t pathLength, const char *data, size_t dataLength); // Print a submission record over UART
+    void serviceClient(APClient &c);         // Advance the state of a client connection
+    void updateHTML();                       // Stream a new index page from UART into storage
+#ifndef BOARD_BW16
+    bool deleteAsset(const String &jsonData); // Delete an asset from storage
+    bool uploadAsset(const String &jsonData); // Stream an asset of a known size from UART into storage
+    bool openAsset(APClient &c, const char *path, bool acceptsGzip, const char **contentType, bool *gzipped); // Open the asset for path, falling back to the index page
+#endif
+    UART *uart;              // UART object for serial communication
+    WiFiUtils *wifi;         // WiFiUtils object for WiFi operations
+    StorageManager *storage; // StorageManager object for asset storage
+    bool isRunning;          // Flag to indicate if the AP mode is running
+    APClient *clients;       // Client connection slots (allocated while running)
+#ifdef BOARD_BW16
+    String html; // HTML content to be served (no file system on BW16)
+#endif
 #ifndef BOARD_BW16
     DNSServer dnsServer; // DNS server to redirect all domains to AP IP
     IPAddress apIP;      // AP mode IP address
 #endif
-};
\ No newline at end of file
+};
@@ -1,4 +1,5 @@
 #include "wifi_utils.h"
+#include "stats.h"
 
 #ifndef BOARD_BW16
 WiFiScanResult wifiScanResults[WIFI_MAX_SCAN];
@@ -107,9 +108,14 @@ bool WiFiUtils::connectHelper(const char *ssid, const char *password, bool isAP)
 
 bool WiFiUtils::connect(const char *ssid, const char *password)
 {
+    if (this->hasConnected)
+    {
+        stats.addReconnect();
+    }
     if (this->connectHelper(ssid, password))
     // Set the time zone to UTC+0
     {
+        this->hasConnected = true;
 #ifndef BOARD_BW16
         configTime(0, 0, "pool.ntp.org", "time.nist.gov");
 #endif
@@ -57,4 +57,5 @@ public:
     String scan();                                        // Scan for available WiFi networks
 private:
     bool connectHelper(const char *ssid, const char *password, bool isAP = false); // Helper function to connect to WiFi
+    bool hasConnected = false;                                                     // A station connection has succeeded before (later ones count as reconnects)
 };
\ No newline at end of file